@@ -261,27 +261,114 @@ EXPORT unsigned long preupdate(MODULE *module, TIMESTAMP t0, unsigned int64 dt)
 	}
 }
 
-//interupdate function of deltamode
-//Module-level call for each timestep of deltamode
-//Ideally, all deltamode objects coordinate through their module call, not their individual "update" call
-//Returns SIMULATIONMODE - SM_DELTA, SM_DELTA_ITER, SM_EVENT, or SM_ERROR
-EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 delta_time, unsigned long dt, unsigned int iteration_count_val)
+//Per-pass data for the interupdate slices
+typedef struct s_gen_delta_pass {
+	unsigned int64 delta_time;
+	unsigned long dt;
+	unsigned int iteration_count_val;
+	unsigned int lock;		//Protects the merged results below
+	bool event_driven;
+	bool delta_iter;
+	int error_index;		//First object in the list that returned an error, -1 if none did
+} GEN_DELTA_PASS;
+
+#define GEN_DELTA_MINITEMS 1	//Inverter/diesel updates are costly, so even a single parent group is worth a slice
+
+//Deltamode objects grouped by the top of their parent chain, so objects that post into the same parent are updated together
+static int *delta_group_order = NULL;			//Deltamode list indices, grouped and in list order within each group
+static unsigned int *delta_group_start = NULL;	//Start of each group in delta_group_order, delta_group_count+1 entries
+static unsigned int delta_group_count = 0;
+
+//Sort key for building the groups
+typedef struct s_gen_delta_root {
+	OBJECT *root;
+	int index;
+} GEN_DELTA_ROOT;
+
+static int delta_root_compare(const void *a, const void *b)
+{
+	const GEN_DELTA_ROOT *ra = (const GEN_DELTA_ROOT *)a;
+	const GEN_DELTA_ROOT *rb = (const GEN_DELTA_ROOT *)b;
+
+	if (ra->root != rb->root)
+		return (ra->root < rb->root) ? -1 : 1;
+	else	//Same group - keep the list order
+		return ra->index - rb->index;
+}
+
+//Builds the parent groups of the deltamode list
+//Inverters and diesel_dg add their injections straight into their parent's accumulators (e.g., pLine_unrotI),
+//so two objects under the same parent (or parent chain) must never be updated concurrently
+static void build_delta_groups(void)
 {
+	GEN_DELTA_ROOT *roots;
+	OBJECT *root;
+	int curr_object_number;
+
+	roots = (GEN_DELTA_ROOT *)gl_malloc(gen_object_count*sizeof(GEN_DELTA_ROOT));
+	delta_group_order = (int *)gl_malloc(gen_object_count*sizeof(int));
+	delta_group_start = (unsigned int *)gl_malloc((gen_object_count+1)*sizeof(unsigned int));
+
+	//Make sure it worked
+	if ((roots == NULL) || (delta_group_order == NULL) || (delta_group_start == NULL))
+	{
+		GL_THROW("Failed to allocate deltamode object groups for generators module!");
+		/*  TROUBLESHOOT
+		While attempting to group the generator module deltamode-enabled objects by parent, an error
+		was encountered.  Please try again.  If the error persists, please submit your code and a bug
+		report via the trac website.
+		*/
+	}
+
+	//Find the top of each object's parent chain
+	for (curr_object_number=0; curr_object_number<gen_object_count; curr_object_number++)
+	{
+		for (root=delta_objects[curr_object_number]; root->parent!=NULL; root=root->parent);
+
+		roots[curr_object_number].root = root;
+		roots[curr_object_number].index = curr_object_number;
+	}
+
+	qsort(roots,gen_object_count,sizeof(GEN_DELTA_ROOT),delta_root_compare);
+
+	//Mark where each group starts
+	delta_group_count = 0;
+	for (curr_object_number=0; curr_object_number<gen_object_count; curr_object_number++)
+	{
+		if ((curr_object_number == 0) || (roots[curr_object_number].root != roots[curr_object_number-1].root))
+			delta_group_start[delta_group_count++] = curr_object_number;
+
+		delta_group_order[curr_object_number] = roots[curr_object_number].index;
+	}
+	delta_group_start[delta_group_count] = gen_object_count;
+
+	gl_free(roots);
+}
+
+//Updates the deltamode object groups first to last-1 and merges the slice's SIMULATIONMODE into the pass
+//Objects sharing a parent are in the same group and run in list order, so slices never write the same parent
+static TIMESTAMP interupdate_slice(void *arg, unsigned int first, unsigned int last)
+{
+	GEN_DELTA_PASS *pass = (GEN_DELTA_PASS *)arg;
+	unsigned int curr_group, curr_item;
 	int curr_object_number;
 	SIMULATIONMODE function_status = SM_EVENT;
 	bool event_driven = true;
 	bool delta_iter = false;
-	
-	if (enable_subsecond_models == true)
+	int error_index = -1;
+
+	//Loop through the groups and call the updates
+	for (curr_group=first; (curr_group<last) && (error_index < 0); curr_group++)
 	{
-		//Loop through the object list and call the updates
-		for (curr_object_number=0; curr_object_number<gen_object_count; curr_object_number++)
+		for (curr_item=delta_group_start[curr_group]; curr_item<delta_group_start[curr_group+1]; curr_item++)
 		{
+			curr_object_number = delta_group_order[curr_item];
+
 			//See if we're in service or not
 			if ((delta_objects[curr_object_number]->in_svc_double <= gl_globaldeltaclock) && (delta_objects[curr_object_number]->out_svc_double >= gl_globaldeltaclock))
 			{
 				//Call the actual function
-				function_status = ((SIMULATIONMODE (*)(OBJECT *, unsigned int64, unsigned long, unsigned int))(*delta_functions[curr_object_number]))(delta_objects[curr_object_number],delta_time,dt,iteration_count_val);
+				function_status = ((SIMULATIONMODE (*)(OBJECT *, unsigned int64, unsigned long, unsigned int))(*delta_functions[curr_object_number]))(delta_objects[curr_object_number],pass->delta_time,pass->dt,pass->iteration_count_val);
 			}
 			else //Not in service - off to event mode
 				function_status = SM_EVENT;
@@ -296,20 +383,66 @@ EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 d
 			}
 			else if (function_status == SM_ERROR)
 			{
-				gl_error("Generator object:%s - deltamode function returned an error!",delta_objects[curr_object_number]->name);
-				/*  TROUBLESHOOT
-				While performing a deltamode update, one object returned an error code.  Check to see if the object itself provided
-				more details and try again.  If the error persists, please submit your code and a bug report via the trac website.
-				*/
-				return SM_ERROR;
+				error_index = curr_object_number;
+				break;
 			}
 			//Default else, we're in SM_EVENT, so no flag change needed
 		}
+	}
+
+	//Merge our results into the pass
+	WRITELOCK(&pass->lock);
+	if (event_driven == false)
+		pass->event_driven = false;
+	if (delta_iter == true)
+		pass->delta_iter = true;
+	if ((error_index >= 0) && ((pass->error_index < 0) || (error_index < pass->error_index)))
+		pass->error_index = error_index;
+	WRITEUNLOCK(&pass->lock);
+
+	return TS_NEVER;
+}
+
+//interupdate function of deltamode
+//Module-level call for each timestep of deltamode
+//Ideally, all deltamode objects coordinate through their module call, not their individual "update" call
+//Returns SIMULATIONMODE - SM_DELTA, SM_DELTA_ITER, SM_EVENT, or SM_ERROR
+EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 delta_time, unsigned long dt, unsigned int iteration_count_val)
+{
+	GEN_DELTA_PASS pass;
+	
+	if (enable_subsecond_models == true)
+	{
+		//Set up the pass
+		pass.delta_time = delta_time;
+		pass.dt = dt;
+		pass.iteration_count_val = iteration_count_val;
+		pass.lock = 0;
+		pass.event_driven = true;
+		pass.delta_iter = false;
+		pass.error_index = -1;
+
+		//Group the objects by parent the first time through
+		if ((delta_group_start == NULL) && (gen_object_count > 0))
+			build_delta_groups();
+
+		//Update the object groups on the worker pool
+		gl_threadpool_run(interupdate_slice,&pass,delta_group_count,GEN_DELTA_MINITEMS);
+
+		if (pass.error_index >= 0)
+		{
+			gl_error("Generator object:%s - deltamode function returned an error!",delta_objects[pass.error_index]->name);
+			/*  TROUBLESHOOT
+			While performing a deltamode update, one object returned an error code.  Check to see if the object itself provided
+			more details and try again.  If the error persists, please submit your code and a bug report via the trac website.
+			*/
+			return SM_ERROR;
+		}
 				
 		//Determine how to exit - event or delta driven
-		if (event_driven == false)
+		if (pass.event_driven == false)
 		{
-			if (delta_iter == true)
+			if (pass.delta_iter == true)
 				return SM_DELTA_ITER;
 			else
 				return SM_DELTA;
@@ -111,6 +111,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/test_framework.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/test.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/threadpool.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/threadpool.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/timeheap.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/timeheap.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/timestamp.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/timestamp.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/transform.c
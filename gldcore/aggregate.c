@@ -29,11 +29,14 @@
  **/
 
 #include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "platform.h"
 #include "aggregate.h"
 #include "output.h"
 #include "find.h"
+#include "module.h"
 
 SET_MYCONTEXT(DMC_AGGREGATE)
 
@@ -315,6 +318,15 @@ AGGREGATION *aggregate_mkgroup(char *aggregator, /**< aggregator (min,max,avg,st
 			result->flags = flags;
 			result->punit = to_unit;
 			result->scale = scale;
+			result->member = NULL;
+			result->n_members = 0;
+			result->indexed = 0;
+
+			/* conversion done by unit_convert_ex() for each double value */
+			result->convert = (pinfo->unit!=NULL && to_unit!=NULL);
+			result->from_offset = result->convert ? pinfo->unit->b : 0.0;
+			result->factor = result->convert ? pinfo->unit->a / to_unit->a : 1.0;
+			result->to_offset = result->convert ? to_unit->b : 0.0;
 		}
 		else
 		{
@@ -340,63 +352,116 @@ double arg(complex *x)
 	return (x->r==0) ? (x->i>0 ? PI/2 : (x->i==0 ? 0 : -PI/2)) : ((x->i>0) ? (x->r>0 ? atan(x->i/x->r) : PI-atan(x->i/x->r)) : (x->r>0 ? -atan(x->i/x->r) : PI+atan(x->i/x->r)));
 }
 
+/* index the objects of the last result whose property can be read, so
+   aggregate_value() does not have to check the property of every object
+   on every call */
+static int aggregate_index(AGGREGATION *aggr)
+{
+	OBJECT *obj;
+	unsigned int n = 0;
+	AGGRMEMBER *member;
+	int is_complex = (aggr->pinfo->ptype==PT_complex || aggr->pinfo->ptype==PT_enduse);
+
+	for(obj = find_first(aggr->last); obj != NULL; obj = find_next(aggr->last, obj))
+		n++;
+	member = (AGGRMEMBER*)realloc(aggr->member,sizeof(AGGRMEMBER)*(n>0?n:1));
+	if (member==NULL)
+		return 0;
+	aggr->member = member;
+
+	n = 0;
+	for(obj = find_first(aggr->last); obj != NULL; obj = find_next(aggr->last, obj))
+	{
+		void *addr = NULL;
+		switch (aggr->pinfo->ptype) {
+		case PT_complex:
+		case PT_enduse:
+			addr = object_get_complex(obj,aggr->pinfo);
+			break;
+		case PT_double:
+		case PT_loadshape:
+		case PT_random:
+			addr = object_get_double(obj,aggr->pinfo);
+			break;
+		default:
+			break;
+		}
+		if (addr!=NULL && (!is_complex || aggr->part==AP_REAL || aggr->part==AP_IMAG || aggr->part==AP_MAG || aggr->part==AP_ARG || aggr->part==AP_ANG))
+		{
+			member[n].obj = obj;
+			member[n].addr = addr;
+			n++;
+		}
+	}
+	aggr->n_members = n;
+	aggr->indexed = 1;
+	IN_MYCONTEXT output_debug("aggregate of property '%s' has %d members", aggr->pinfo->name, n);
+	return 1;
+}
+
 /** This function performs an aggregate calculation given by the aggregation 
  **/
 double aggregate_value(AGGREGATION *aggr) /**< the aggregation to perform */
 {
-	OBJECT *obj;
+	unsigned int n;
 	double numerator=0, denominator=0, secondary=0, third=0, fourth=0;
 	double scale = (aggr->punit ? aggr->scale : 1.0);
+	int is_complex = (aggr->pinfo->ptype==PT_complex || aggr->pinfo->ptype==PT_enduse);
 
 	/* non-constant groups need search program rerun */
 	if ((aggr->group->constflags & CF_CONSTANT) != CF_CONSTANT){
-		aggr->last = find_runpgm(NULL,aggr->group); /** @todo use constant part instead of NULL (ticket #3) */
+		FINDLIST *list = find_runpgm(NULL,aggr->group); /** @todo use constant part instead of NULL (ticket #3) */
+		if (list!=NULL)
+		{
+			/* the members only need to be indexed again when the result changes */
+			if (aggr->last==NULL || list->result_size!=aggr->last->result_size || memcmp(list->result,aggr->last->result,list->result_size)!=0)
+			{
+				if (aggr->last!=NULL)
+					module_free(aggr->last);
+				aggr->last = list;
+				aggr->indexed = 0;
+			}
+			else
+				module_free(list);
+		}
+	}
+	if (!aggr->indexed && !aggregate_index(aggr))
+	{
+		throw_exception("aggregate_value(): unable to index the members of the aggregation of property '%s'", aggr->pinfo->name);
+		/* TROUBLESHOOT
+			The memory needed to index the members of an aggregation could not be allocated.
+			Try freeing up memory by making more heap available or making the model smaller.
+		 */
 	}
 
-	for(obj = find_first(aggr->last); obj != NULL; obj = find_next(aggr->last, obj)){
+	for (n=0; n<aggr->n_members; n++){
+		OBJECT *obj = aggr->member[n].obj;
 		double value=0;
-		double *pdouble = NULL;
-		complex *pcomplex = NULL;
 
 		/* add time-sensitivity to verify that we are only aggregating objects that are in-service and not out-service. */
 		if(obj->in_svc >= global_clock || obj->out_svc <= global_clock)
 			continue;
 
-		switch (aggr->pinfo->ptype) {
-		case PT_complex:
-		case PT_enduse:
-			pcomplex = object_get_complex(obj,aggr->pinfo);
-			if (pcomplex!=NULL)
-			{
-				switch (aggr->part) {
-				case AP_REAL: value=pcomplex->r; break;
-				case AP_IMAG: value=pcomplex->i; break;
-				case AP_MAG: value=mag(pcomplex); break;
-				case AP_ARG: value=arg(pcomplex); break;
-				case AP_ANG: value=arg(pcomplex)*180/PI;  break;
-				default: pcomplex = NULL; break; /* invalidate the result */
-				}
-			}
-			break;
-		case PT_double:
-		case PT_loadshape:
-		case PT_random:
-			pdouble = object_get_double(obj,aggr->pinfo);
-			if (pdouble!=NULL){
-				value = *pdouble;
-				if(aggr->pinfo->unit != 0 && aggr->punit != 0){
-					int rv = unit_convert_ex(aggr->pinfo->unit, aggr->punit, &value);
-					if(rv == 0){ // error
-						;
-					}
-				} // else don't worry
+		if (is_complex)
+		{
+			complex *pcomplex = (complex*)aggr->member[n].addr;
+			switch (aggr->part) {
+			case AP_REAL: value=pcomplex->r; break;
+			case AP_IMAG: value=pcomplex->i; break;
+			case AP_MAG: value=mag(pcomplex); break;
+			case AP_ARG: value=arg(pcomplex); break;
+			case AP_ANG: value=arg(pcomplex)*180/PI;  break;
+			default: break; /* not indexed */
 			}
-			break;
-		default:
-			break;
+		}
+		else
+		{
+			value = *(double*)aggr->member[n].addr;
+			if (aggr->convert)
+				value = (value - aggr->from_offset) * aggr->factor + aggr->to_offset;
 		}
 
-		if (pdouble!=NULL || pcomplex!=NULL) /* valid value */
+		/* valid value */
 		{
 			if ((aggr->flags&AF_ABS)==AF_ABS) value=fabs(value);
 			switch (aggr->op) {
@@ -16,6 +16,11 @@ typedef enum {AP_NONE, AP_REAL, AP_IMAG, AP_MAG, AP_ANG, AP_ARG} AGGRPART; /**<
 
 #define AF_ABS 0x01 /**< absolute value aggregation flag */
 
+typedef struct s_aggrmember {
+	struct s_object_list *obj; /**< the member object */
+	void *addr; /**< the address of the aggregated property in the object */
+} AGGRMEMBER; /**< a member of an aggregation */
+
 typedef struct s_aggregate {
 	AGGREGATOR op; /**< the aggregation operator (min, max, etc.) */
 	struct s_findpgm *group; /**< the find program used to build the aggregation */
@@ -26,6 +31,11 @@ typedef struct s_aggregate {
 	unsigned char flags; /**< aggregation flags (e.g., AF_ABS) */
 	struct s_findlist *last; /**< the result of the last run */
 	struct s_aggregate *next; /**< the next aggregation in the core's list of aggregators */
+	AGGRMEMBER *member; /**< the members of the last result whose property can be read */
+	unsigned int n_members; /**< the number of members */
+	unsigned char indexed; /**< flag indicating the members are up to date with the last result */
+	unsigned char convert; /**< flag indicating values must be converted to \p punit */
+	double from_offset, factor, to_offset; /**< the unit conversion (see unit_convert_ex()) */
 } AGGREGATION; /**< the aggregation type */
 
 #ifdef __cplusplus
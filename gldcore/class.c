@@ -17,6 +17,7 @@
 #include "enduse.h"
 #include "stream.h"
 #include "random.h"
+#include "lock.h"
 
 SET_MYCONTEXT(DMC_CLASS)
 
@@ -146,6 +147,167 @@ int property_create(PROPERTY *prop, void *addr)
 }
 #endif
 
+/* Property names are looked up in a hash index kept by each class.  The
+	index holds the class's own properties and those it inherits, with the
+	same precedence as a search of the class and then its parents, so a
+	lookup is a single probe sequence.  The index remembers the classes it
+	was built from and their pmap_version, and is rebuilt when any of them
+	has changed.  Properties added to the class itself are inserted into
+	its index directly, so defining a class does not rebuild the index for
+	every property.  Replaced indexes are not freed because other threads
+	may still be reading them. */
+#define PINDEX_MAXDEPTH 32 /* deepest inheritance chain that is indexed */
+
+typedef struct s_propertyindex {
+	unsigned int size; /* number of slots, always a power of 2 */
+	unsigned int count; /* number of properties indexed */
+	unsigned int depth; /* number of classes indexed */
+	CLASS *chain[PINDEX_MAXDEPTH]; /* class and its parents */
+	unsigned int version[PINDEX_MAXDEPTH]; /* pmap_version of each class when indexed */
+	int complete; /* own properties can be inserted when they are added */
+	PROPERTY **slot;
+} PROPERTYINDEX;
+
+static unsigned int pindex_lock = 0;
+
+static unsigned int pindex_hash(const char *name)
+{
+	unsigned int h = 2166136261u; /* FNV-1a */
+	while ( *name!='\0' )
+	{
+		h ^= (unsigned char)*name++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/* check that the index still matches the class and its parents */
+static int pindex_isvalid(PROPERTYINDEX *index, CLASS *oclass)
+{
+	unsigned int n;
+	for ( n=0 ; oclass!=NULL ; n++, oclass=oclass->parent )
+	{
+		if ( n>=index->depth || index->chain[n]!=oclass || index->version[n]!=oclass->pmap_version )
+			return 0;
+	}
+	return n==index->depth;
+}
+
+/* find the slot for a name, either the one holding it or the empty one where it belongs */
+static PROPERTY **pindex_slot(PROPERTYINDEX *index, const char *name)
+{
+	unsigned int mask = index->size-1, h;
+	for ( h=pindex_hash(name)&mask ; index->slot[h]!=NULL ; h=(h+1)&mask )
+	{
+		if ( strcmp(index->slot[h]->name,name)==0 )
+			break;
+	}
+	return &index->slot[h];
+}
+
+/* build the index of a class
+   @return the index, or NULL if it cannot be built (e.g., inheritance loop or no memory)
+ */
+static PROPERTYINDEX *pindex_build(CLASS *oclass)
+{
+	PROPERTYINDEX *index;
+	CLASS *pclass;
+	PROPERTY *prop;
+	unsigned int n, m, count = 0, size = 16;
+
+	index = (PROPERTYINDEX*)malloc(sizeof(PROPERTYINDEX));
+	if ( index==NULL )
+		return NULL;
+	index->depth = 0;
+	index->complete = 1;
+	for ( pclass=oclass ; pclass!=NULL ; pclass=pclass->parent )
+	{
+		for ( m=0 ; m<index->depth && index->chain[m]!=pclass ; m++ ) {}
+		if ( m<index->depth || index->depth==PINDEX_MAXDEPTH )
+		{
+			/* inheritance loop or too deep, let the search report it */
+			free(index);
+			return NULL;
+		}
+		index->chain[index->depth] = pclass;
+		index->version[index->depth++] = pclass->pmap_version;
+		for ( prop=pclass->pmap ; prop!=NULL && prop->oclass==pclass ; prop=prop->next )
+			count++;
+		if ( pclass==oclass && prop!=NULL )
+			index->complete = 0; /* properties added after this one cannot be found */
+	}
+	while ( size<2*count )
+		size *= 2;
+	index->slot = (PROPERTY**)calloc(size,sizeof(PROPERTY*));
+	if ( index->slot==NULL )
+	{
+		free(index);
+		return NULL;
+	}
+	index->size = size;
+	index->count = 0;
+
+	/* the first definition of a name found by the search takes precedence */
+	for ( n=0 ; n<index->depth ; n++ )
+	{
+		pclass = index->chain[n];
+		for ( prop=pclass->pmap ; prop!=NULL && prop->oclass==pclass ; prop=prop->next )
+		{
+			PROPERTY **slot = pindex_slot(index,prop->name);
+			if ( *slot==NULL )
+			{
+				*slot = prop;
+				index->count++;
+			}
+		}
+	}
+	return index;
+}
+
+/* get the current index of a class, building it if needed
+   @return the index, or NULL if the class must be searched instead
+ */
+static PROPERTYINDEX *pindex_get(CLASS *oclass)
+{
+	PROPERTYINDEX *index = oclass->pindex;
+	if ( index!=NULL && pindex_isvalid(index,oclass) )
+		return index;
+	wlock(&pindex_lock);
+	index = oclass->pindex;
+	if ( index==NULL || !pindex_isvalid(index,oclass) )
+	{
+		index = pindex_build(oclass);
+		if ( index!=NULL )
+			oclass->pindex = index;
+	}
+	wunlock(&pindex_lock);
+	return index;
+}
+
+/* note a property added to a class, and add it to the class's index if the index was current */
+static void pindex_add(CLASS *oclass, PROPERTY *prop)
+{
+	PROPERTYINDEX *index;
+	int current;
+	wlock(&pindex_lock);
+	index = oclass->pindex;
+	current = ( index!=NULL && pindex_isvalid(index,oclass) );
+	oclass->pmap_version++;
+	if ( current && index->complete && prop->oclass==oclass && 2*(index->count+1)<=index->size )
+	{
+		PROPERTY **slot = pindex_slot(index,prop->name);
+		if ( *slot==NULL )
+		{
+			*slot = prop;
+			index->count++;
+		}
+		else if ( (*slot)->oclass!=oclass )
+			*slot = prop; /* own properties hide inherited ones */
+		index->version[0] = oclass->pmap_version;
+	}
+	wunlock(&pindex_lock);
+}
+
 /* though improbable, this is to prevent more complicated, specifically crafted
 	inheritence loops.  these should be impossible if a class_register call is
 	immediately followed by a class_define_map call. -d3p988 */
@@ -190,11 +352,29 @@ PROPERTY *class_find_property(CLASS *oclass,     /**< the object class */
                               PROPERTYNAME name) /**< the property name */
 {
 	PROPERTY *prop = find_header_property(oclass,name);
+	PROPERTYINDEX *index;
 	if ( prop ) return prop;
 
 	if(oclass == NULL)
 		return NULL;
 
+	index = pindex_get(oclass);
+	if ( index!=NULL )
+	{
+		prop = *pindex_slot(index,name);
+		if ( prop!=NULL && prop->oclass==oclass && prop->flags&PF_DEPRECATED && !(prop->flags&PF_DEPRECATED_NONOTICE) && !global_suppress_deprecated_messages)
+		{
+			output_warning("class_find_property(CLASS *oclass='%s', PROPERTYNAME name='%s': property is deprecated", oclass->name, name);
+			/* TROUBLESHOOT
+				You have done a search on a property that has been flagged as deprecated and will most likely not be supported soon.
+				Correct the usage of this property to get rid of this message.
+			 */
+			if (global_suppress_repeat_messages)
+				prop->flags |= ~PF_DEPRECATED_NONOTICE;
+		}
+		return prop;
+	}
+
 	for (prop=oclass->pmap; prop!=NULL && prop->oclass==oclass; prop=prop->next)
 	{
 		if (strcmp(name,prop->name)==0)
@@ -239,6 +419,7 @@ void class_add_property(CLASS *oclass,  /**< the class to which the property is
 		oclass->pmap = prop;
 	else
 		last->next = prop;
+	pindex_add(oclass,prop);
 }
 
 /** Add an extended property to a class 
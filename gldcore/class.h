@@ -120,6 +120,10 @@ struct s_class_list {
 	bool has_runtime;	///< flag indicating that a runtime dll, so, or dylib is in use
 	char runtime[1024]; ///< name of file containing runtime dll, so, or dylib
 	struct s_class_list *next;
+	struct s_objectslab *slab;	/**< memory from which the objects of this class are allocated (see object.c) */
+	struct s_propertyindex *pindex;	/**< hash index of the class's own and inherited property names (see class.c) */
+	unsigned int pmap_version;	/**< incremented each time a property is added to the class */
+	FUNCTIONADDR sync_batch;	/**< optional sync of many objects of this class in one call */
 }; /* CLASS */
 
 #ifdef __cplusplus
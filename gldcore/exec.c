@@ -272,19 +272,24 @@ int64 wlock_count = 0, wlock_spin = 0;
 extern pthread_mutex_t mls_inst_lock;
 extern pthread_cond_t mls_inst_signal;
 
-//sjin: struct for pthread_create arguments
-struct arg_data {
-	int thread;
-	void *item;
-	int incr;
-};
-struct arg_data arg_data_array[2];
-
 INDEX **exec_getranks(void)
 {
 	return ranks;
 }
 
+/* orders objects in a rank by class so the same sync function is called back to back */
+static int compare_rank_class(const void *a, const void *b)
+{
+	OBJECT *obj1 = *(OBJECT**)a, *obj2 = *(OBJECT**)b;
+	int cmp;
+	if ( obj1->oclass==obj2->oclass )
+		return 0;
+	cmp = strcmp(obj1->oclass->name,obj2->oclass->name);
+	if ( cmp!=0 )
+		return cmp;
+	return obj1->oclass<obj2->oclass ? -1 : 1;
+}
+
 static STATUS setup_ranks(void)
 {
 	OBJECT *obj;
@@ -322,6 +327,10 @@ static STATUS setup_ranks(void)
 
 			/* shuffle the objects in the index */
 			index_shuffle(ranks[i]);
+
+		/* store the objects of each rank contiguously for the sync passes */
+		if (index_compact(ranks[i],global_sortranks?compare_rank_class:NULL)==FAILED)
+			return FAILED;
 	}
 
 	return SUCCESS;
@@ -433,10 +442,11 @@ void do_checkpoint(void)
 }
 
 /***********************************************************************/
+static void ss_do_object_sync_update(int thread, OBJECT *obj, TIMESTAMP this_t);
+
 //sjin: implement new ss_do_object_sync for pthreads
 static void ss_do_object_sync(int thread, void *item)
 {
-	struct sync_data *data = &thread_data->data[thread];
 	OBJECT *obj = (OBJECT *) item;
 	TIMESTAMP this_t;
 	char b[64];
@@ -510,6 +520,14 @@ static void ss_do_object_sync(int thread, void *item)
 	else 
 		this_t = TS_NEVER; /* already out of service */
 
+	ss_do_object_sync_update(thread,obj,this_t);
+}
+
+/* update the thread's sync data with the next event time of an object */
+static void ss_do_object_sync_update(int thread, OBJECT *obj, TIMESTAMP this_t)
+{
+	struct sync_data *data = &thread_data->data[thread];
+
 	/* check for "soft" event (events that are ignored when stopping) */
 	if (this_t < -1)
 		this_t = -this_t;
@@ -557,25 +575,53 @@ static void ss_do_object_sync(int thread, void *item)
 	}
 }
 
-//sjin: implement new ss_do_object_sync_list for pthreads
-static void *ss_do_object_sync_list(void *threadarg)
+/* sync a list of objects, passing runs of in-service objects of the same
+   class to object_sync_batch() when the class exports a batched sync */
+static void ss_do_object_sync_batch(int thread, OBJECT **obj, unsigned int n)
 {
-	LISTITEM *ptr;
-	int iPtr;
+	OBJECT *batch[OBJECT_SYNC_BATCHSIZE];
+	TIMESTAMP t2[OBJECT_SYNC_BATCHSIZE];
+	unsigned int i = 0;
+#ifdef _DEBUG
+	bool can_batch = (global_sync_dumpfile[0]=='\0'); /* the sync dumpfile is only written by single object syncs */
+#else
+	bool can_batch = true;
+#endif
+	while ( i<n )
+	{
+		CLASS *oclass = obj[i]->oclass;
+		unsigned int k, n_batch = 0;
 
-	struct arg_data *mydata = (struct arg_data *) threadarg;
-	int thread = mydata->thread;
-	void *item = mydata->item;
-	int incr = mydata->incr;
+		/* collect the next run of in-service objects of a batching class */
+		while ( i<n && n_batch<OBJECT_SYNC_BATCHSIZE && can_batch && obj[i]->oclass==oclass && oclass->sync_batch!=NULL 
+			&& obj[i]->in_svc<global_clock && global_clock<=obj[i]->out_svc )
+			batch[n_batch++] = obj[i++];
 
-	iPtr = 0;
-	for (ptr = item; ptr != NULL; ptr=ptr->next) {
-		if (iPtr < incr) {
-			ss_do_object_sync(thread, ptr->data);
-			iPtr++;
+		/* sync objects that cannot be batched one at a time */
+		if ( n_batch==0 )
+		{
+			ss_do_object_sync(thread,obj[i]);
+			if ( obj[i++]->valid_to==TS_INVALID )
+				return;
+			continue;
+		}
+
+		object_sync_batch(batch,n_batch,global_clock,passtype[pass],t2);
+		for ( k=0 ; k<n_batch ; k++ )
+		{
+			if ( t2[k]==global_clock )
+			{
+				char b[64];
+				IN_MYCONTEXT output_verbose("%s: object %s calling for re-sync", simtime(), object_name(batch[k], b, 63));
+			}
+			ss_do_object_sync_update(thread,batch[k],t2[k]);
+		}
+		for ( k=0 ; k<n_batch ; k++ )
+		{
+			if ( batch[k]->valid_to==TS_INVALID )
+				return;
 		}
 	}
-	return NULL;
 }
 
 static STATUS init_by_creation()
@@ -1215,15 +1261,12 @@ STATUS t_sync_all(PASSCONFIG pass)
 		/* process object in order of rank using index */
 		for (i = PASSINIT(pass_index); PASSCMP(i, pass_index); i += PASSINC(pass_index))
 		{
-			LISTITEM *item;
-			/* skip empty lists */
-			if (ranks[pass_index]->ordinal[i] == NULL) 
-				continue;
+			INDEXARRAY *array = &ranks[pass_index]->array[i];
+			unsigned int n;
 			
-			
-			for (item=ranks[pass_index]->ordinal[i]->first; item!=NULL; item=item->next)
+			for (n=0; n<array->size; n++)
 			{
-				OBJECT *obj = item->data;
+				OBJECT *obj = array->item[n];
 				if (exec_test(&sync,pass,obj)==FAILED)
 					return FAILED;
 			}
@@ -1299,13 +1342,27 @@ void exec_sleep(unsigned int usec)
 #endif
 }
 
+/* Each thread working on an object rank list owns a deque of objects taken
+   from a contiguous slice of the rank's object array.  The owner syncs objects
+   from the head of its deque while idle threads steal the upper half of the
+   deque of another thread, so that a few slow objects in one slice do not
+   stall the whole rank while other cores sit idle. */
+typedef struct s_objsyncdeque {
+	unsigned int lock; // deque lock (see lock.h)
+	unsigned int head; // index of next object to sync
+	unsigned int tail; // index after last object to sync
+	unsigned int first; // first object of the static slice
+	unsigned int last; // index after last object of the static slice
+} OBJSYNCDEQUE;
+#define OBJSYNC_GRAIN 16 // maximum number of objects a thread takes from its deque at once
+
 typedef struct s_objsyncdata {
 	unsigned int n; // thread id 0~n_threads for this object rank list
 	pthread_t pt;
 	bool ok;
-	//void *item;
-	LISTITEM *ls;
-	unsigned int nObj; // number of obj in this object rank list
+	bool started; // thread was created and must be joined
+	OBJECT **obj; // object array of this object rank list
+	OBJSYNCDEQUE *deque; // deques of all threads on this object rank list
 	unsigned int t0;
 	int i; // index of mutex or cond this object rank list uses 
 } OBJSYNCDATA;
@@ -1318,11 +1375,63 @@ static pthread_cond_t *done;
 static unsigned int *next_t1;
 static unsigned int *donecount;
 static unsigned int *n_threads; //number of thread used in the threadpool of an object rank list
+static OBJSYNCDEQUE **rank_deque; // deques used by the threadpool of an object rank list
+static OBJSYNCDATA **rank_thread; // threads of the threadpool of an object rank list
+
+/* take the next objects from the head of a thread's own deque */
+static unsigned int obj_syncdeque_pop(OBJSYNCDATA *data, OBJECT ***obj)
+{
+	OBJSYNCDEQUE *dq = &data->deque[data->n];
+	unsigned int n = 0;
+	wlock(&dq->lock);
+	if ( dq->head<dq->tail )
+	{
+		n = dq->tail-dq->head;
+		if ( n>OBJSYNC_GRAIN ) 
+			n = OBJSYNC_GRAIN;
+		*obj = data->obj + dq->head;
+		dq->head += n;
+	}
+	wunlock(&dq->lock);
+	return n;
+}
+
+/* steal the upper half of the deque of another thread into this thread's deque */
+static bool obj_syncdeque_steal(OBJSYNCDATA *data)
+{
+	unsigned int nt = n_threads[data->i];
+	unsigned int k;
+	for ( k=1 ; k<nt ; k++ )
+	{
+		OBJSYNCDEQUE *victim = &data->deque[(data->n+k)%nt];
+		unsigned int head = 0, tail = 0;
+		if ( victim->head>=victim->tail ) // unlocked peek to skip empty deques
+			continue;
+		wlock(&victim->lock);
+		if ( victim->head<victim->tail )
+		{
+			tail = victim->tail;
+			head = tail - (tail-victim->head+1)/2;
+			victim->tail = head;
+		}
+		wunlock(&victim->lock);
+		if ( head<tail )
+		{
+			OBJSYNCDEQUE *dq = &data->deque[data->n];
+			wlock(&dq->lock);
+			dq->head = head;
+			dq->tail = tail;
+			wunlock(&dq->lock);
+			return true;
+		}
+	}
+	return false;
+}
 
 static void *obj_syncproc(void *ptr)
 {
 	OBJSYNCDATA *data = (OBJSYNCDATA*)ptr;
-	LISTITEM *s;
+	OBJECT **obj;
 	unsigned int n;
 	int i = data->i;
 
@@ -1333,16 +1442,20 @@ static void *obj_syncproc(void *ptr)
 		pthread_mutex_lock(&startlock[i]);
 
 		// wait for thread start condition)
-		while (data->t0 == next_t1[i]) 
+		while (data->ok && data->t0 == next_t1[i]) 
 			pthread_cond_wait(&start[i], &startlock[i]);
 		// unlock access to start count
 		pthread_mutex_unlock(&startlock[i]);
 
-		// process the list for this thread
-		for (s=data->ls, n=0; s!=NULL, n<data->nObj; s=s->next,n++) {
-			OBJECT *obj = s->data;
-			ss_do_object_sync(data->n, s->data);
-		}
+		// stop when the main loop is done with this thread
+		if (!data->ok)
+			break;
+
+		// process this thread's deque and then help the other threads until no work is left
+		do {
+			while ( (n=obj_syncdeque_pop(data,&obj))>0 )
+				ss_do_object_sync_batch(data->n, obj, n);
+		} while ( obj_syncdeque_steal(data) );
 
 		// signal completed condition
 		data->t0 = next_t1[i];
@@ -1675,9 +1788,7 @@ STATUS exec_start(void)
 	STATUS fnl_rv = 0; // finalize all return value
 	time_t started_at = realtime_now(); // for profiler
 	int j, k;
-	LISTITEM *ptr;
 	int incr;
-	struct arg_data *arg_data_array;
 
 	// Only setup threadpool for each object rank list at the first iteration;
 	// After the first iteration, setTP = false;
@@ -1748,10 +1859,6 @@ STATUS exec_start(void)
 			IN_MYCONTEXT output_verbose("using %d helper thread(s)", global_threadcount);
 		}
 
-		//sjin: allocate arg_data_array to store pthreads creation argument
-		arg_data_array = (struct arg_data *) malloc(sizeof(struct arg_data) 
-						 * global_threadcount);
-
 		/* allocate thread synchronization data */
 		thread_data = (struct thread_data *) malloc(sizeof(struct thread_data) +
 					  sizeof(struct sync_data) * global_threadcount);
@@ -1839,7 +1946,7 @@ STATUS exec_start(void)
 		for (i = PASSINIT(pass); PASSCMP(i, pass); i += PASSINC(pass))
 		{
 			/* skip empty lists */
-			if (ranks[pass]->ordinal[i] == NULL) 
+			if (ranks[pass]->array[i].size == 0) 
 				continue;
 			nObjRankList++; // count how many object rank list in one iteration
 		}
@@ -1857,6 +1964,12 @@ STATUS exec_start(void)
 	n_threads = malloc(sizeof(n_threads[0])*nObjRankList);
 	memset(n_threads,0,sizeof(n_threads[0])*nObjRankList);
 
+	rank_deque = malloc(sizeof(rank_deque[0])*nObjRankList);
+	memset(rank_deque,0,sizeof(rank_deque[0])*nObjRankList);
+
+	rank_thread = malloc(sizeof(rank_thread[0])*nObjRankList);
+	memset(rank_thread,0,sizeof(rank_thread[0])*nObjRankList);
+
 	// allocation and nitialize mutex and cond for object rank lists
 	startlock = malloc(sizeof(startlock[0])*nObjRankList);
 	donelock = malloc(sizeof(donelock[0])*nObjRankList);
@@ -2060,18 +2173,21 @@ STATUS exec_start(void)
 				/* process object in order of rank using index */
 				for (i = PASSINIT(pass); PASSCMP(i, pass); i += PASSINC(pass))
 				{
+					OBJECT **objlist = (OBJECT**)ranks[pass]->array[i].item;
+					unsigned int n_obj = ranks[pass]->array[i].size;
+
 					/* skip empty lists */
-					if (ranks[pass]->ordinal[i] == NULL) 
+					if (n_obj == 0) 
 						continue;
 
 					iObjRankList ++;
 
 					if (global_debug_mode)
 					{
-						LISTITEM *item;
-						for (item=ranks[pass]->ordinal[i]->first; item!=NULL; item=item->next)
+						unsigned int n;
+						for (n=0; n<n_obj; n++)
 						{
-							OBJECT *obj = item->data;
+							OBJECT *obj = objlist[n];
 							// @todo change debug so it uses sync API
 							if (exec_debug(&main_sync,pass,i,obj)==FAILED)
 							{
@@ -2084,23 +2200,13 @@ STATUS exec_start(void)
 						//sjin: if global_threadcount == 1, no pthread multhreading
 						if (global_threadcount == 1) 
 						{
-							for (ptr = ranks[pass]->ordinal[i]->first; ptr != NULL; ptr=ptr->next) {
-								OBJECT *obj = ptr->data;
-								ss_do_object_sync(0, ptr->data);					
-								
-								if (obj->valid_to == TS_INVALID)
-								{
-									//Get us out of the loop so others don't exec on bad status
-									break;
-								}
-								///printf("%d %s %d\n", obj->id, obj->name, obj->rank);
-							}
-							//printf("\n");
+							// objects are synced in batches when possible and the loop
+							// stops at the first invalid object so others don't exec on bad status
+							ss_do_object_sync_batch(0, objlist, n_obj);
 						} 
 						else 
 						{ //sjin: implement pthreads
-							unsigned int n_items,objn=0,n;
-							unsigned int n_obj = ranks[pass]->ordinal[i]->size;
+							unsigned int n_items,n;
 
 							// Only create threadpool for each object rank list at the first iteration. 
 							// Reuse the threadppol of each object rank list at all other iterations.
@@ -2124,28 +2230,40 @@ STATUS exec_start(void)
 								// allocate thread list
 								thread = (OBJSYNCDATA*)malloc(sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
 								memset(thread,0,sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								// assign starting obj for each thread
-								for (ptr=ranks[pass]->ordinal[i]->first;ptr!=NULL;ptr=ptr->next)
-								{
-									if (thread[objn].nObj==n_items)
-										objn++;
-									if (thread[objn].nObj==0) {
-										thread[objn].ls=ptr;
-									}
-									thread[objn].nObj++;
+								rank_thread[iObjRankList] = thread;
+
+								// assign the initial slice of objects to each thread's deque
+								rank_deque[iObjRankList] = (OBJSYNCDEQUE*)malloc(sizeof(OBJSYNCDEQUE)*n_threads[iObjRankList]);
+								memset(rank_deque[iObjRankList],0,sizeof(OBJSYNCDEQUE)*n_threads[iObjRankList]);
+								for (n=0; n<n_threads[iObjRankList]; n++) {
+									OBJSYNCDEQUE *dq = &rank_deque[iObjRankList][n];
+									dq->first = n*n_items;
+									dq->last = (n+1)*n_items<n_obj ? (n+1)*n_items : n_obj;
 								}
+
 								// create threads
 								for (n=0; n<n_threads[iObjRankList]; n++) {
 									thread[n].ok = true;
 									thread[n].i = iObjRankList;
+									thread[n].n = n;
+									thread[n].obj = objlist;
+									thread[n].deque = rank_deque[iObjRankList];
 									if (pthread_create(&(thread[n].pt),NULL,obj_syncproc,&(thread[n]))!=0) {
 										output_fatal("obj_sync thread creation failed");
 										thread[n].ok = false;
-									} else
-										thread[n].n = n;
+									}
+									else
+										thread[n].started = true;
 								}
 
 							}
+
+							// refill each thread's deque with its own slice
+							for (n=0; n<n_threads[iObjRankList]; n++) {
+								OBJSYNCDEQUE *dq = &rank_deque[iObjRankList][n];
+								dq->head = dq->first;
+								dq->tail = dq->last;
+							}
 														
 							// lock access to done count
 							pthread_mutex_lock(&donelock[iObjRankList]);
@@ -2351,6 +2469,24 @@ STATUS exec_start(void)
 #endif
 	}
 
+	// Stop the object rank list threads so none is still waiting on a cond when it is destroyed
+	for(k=0;k<nObjRankList;k++) {
+		unsigned int n;
+		if (rank_thread[k]==NULL)
+			continue;
+		pthread_mutex_lock(&startlock[k]);
+		for (n=0; n<n_threads[k]; n++)
+			rank_thread[k][n].ok = false;
+		pthread_cond_broadcast(&start[k]);
+		pthread_mutex_unlock(&startlock[k]);
+		for (n=0; n<n_threads[k]; n++) {
+			if (rank_thread[k][n].started)
+				pthread_join(rank_thread[k][n].pt,NULL);
+		}
+		free(rank_thread[k]);
+		rank_thread[k] = NULL;
+	}
+
 	// Destroy mutex and cond
 	for(k=0;k<nObjRankList;k++) {
 		pthread_mutex_destroy(&startlock[k]);
@@ -239,6 +239,7 @@ static struct s_varmap {
 	{"browser", PT_char1024, &global_browser, PA_PUBLIC, "browser selection"},
 	{"server_portnum",PT_int32,&global_server_portnum, PA_PUBLIC, "server port number (default is find first open starting at 6267)"},
 	{"server_quit_on_close",PT_bool,&global_server_quit_on_close, PA_PUBLIC, "server quit on connection closed enable flag"},
+	{"server_threads",PT_int32,&global_server_threads, PA_PUBLIC, "number of threads answering server requests"},
 	{"client_allowed",PT_char1024,&global_client_allowed, PA_PUBLIC,"clients from which to accept connecdtions"},
 	{"autoclean",PT_bool,&global_autoclean, PA_PUBLIC, "autoclean enable flag"},
 	{"technology_readiness_level", PT_enumeration, &technology_readiness_level, PA_PUBLIC, "technology readiness level", trl_keys},
@@ -283,10 +284,13 @@ static struct s_varmap {
 	{"deltamode_iteration_limit", PT_int32, &global_deltamode_iteration_limit, PA_PUBLIC, "iteration limit for each delta timestep (object and interupdate)"},
 	{"run_powerworld", PT_bool, &global_run_powerworld, PA_PUBLIC, "boolean that that says your system is set up correctly to run with PowerWorld"},
 	{"bigranks", PT_bool, &global_bigranks, PA_PUBLIC, "enable fast/blind set_rank operations"},
+	{"sortranks", PT_bool, &global_sortranks, PA_PUBLIC, "sort objects in each rank by class"},
 	{"exename", PT_char1024, &global_execname, PA_REFERENCE, "argv[0] value"},
 	{"wget_options", PT_char1024, &global_wget_options, PA_PUBLIC, "wget options"},
 	{"svnroot", PT_char1024, &global_svnroot, PA_PUBLIC, "svnroot"},
 	{"allow_reinclude", PT_bool, &global_reinclude, PA_PUBLIC, "allow the same include file to be included multiple times"},
+	{"schedule_cache", PT_char1024, &global_schedule_cache, PA_PUBLIC, "folder in which compiled schedules are cached"},
+	{"schedule_cache_hits", PT_int32, &global_schedule_cache_hits, PA_REFERENCE, "number of schedules loaded from the schedule cache"},
 	{"output_message_context", PT_set, &global_output_message_context, PA_PUBLIC, "control context from which debug messages are allowed", dmc_keys},
 	/* add new global variables here */
 };
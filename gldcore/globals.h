@@ -190,6 +190,7 @@ GLOBAL char global_browser[1024] /**< default browser to use for GUI */
 	INIT("firefox"); 
 #endif
 GLOBAL int global_server_quit_on_close INIT(0); /** server will quit when connection is closed */
+GLOBAL int global_server_threads INIT(4); /**< number of threads answering server requests */
 GLOBAL int global_autoclean INIT(1); /** server will automatically clean up defunct jobs */
 
 GLOBAL int technology_readiness_level INIT(0); /**< the TRL of the model (see http://sourceforge.net/apps/mediawiki/gridlab-d/index.php?title=Technology_Readiness_Levels) */
@@ -311,10 +312,13 @@ GLOBAL char32 global_sanitizeoffset INIT(""); /**< sanitize lat/lon offset */
 
 GLOBAL bool global_run_powerworld INIT(false);
 GLOBAL bool global_bigranks INIT(true); /**< enable non-recursive set_rank function (good for very deep models) */
+GLOBAL bool global_sortranks INIT(false); /**< sort objects in each rank by class so the same sync function is called consecutively */
 GLOBAL char1024 global_svnroot INIT("http://gridlab-d.svn.sourceforge.net/svnroot/gridlab-d");
 GLOBAL char1024 global_wget_options INIT("maxsize:100MB;update:newer"); /**< maximum size of wget request */
 
 GLOBAL bool global_reinclude INIT(false); /**< allow the same include file to be included multiple times */
+GLOBAL char1024 global_schedule_cache INIT(""); /**< folder in which compiled schedules are kept between runs (empty disables the cache) */
+GLOBAL int32 global_schedule_cache_hits INIT(0); /**< number of schedules loaded from the schedule cache */
 
 typedef enum {
 	DMC_MAIN		= 0x0000000000000001,
@@ -1202,6 +1202,24 @@ inline size_t gl_randomvar_getspec(char *str, size_t size, const randomvar *var)
 #define gl_randomvar_getspec (*callback->randomvar.getspec) /* size_t (*randomvar.getspec(char*,size_t,randomvar*) */
 #endif
 
+/******************************************************************************
+ * Worker pool
+ */
+/** @defgroup gridlabd_h_threadpool Worker pool
+
+	Modules can split a list of independent items into slices that are
+	processed on the core's worker pool.  The call gets the range
+	\p first to \p last-1 and the earliest time returned by any slice is
+	returned.  Runs cannot be nested.
+ @{
+ **/
+#ifdef __cplusplus
+inline TIMESTAMP gl_threadpool_run(TIMESTAMP (*call)(void*,unsigned int,unsigned int), void *arg, unsigned int n_items, unsigned int minitems) { return callback->threadpool_run(call,arg,n_items,minitems); };
+#else
+#define gl_threadpool_run (*callback->threadpool_run) /* TIMESTAMP (*threadpool_run)(POOLCALLFN,void*,unsigned int,unsigned int) */
+#endif
+/**@}*/
+
 /******************************************************************************
  * Remote data access
  */
@@ -2394,6 +2412,14 @@ CDECL int dllkill() { do_kill(NULL); }
 /// Implement class sync export
 #define EXPORT_SYNC(X) EXPORT_SYNC_C(X,X)
 
+/// Implement class batched sync export using the class sync export, which must be defined first
+#define EXPORT_SYNC_BATCH(X) EXPORT int sync_batch_##X(OBJECT **obj, unsigned int n, TIMESTAMP *t1, TIMESTAMP t0, PASSCONFIG pass) { \
+	unsigned int i; for ( i=0 ; i<n ; i++ ) { \
+	callback->sync_batch.enter(obj[i]); \
+	t1[i] = sync_##X(obj[i],t0,pass); \
+	callback->sync_batch.leave(obj[i]); } \
+	return 1; }
+
 #define EXPORT_ISA_C(X,C) EXPORT int isa_##X(OBJECT *obj, char *name) { \
 	return ( obj!=0 && name!=0 ) ? OBJECTDATA(obj,C)->isa(name) : 0; }
 /// Implement class isa export
@@ -12,9 +12,15 @@
 #include "globals.h"
 #include "list.h"
 
+typedef struct s_indexarray {
+	void **item;		/**< the items in the ordinal */
+	unsigned int size;	/**< the number of items in the ordinal */
+} INDEXARRAY;	/**< the contiguous array of items in an ordinal */
+
 typedef struct s_index {
 	unsigned int id;	/**< the index id */
 	GLLIST **ordinal;		/**< the list of ordinals */
+	INDEXARRAY *array;	/**< the compacted arrays of ordinals (NULL until index_compact is called) */
 	int first_ordinal;	/**< the first ordinal in the list */
 	int last_ordinal;	/**< the last ordinal in the list */
 	int last_used;		/**< the last ordinal in use */
@@ -24,6 +30,8 @@ typedef struct s_index {
 INDEX *index_create(int first_ordinal, int last_ordinal);
 STATUS index_insert(INDEX *index, void *data, int ordinal);
 void index_shuffle(INDEX *index);
+STATUS index_compact(INDEX *index, int (*compare)(const void*, const void*));
+void index_release(INDEX *index);
 
 #endif
 
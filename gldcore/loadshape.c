@@ -30,7 +30,6 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <ctype.h>
-#include <pthread.h>
 
 #include "platform.h"
 #include "output.h"
@@ -41,6 +40,8 @@
 #include "random.h"
 #include "schedule.h"
 #include "exec.h"
+#include "timeheap.h"
+#include "threadpool.h"
 
 SET_MYCONTEXT(DMC_LOADSHAPE)
 
@@ -867,195 +868,112 @@ TIMESTAMP loadshape_sync(loadshape *ls, TIMESTAMP t1)
 	return ls->t2>0?ls->t2:TS_NEVER;
 }
 
-typedef struct s_loadshapesyncdata {
-	unsigned int n;
-	pthread_t pt;
-	bool ok;
-	loadshape *ls;
-	unsigned int ns;
-	TIMESTAMP t0;
-	unsigned int ran;
-} LOADSHAPESYNCDATA;
+/* loadshapes waiting for their next event */
+static TIMEHEAP loadshape_heap;
+static loadshape *loadshape_queued = NULL; /* the most recent loadshape already queued */
 
-static pthread_cond_t start_ls = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t startlock_ls = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t done_ls = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t donelock_ls = PTHREAD_MUTEX_INITIALIZER;
-static TIMESTAMP next_t1_ls, next_t2_ls;
-static unsigned int run = 0;
-static unsigned int donecount_ls;
+/* loadshapes driven by interpolated schedules are synchronized on every pass */
+static loadshape **interpolated_list = NULL;
+static unsigned int n_interpolated = 0;
+static unsigned int max_interpolated = 0;
 
 clock_t loadshape_synctime = 0;
 
-void *loadshape_syncproc(void *ptr)
+/* synchronize a loadshape and get the next time it must be synchronized,
+   which is also whenever its schedule changes */
+static TIMESTAMP loadshape_due(loadshape *ls, TIMESTAMP t1)
 {
-	LOADSHAPESYNCDATA *data = (LOADSHAPESYNCDATA*)ptr;
-	loadshape *s;
-	unsigned int n;
-	TIMESTAMP t2;
+	TIMESTAMP t2 = loadshape_sync(ls,t1);
+	if ( ls->schedule!=NULL && ls->schedule->next_t<t2 )
+		t2 = ls->schedule->next_t;
+	return t2;
+}
 
-	// begin processing loop
-	while ( data->ok )
+/* queue the loadshapes created since the last pass so they are synchronized right away */
+static int loadshape_queue_new(void)
+{
+	loadshape *ls;
+	for ( ls=loadshape_list ; ls!=loadshape_queued ; ls=ls->next )
 	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_ls);
-
-		// wait for thread start condition
-		while ( data->t0==next_t1_ls && data->ran==run ) 
-			pthread_cond_wait(&start_ls,&startlock_ls);
-		
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_ls);
-
-		// process the list for this thread
-		t2 = TS_NEVER;
-		for ( s=data->ls, n=0 ; s!=NULL, n<data->ns ; s=s->next, n++ )
+		if ( ls->schedule!=NULL && (ls->schedule->flags&SN_INTERPOLATED)==SN_INTERPOLATED )
 		{
-			TIMESTAMP t = loadshape_sync(s,next_t1_ls);
-			if (t<t2) t2 = t;
+			if ( n_interpolated==max_interpolated )
+			{
+				unsigned int size = max_interpolated>0 ? max_interpolated*2 : 16;
+				loadshape **list = (loadshape**)realloc(interpolated_list,sizeof(loadshape*)*size);
+				if ( list==NULL )
+					return 0;
+				interpolated_list = list;
+				max_interpolated = size;
+			}
+			interpolated_list[n_interpolated++] = ls;
 		}
+		else if ( !timeheap_push(&loadshape_heap,TS_ZERO,ls) )
+			return 0;
+	}
+	loadshape_queued = loadshape_list;
+	return 1;
+}
 
-		// signal completed condition
-		data->t0 = next_t1_ls;
-		data->ran++;
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock_ls);
-
-		// signal thread is done for now
-		donecount_ls--;
-		///printf("action: donecount_ls-- = %d\n", donecount_ls);
-		if ( t2<next_t2_ls ) next_t2_ls = t2;
-
-		// signal change in done condition
-		pthread_cond_broadcast(&done_ls);
+typedef struct s_loadshapesyncdata {
+	TIMEHEAPENTRY *due;
+	TIMESTAMP t1;
+} LOADSHAPESYNCDATA;
 
-		// unlock access to done count
-		pthread_mutex_unlock(&donelock_ls);
+/* synchronize a slice of the due loadshapes */
+static TIMESTAMP loadshape_syncslice(void *arg, unsigned int first, unsigned int last)
+{
+	LOADSHAPESYNCDATA *data = (LOADSHAPESYNCDATA*)arg;
+	TIMESTAMP t2 = TS_NEVER;
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		TIMESTAMP t = data->due[n].t = loadshape_due((loadshape*)data->due[n].item,data->t1);
+		if (t<t2) t2 = t;
 	}
-	pthread_exit((void*)0);
-	return (void*)0;
+	return t2;
 }
+
+/** synchronize the loadshapes that are due at \p t1
+	@return the time of the next loadshape event
+ **/
 TIMESTAMP loadshape_syncall(TIMESTAMP t1)
 {
-	static unsigned int n_threads_ls=0;
-	static LOADSHAPESYNCDATA *thread_ls = NULL;
-	TIMESTAMP t2 = TS_NEVER;
+	LOADSHAPESYNCDATA data;
+	TIMESTAMP t2;
+	unsigned int n;
 	clock_t ts = (clock_t)exec_clock();
 
 	// skip loadshape_syncall if there's no loadshape in the glm
 	if (n_shapes == 0)
 		return TS_NEVER;
 
-	// number of threads desired
-	if (n_threads_ls==0) 
+	// queue any new loadshapes
+	if ( loadshape_queued!=loadshape_list && !loadshape_queue_new() )
 	{
-		loadshape *s;
-		int n_items, ln=0;
-
-		IN_MYCONTEXT output_debug("loadshape_syncall setting up for %d shapes", n_shapes);
-
-		// determine needed threads
-		n_threads_ls = global_threadcount;
-		if (n_threads_ls>1)
-		{
-			unsigned int n;
-			if (n_shapes<n_threads_ls*4)
-				n_threads_ls = n_shapes/4;
-
-			// only need 1 thread if n_shapes is less than 4
-			if (n_threads_ls == 0)
-				n_threads_ls = 1;
-
-			// determine shapes per thread
-			n_items = n_shapes/n_threads_ls;
-			n_threads_ls = n_shapes/n_items;
-			if (n_threads_ls*n_items<n_shapes) // not enough slots yet
-				n_threads_ls++; // add one underused threads
-
-			IN_MYCONTEXT output_debug("loadshape_syncall is using %d of %d available threads", n_threads_ls, global_threadcount);
-			IN_MYCONTEXT output_debug("loadshape_syncall is assigning %d shapes per thread", n_items);
-
-			// allocate thread list
-			thread_ls = (LOADSHAPESYNCDATA*)malloc(sizeof(LOADSHAPESYNCDATA)*n_threads_ls);
-			memset(thread_ls,0,sizeof(LOADSHAPESYNCDATA)*n_threads_ls);
-
-			// assign starting shape for each thread
-			for (s=loadshape_list; s!=NULL; s=s->next)
-			{
-				if (thread_ls[ln].ns==n_items)
-					ln++;
-				if (thread_ls[ln].ns==0)
-					thread_ls[ln].ls = s;
-				thread_ls[ln].ns++;
-			}
-
-			// create threads
-			for (n=0; n<n_threads_ls; n++)
-			{
-				thread_ls[n].ok = true;
-				if ( pthread_create(&(thread_ls[n].pt),NULL,loadshape_syncproc,&(thread_ls[n]))!=0 )
-				{
-					output_fatal("loadshape_sync thread creation failed");
-					thread_ls[n].ok = false;
-				}
-				else
-					thread_ls[n].n = n;
-			}
-		}
-	}
-
-	// don't update if next_t2 < next_t1
-	if ( next_t2_ls>t1 && next_t2_ls<TS_NEVER )
-		return next_t2_ls;
-
-	// no threading required
-	if (n_threads_ls<2) 
-	{
-		// process list directly
-		loadshape *s;
-		for (s=loadshape_list; s!=NULL; s=s->next)
-		{
-			TIMESTAMP t3 = loadshape_sync(s,t1);
-			if (t3<t2) t2 = t3;
-		}
-		next_t2_ls = t2;
+		output_error("loadshape_syncall(): unable to queue loadshapes for synchronization");
+		/* TROUBLESHOOT
+			The loadshape synchronization queue could not be allocated.
+			Try freeing up memory by making more heap available or making the model smaller. 
+		 */
+		return TS_INVALID;
 	}
-	else
-	{
-		// lock access to done count
-		pthread_mutex_lock(&donelock_ls);
-
-		// initialize wait count
-		donecount_ls = n_threads_ls;
-
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_ls);
-
-		// update start condition
-		next_t1_ls = t1;
-		next_t2_ls = TS_NEVER;
-		run++;
 
-		// signal all the threads
-		pthread_cond_broadcast(&start_ls);
+	// synchronize the loadshapes that are due on the worker pool
+	n = timeheap_due(&loadshape_heap,t1);
+	data.due = loadshape_heap.due;
+	data.t1 = t1;
+	threadpool_run(loadshape_syncslice,&data,n,32);
 
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_ls);
+	// put the synchronized loadshapes back until their next event
+	timeheap_requeue(&loadshape_heap);
+	t2 = timeheap_next(&loadshape_heap);
 
-		// begin wait
-		while (donecount_ls>0) {
-			///printf("status: donecount_ls-- = %d\n", donecount_ls);
-			///printf("thread_ls.ok=%d\n",thread_ls->ok);
-			pthread_cond_wait(&done_ls,&donelock_ls);
-		}
-		IN_MYCONTEXT output_debug("passed donecount==0 condition");
-
-		// unlock done count
-		pthread_mutex_unlock(&donelock_ls);
-
-		// process results from all threads
-		if (next_t2_ls<t2) t2=next_t2_ls;
+	// loadshapes on interpolated schedules follow the schedule value continuously
+	for ( n=0 ; n<n_interpolated ; n++ )
+	{
+		TIMESTAMP t3 = loadshape_sync(interpolated_list[n],t1);
+		if (t3<t2) t2 = t3;
 	}
 
 	loadshape_synctime += exec_clock() - ts;
@@ -82,6 +82,7 @@
 #include "exec.h"
 #include "stream.h"
 #include "transform.h"
+#include "threadpool.h"
 
 #include "console.h"
 
@@ -228,6 +229,8 @@ static CALLBACKS callbacks = {
 	{transform_getnext,transform_add_linear,transform_add_external,transform_apply},
 	{randomvar_getnext,randomvar_getspec},
 	{version_major,version_minor,version_patch,version_build,version_branch},
+	threadpool_run,
+	{object_sync_batch_enter,object_sync_batch_leave},
 	MAGIC /* used to check structure */
 };
 CALLBACKS *module_callbacks(void) { return &callbacks; }
@@ -515,6 +518,7 @@ MODULE *module_load(const char *file, /**< module filename, searches \p PATH */
 			{&c->recalc,"recalc",TRUE},
 			{&c->update,"update",TRUE},
 			{&c->heartbeat,"heartbeat",TRUE},
+			{&c->sync_batch,"sync_batch",TRUE},
 		};
 		int i;
 		for (i=0; i<sizeof(map)/sizeof(map[0]); i++)
@@ -106,7 +106,7 @@ PROPERTY *object_access_property(){
 }
 
 /* prototypes */
-void object_tree_delete(OBJECT *obj, OBJECTNAME name);
+void object_name_delete(OBJECT *obj, OBJECTNAME name);
 
 /** Get the number of objects defined 
 
@@ -285,23 +285,102 @@ char *object_get_unit(OBJECT *obj, char *name)
 	}
 }
 
-/** Create a single object.
-	@return a pointer to object header, \p NULL of error, set \p errno as follows:
-	- \p EINVAL type is not valid
-	- \p ENOMEM memory allocation failed
- **/
-OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
-	/* @todo support threadpool during object creation by calling this malloc from the appropriate thread */
-	OBJECT *obj = 0;
-	static int tp_next = 0;
-	static int tp_count = 0;
-	PROPERTY *prop;
-	int sz = sizeof(OBJECT);
+/* Objects are allocated from a slab kept by their class.  Each slab block
+   holds a run of objects of the same class, so objects created together
+   (e.g., by object_create_array) are contiguous in memory and the class
+   batches built by exec.c walk memory in order.  Each object is cleared
+   by the thread that creates it, which is also the first to touch it.
+   Removed objects go on a free list and are reused by the next
+   object_create_single() of the same class. */
+#define SLAB_FIRSTBLOCK 16		/* number of objects in the first block of a slab */
+#define SLAB_MAXBLOCK 4096		/* maximum number of objects in later blocks */
+
+typedef struct s_slabblock {
+	char *data;
+	size_t count; /* number of objects the block holds */
+	size_t used; /* number of objects allocated from the block */
+	struct s_slabblock *next;
+} SLABBLOCK;
+
+typedef struct s_objectslab {
+	size_t size; /* bytes used by each object (header and data) */
+	SLABBLOCK *block; /* most recent block first */
+	OBJECT *free; /* removed objects, linked through their next pointer */
+} OBJECTSLAB;
+
+/* allocate \p n contiguous objects of class \p oclass
+   @return a pointer to the first object, or NULL if memory could not be allocated
+ */
+static OBJECT *object_slab_alloc(CLASS *oclass, unsigned int n)
+{
+	OBJECTSLAB *slab = oclass->slab;
+	SLABBLOCK *block;
+	OBJECT *obj;
 
-	if(tp_count == 0){
-		tp_count = processor_count();
+	if ( slab==NULL )
+	{
+		slab = (OBJECTSLAB*)malloc(sizeof(OBJECTSLAB));
+		if ( slab==NULL )
+			return NULL;
+		slab->size = (sizeof(OBJECT) + oclass->size + 15) & ~(size_t)15; /* keep objects 16-byte aligned */
+		slab->block = NULL;
+		slab->free = NULL;
+		oclass->slab = slab;
+	}
+
+	/* single objects reuse removed ones first */
+	if ( n==1 && slab->free!=NULL )
+	{
+		obj = slab->free;
+		slab->free = obj->next;
+		return obj;
 	}
 
+	block = slab->block;
+	if ( block==NULL || block->count-block->used<n )
+	{
+		size_t count = block==NULL ? SLAB_FIRSTBLOCK : block->count*2;
+		if ( count>SLAB_MAXBLOCK ) count = SLAB_MAXBLOCK;
+		if ( count<n ) count = n;
+		block = (SLABBLOCK*)malloc(sizeof(SLABBLOCK));
+		if ( block==NULL )
+			return NULL;
+		block->data = (char*)malloc(slab->size*count); /* not cleared, so pages are first touched by object creation */
+		if ( block->data==NULL )
+		{
+			free(block);
+			return NULL;
+		}
+		block->count = count;
+		block->used = 0;
+		block->next = slab->block;
+		slab->block = block;
+	}
+	obj = (OBJECT*)(block->data + slab->size*block->used);
+	block->used += n;
+	return obj;
+}
+
+/* release an object created by object_create_single() or object_create_array() */
+static void object_slab_free(OBJECT *obj)
+{
+	OBJECTSLAB *slab = obj->oclass->slab;
+	SLABBLOCK *block;
+	for ( block=(slab?slab->block:NULL) ; block!=NULL ; block=block->next )
+	{
+		if ( (char*)obj>=block->data && (char*)obj<block->data+slab->size*block->count )
+		{
+			obj->next = slab->free;
+			slab->free = obj;
+			return;
+		}
+	}
+	free(obj); /* not from a slab (e.g., foreign or streamed objects) */
+}
+
+/* check the class of a new object */
+static void object_check_class(CLASS *oclass)
+{
 	if(oclass == NULL){
 		throw_exception("object_create_single(CLASS *oclass=NULL): class is NULL");
 		/* TROUBLESHOOT
@@ -317,19 +396,14 @@ OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
 			Some classes may only be inherited but cannot be used directly in models.
 		*/
 	}
+}
 
-	obj = (OBJECT*)malloc(sz + oclass->size);
-
-	if(obj == NULL){
-		throw_exception("object_create_single(CLASS *oclass='%s'): memory allocation failed", oclass->name);
-		/* TROUBLESHOOT
-			The system has run out of memory and is unable to create the object requested.  Try freeing up system memory and try again.
-		 */
-	}
-
-	memset(obj, 0, sz + oclass->size);
+/* initialize a new object and add it to the object list */
+static OBJECT *object_init_single(OBJECT *obj, CLASS *oclass)
+{
+	PROPERTY *prop;
 
-	tp_next %= tp_count;
+	memset(obj, 0, sizeof(OBJECT) + oclass->size);
 
 	obj->id = next_object_id++;
 	obj->oclass = oclass;
@@ -368,6 +442,28 @@ OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
 	return obj;
 }
 
+/** Create a single object.
+	@return a pointer to object header, \p NULL of error, set \p errno as follows:
+	- \p EINVAL type is not valid
+	- \p ENOMEM memory allocation failed
+ **/
+OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
+	OBJECT *obj = 0;
+
+	object_check_class(oclass);
+
+	obj = object_slab_alloc(oclass,1);
+
+	if(obj == NULL){
+		throw_exception("object_create_single(CLASS *oclass='%s'): memory allocation failed", oclass->name);
+		/* TROUBLESHOOT
+			The system has run out of memory and is unable to create the object requested.  Try freeing up system memory and try again.
+		 */
+	}
+
+	return object_init_single(obj,oclass);
+}
+
 /** Create a foreign object.
 
 	@return a pointer to object header, \p NULL of error, set \p errno as follows:
@@ -453,18 +549,26 @@ void object_stream_fixup(OBJECT *obj, char *classname, char *objname)
  **/
 OBJECT *object_create_array(CLASS *oclass, /**< a pointer to the CLASS structure */
 							unsigned int n_objects){ /**< the number of objects to create */
-	OBJECT *first = NULL;
-	
-	while(n_objects-- > 0){
-		OBJECT *obj = object_create_single(oclass);
-		
-		if(obj == NULL){
-			return NULL;
-		} else if(first == NULL){
-			first = obj;
-		}
+	char *data;
+	unsigned int n;
+
+	if(n_objects == 0){
+		return NULL;
 	}
-	return first;
+	object_check_class(oclass);
+
+	/* the objects are allocated together so they are contiguous */
+	data = (char*)object_slab_alloc(oclass,n_objects);
+	if(data == NULL){
+		throw_exception("object_create_array(CLASS *oclass='%s', unsigned int n_objects=%u): memory allocation failed", oclass->name, n_objects);
+		/* TROUBLESHOOT
+			The system has run out of memory and is unable to create the objects requested.  Try freeing up system memory and try again.
+		 */
+	}
+	for(n = 0; n < n_objects; n++){
+		object_init_single((OBJECT*)(data + oclass->slab->size*n),oclass);
+	}
+	return (OBJECT*)data;
 }
 
 /** Removes a single object.
@@ -487,11 +591,11 @@ OBJECT *object_remove_by_id(OBJECTNUM id){
 			}
 		}
 		
-		object_tree_delete(target, target->name ? target->name : (sprintf(name, "%s:%d", target->oclass->name, target->id), name));
+		object_name_delete(target, target->name ? target->name : (sprintf(name, "%s:%d", target->oclass->name, target->id), name));
 		next = target->next;
 		prev->next = next;
 		target->oclass->profiler.numobjs--;
-		free(target);
+		object_slab_free(target);
 		target = NULL;
 		deleted_object_count++;
 	}
@@ -1545,6 +1649,126 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 	return t2;
 }
 
+/** Synchronize a batch of objects of the same class.
+
+	The objects are passed to the class's sync_batch function in a single
+	call when the class exports one.  The sync_batch function must bracket
+	the sync of each object with object_sync_batch_enter() and
+	object_sync_batch_leave(), so that each object is locked and timed only
+	for its own sync, as it is by object_sync().  Objects that need special handling
+	(skipsafe, sync horizon) and all objects when profiling or debug output
+	are enabled are synchronized using object_sync().  The time of the next
+	event of each object is stored in \p t2.
+ */
+void object_sync_batch(OBJECT **obj, /**< the objects to synchronize (all of the same class) */
+					   unsigned int n, /**< the number of objects */
+					   TIMESTAMP ts, /**< the desire clock to sync to */
+					   PASSCONFIG pass, /**< the pass configuration */
+					   TIMESTAMP *t2) /**< the time of the next event of each object */
+{
+	typedef int (*SYNCBATCHFN)(OBJECT**,unsigned int,TIMESTAMP*,TIMESTAMP,PASSCONFIG);
+	OBJECT *batch[OBJECT_SYNC_BATCHSIZE];
+	TIMESTAMP t1[OBJECT_SYNC_BATCHSIZE];
+	TIMESTAMP plc_time[OBJECT_SYNC_BATCHSIZE];
+	unsigned int index[OBJECT_SYNC_BATCHSIZE];
+	CLASS *oclass;
+	unsigned int i, m;
+	int autolock;
+
+	if ( n==0 )
+		return;
+	oclass = obj[0]->oclass;
+	autolock = oclass->passconfig&PC_AUTOLOCK;
+
+	/* use single object sync when batching is not possible */
+	if ( oclass->sync_batch==NULL || global_profiler==1 || global_debug_output>0 )
+	{
+		for ( i=0 ; i<n ; i++ )
+			t2[i] = object_sync(obj[i],ts,pass);
+		return;
+	}
+
+	for ( i=0 ; i<n ; i+=m )
+	{
+		unsigned int k, n_batch = 0;
+		m = n-i<OBJECT_SYNC_BATCHSIZE ? n-i : OBJECT_SYNC_BATCHSIZE;
+
+		/* collect the objects that can be batched */
+		for ( k=0 ; k<m ; k++ )
+		{
+			OBJECT *my = obj[i+k];
+			TIMESTAMP effective_valid_to = min(my->clock+global_skipsafe,my->valid_to);
+			if ( (global_skipsafe>0 && (my->flags&OF_SKIPSAFE) && ts<effective_valid_to) 
+				|| (my->valid_to>0 && my->valid_to<ts) )
+			{
+				t2[i+k] = object_sync(my,ts,pass);
+				continue;
+			}
+			if ( (my->flags&OF_RECALC) && oclass->recalc!=NULL )
+			{
+				if (autolock) wlock(&my->lock);
+				oclass->recalc(my);
+				if (autolock) wunlock(&my->lock);
+				my->flags &= ~OF_RECALC;
+			}
+			plc_time[n_batch] = TS_NEVER;
+			if ( !(my->flags&OF_HASPLC) && oclass->plc!=NULL && pass==PC_BOTTOMUP )
+			{
+				if (autolock) wlock(&my->lock);
+				plc_time[n_batch] = oclass->plc(my,ts);
+				if (autolock) wunlock(&my->lock);
+			}
+			index[n_batch] = i+k;
+			batch[n_batch++] = my;
+		}
+		if ( n_batch==0 )
+			continue;
+
+		/* sync the batch */
+		if ( !((SYNCBATCHFN)oclass->sync_batch)(batch,n_batch,t1,ts,pass) )
+		{
+			for ( k=0 ; k<n_batch ; k++ )
+				t1[k] = TS_INVALID;
+		}
+
+		/* compute valid_to times and finish objects that need another sync */
+		for ( k=0 ; k<n_batch ; k++ )
+		{
+			OBJECT *my = batch[k];
+			TIMESTAMP t = t1[k];
+			if ( absolute_timestamp(plc_time[k])<absolute_timestamp(t) )
+				t = plc_time[k];
+			my->valid_to = ( t>TS_MAX ? TS_NEVER : t );
+			if ( t>0 && ts>t && t<TS_NEVER )
+				t = object_sync(my,ts,pass);
+			t2[index[k]] = ( t>TS_MAX ? TS_NEVER : t );
+		}
+	}
+}
+
+/** Lock an object of a batch and set the lockup alarm before its own sync.
+	Called by the class's sync_batch function for each object in turn.
+ **/
+void object_sync_batch_enter(OBJECT *obj)
+{
+	if ( obj->oclass->passconfig&PC_AUTOLOCK )
+		wlock(&obj->lock);
+#ifndef WIN32
+	alarm(global_maximum_synctime);
+#endif
+}
+
+/** Clear the lockup alarm and unlock an object of a batch after its own sync
+ **/
+void object_sync_batch_leave(OBJECT *obj)
+{
+#ifndef WIN32
+	alarm(0);
+#endif
+	if ( obj->oclass->passconfig&PC_AUTOLOCK )
+		wunlock(&obj->lock);
+}
+
 TIMESTAMP object_heartbeat(OBJECT *obj)
 {
 	clock_t t = (clock_t)exec_clock();
@@ -2120,140 +2344,127 @@ double convert_to_longitude(char *buffer)
 }
 
 /***************************************************************************
- OBJECT NAME TREE
+ OBJECT NAME INDEX
  ***************************************************************************/
 
-typedef struct s_objecttree {
+/* Object names are kept in an open-addressing hash table.  The items hold
+   the names themselves (obj->name points to item->name), so they are
+   allocated in chunks rather than one at a time, and deleted items are
+   reused. */
+typedef struct s_objectnameitem {
 	char name[64];
 	OBJECT *obj;
-	struct s_objecttree *before, *after;
-	int balance; /* unused */
-} OBJECTTREE;
+	struct s_objectnameitem *next; /* next unused item */
+} OBJECTNAMEITEM;
 
-static OBJECTTREE *top=NULL;
+#define NAME_CHUNKSIZE 1024
+static OBJECTNAMEITEM *name_chunk = NULL;
+static unsigned int name_chunk_used = NAME_CHUNKSIZE;
+static OBJECTNAMEITEM *name_unused = NULL;
 
-void debug_traverse_tree(OBJECTTREE *tree){
-	if(tree == NULL){
-		tree = top;
-		if(top == NULL){
-			return;
-		}
-	}
-	if(tree->before != NULL){
-		debug_traverse_tree(tree->before);
+static OBJECTNAMEITEM name_deleted; /* marks a deleted slot in the index */
+static OBJECTNAMEITEM **name_index = NULL;
+static unsigned int name_index_size = 0; /* always a power of 2 */
+static unsigned int name_index_used = 0; /* number of names and deleted slots */
+
+static OBJECTNAMEITEM *object_name_alloc(void)
+{
+	OBJECTNAMEITEM *item = name_unused;
+	if ( item!=NULL )
+	{
+		name_unused = item->next;
+		return item;
 	}
-	output_test("%s", tree->name);
-	if(tree->after != NULL){
-		debug_traverse_tree(tree->after);
+	if ( name_chunk_used==NAME_CHUNKSIZE )
+	{
+		OBJECTNAMEITEM *chunk = (OBJECTNAMEITEM*)malloc(sizeof(OBJECTNAMEITEM)*NAME_CHUNKSIZE);
+		if ( chunk==NULL )
+			return NULL;
+		name_chunk = chunk;
+		name_chunk_used = 0;
 	}
+	return &name_chunk[name_chunk_used++];
 }
 
-/* returns the height of the tree */
-int tree_get_height(OBJECTTREE *tree){
-	if(tree == NULL){
-		return 0;
-	} else {
-		int left = tree_get_height(tree->before);
-		int right = tree_get_height(tree->after);
-		if(left > right)
-			return left+1;
-		else return right+1;
-	}
-}
-
-/* returns the node to point to instead of tree */
-void rotate_tree_right(OBJECTTREE **tree){ /* move one object from left to right */
-	OBJECTTREE *root, *pivot, *child;
-	root = *tree;
-	pivot = root->before;
-	child = root->before->after;
-	*tree = pivot;
-	pivot->after = root;
-	root->before = child;
-	root->balance += 2;
-	pivot->balance += 1;
-}
-
-/* returns the node to point to instead of tree */
-void rotate_tree_left(OBJECTTREE **tree){ /* move one object from right to left */
-	OBJECTTREE *root, *pivot, *child;
-	root = *tree;
-	pivot = root->after;
-	child = root->after->before;
-	*tree = pivot;
-	pivot->before = root;
-	root->after = child;
-	root->balance -= 2;
-	pivot->balance -= 1;
-}
-
-/*  Rebalance the tree to make searching more efficient
-	It's a good idea to this after the tree is built
- */
-int object_tree_rebalance(OBJECTTREE *tree) /* AVL logic */
+static void object_name_release(OBJECTNAMEITEM *item)
 {
-	/* currently being done during insertions & deletions */
-	return 0;
+	item->next = name_unused;
+	name_unused = item;
 }
 
-/*	Add an item to the tree
-	returns the "correct" root node for the subtree that an object was added to.
- */
-static int addto_tree(OBJECTTREE **tree, OBJECTTREE *item){
-	int rel = strcmp((*tree)->name, item->name);
-	int right = 0, left = 0, ir = 0, il = 0, rv = 0, height = 0;
-
-	// find location to insert new object
-	if(rel > 0){
-		if((*tree)->before == NULL){
-			(*tree)->before = item;
-		} else {
-			rv = addto_tree(&((*tree)->before), item);
-			if(global_no_balance){
-				return rv + 1;
-			}
-		}
-	} else if(rel<0) {
-		if((*tree)->after == NULL) {
-			(*tree)->after = item;
-		} else {
-			rv = addto_tree(&((*tree)->after),item);
-			if(global_no_balance){
-				return rv + 1;
-			}
-		}
-	} else {
-		return (*tree)->obj==item->obj;
+static unsigned int object_name_hash(const char *name)
+{
+	unsigned int h = 2166136261u; /* FNV-1a */
+	while ( *name!='\0' )
+	{
+		h ^= (unsigned char)*name++;
+		h *= 16777619u;
 	}
+	return h;
+}
 
-	// check balance
-	right = tree_get_height((*tree)->after);
-	left = tree_get_height((*tree)->before);
-	(*tree)->balance = right - left;
+/* find the slot of a name in the index
+   @return the slot holding the name, or NULL if the name is not in the index
+ */
+static OBJECTNAMEITEM **object_name_slot(const char *name)
+{
+	unsigned int mask = name_index_size-1, h;
+	if ( name_index==NULL )
+		return NULL;
+	for ( h=object_name_hash(name)&mask ; name_index[h]!=NULL ; h=(h+1)&mask )
+	{
+		if ( name_index[h]!=&name_deleted && strcmp(name_index[h]->name,name)==0 )
+			return &name_index[h];
+	}
+	return NULL;
+}
 
-	// rotations needed?
-	if((*tree)->balance > 1){
-		if((*tree)->after->balance < 0){ /* inner left is heavy */
-			rotate_tree_right(&((*tree)->after));
-		}
-		rotate_tree_left(tree);	//	was left/right
-	} else if((*tree)->balance < -1){
-		if((*tree)->before->balance > 0){ /* inner right is heavy */
-			rotate_tree_left(&((*tree)->before));
+/* resize the index to hold at least \p n names, dropping deleted slots
+   @return 1 on success, 0 if memory could not be allocated
+ */
+static int object_name_resize(unsigned int n)
+{
+	unsigned int size = 1024, i, mask;
+	OBJECTNAMEITEM **index;
+	while ( size<2*n )
+		size *= 2;
+	index = (OBJECTNAMEITEM**)calloc(size,sizeof(OBJECTNAMEITEM*));
+	if ( index==NULL )
+		return 0;
+	mask = size-1;
+	name_index_used = 0;
+	for ( i=0 ; i<name_index_size ; i++ )
+	{
+		OBJECTNAMEITEM *item = name_index[i];
+		if ( item!=NULL && item!=&name_deleted )
+		{
+			unsigned int h;
+			for ( h=object_name_hash(item->name)&mask ; index[h]!=NULL ; h=(h+1)&mask ) {}
+			index[h] = item;
+			name_index_used++;
 		}
-		rotate_tree_right(tree);
 	}
-	return tree_get_height(*tree); /* verify after rotations */
+	free(name_index);
+	name_index = index;
+	name_index_size = size;
+	return 1;
 }
 
-/*	Add an object to the object tree.  Throws exceptions on memory errors.
-	Returns a pointer to the object tree item if successful, NULL on failure (usually because name already used)
+/*	Add an object name to the index.  
+	Returns a pointer to the index item if successful, NULL on failure (usually because name already used)
  */
-static OBJECTTREE *object_tree_add(OBJECT *obj, OBJECTNAME name){
-	OBJECTTREE *item = (OBJECTTREE*)malloc(sizeof(OBJECTTREE));
+static OBJECTNAMEITEM *object_name_add(OBJECT *obj, OBJECTNAME name){
+	OBJECTNAMEITEM **slot = object_name_slot(name);
+	OBJECTNAMEITEM *item;
+	unsigned int h, mask;
+
+	if(slot != NULL){
+		return (*slot)->obj==obj ? *slot : NULL;
+	}
 
-	if(item == NULL) {
-		output_fatal("object_tree_add(obj='%s:%d', name='%s'): memory allocation failed (%s)", obj->oclass->name, obj->id, name, strerror(errno));
+	item = object_name_alloc();
+	if(item == NULL || (2*(name_index_used+1) > name_index_size && !object_name_resize(name_index_used+1))) {
+		output_fatal("object_name_add(obj='%s:%d', name='%s'): memory allocation failed (%s)", obj->oclass->name, obj->id, name, strerror(errno));
 		return NULL;
 		/* TROUBLESHOOT
 			The memory required to add this object to the object index is not available.  Try freeing up system memory and try again.
@@ -2261,99 +2472,26 @@ static OBJECTTREE *object_tree_add(OBJECT *obj, OBJECTNAME name){
 	}
 	
 	item->obj = obj;
-	item->balance = 0;
-	strncpy(item->name, name, sizeof(item->name));
-	item->before = item->after = NULL;
+	strncpy(item->name, name, sizeof(item->name)-1);
+	item->name[sizeof(item->name)-1] = '\0';
 
-	if(top == NULL){
-		top = item;
-		return top;
-	} else {
-		if(addto_tree(&top, item) != 0){
-			return item;
-		} else {
-			return NULL;
-		}
-	}
+	mask = name_index_size-1;
+	for ( h=object_name_hash(item->name)&mask ; name_index[h]!=NULL && name_index[h]!=&name_deleted ; h=(h+1)&mask ) {}
+	if ( name_index[h]==NULL )
+		name_index_used++;
+	name_index[h] = item;
+	return item;
 }
 
-/*	Finds a name in the tree
+/*	Deletes a name from the index if it belongs to the object
+	WARNING: removing an index entry does NOT free() its object!
  */
-static OBJECTTREE **findin_tree(OBJECTTREE *tree, OBJECTNAME name)
+void object_name_delete(OBJECT *obj, OBJECTNAME name)
 {
-	static OBJECTTREE **temptree = NULL;
-	if(tree == NULL){
-		return NULL;
-	} else {
-		int rel = strcmp(tree->name, name);
-		if(rel > 0){
-			if(tree->before != NULL){
-				if(strcmp(tree->before->name, name) == 0){
-					return &(tree->before);
-				} else {
-					return findin_tree(tree->before, name);
-				}
-			} else {
-				return NULL;
-			}
-		} else if(rel<0) {
-			if(tree->after != NULL){
-				if(strcmp(tree->after->name, name) == 0){
-					return &(tree->after);
-				} else {
-					return findin_tree(tree->after, name);
-				}
-			} else {
-				return NULL;
-			}
-		} else {
-			return (temptree = &tree);
-		}
-	}
-}
-
-/*	Deletes a name from the tree
-	WARNING: removing a tree entry does NOT free() its object!
- */
-void object_tree_delete(OBJECT *obj, OBJECTNAME name)
-{
-	OBJECTTREE **item = findin_tree(top,name);
-	OBJECTTREE *temp = NULL, **dtemp = NULL;
-
-	if(item != NULL && strcmp((*item)->name, name)!=0){
-		if((*item)->after == NULL && (*item)->before == NULL){ /* no children -- nuke */
-			free(*item);
-			*item = NULL;
-		} else if((*item)->after != NULL && (*item)->before != NULL){ /* two children -- find a replacement */
-			dtemp = &((*item)->before);
-			while(temp->after != NULL)
-				dtemp = &(temp->after);
-			temp = (*dtemp)->before;
-			(*dtemp)->before = (*item)->before;
-			(*dtemp)->after = (*item)->after;
-			free(*item);
-			*item = *dtemp;
-			*dtemp = temp;
-			/* replace item with the rightmost left element.*/
-
-		} else if((*item)->after == NULL || (*item)->before == NULL){ /* one child -- promotion time! */
-			if((*item)->after != NULL){
-				temp = (*item)->after;
-				free(*item);
-				*item = temp;
-			} else if((*item)->before != NULL){
-				temp = (*item)->before;
-				free(*item);
-				*item = temp;
-			} else {
-				output_fatal("unexpected branch result in object_tree_delete");
-				/*	TROUBLESHOOT
-					This should never happen and if it does, the system has become unstable and the problem should be reported.
-				 */
-			}
-		}
-
-		/* throw_exception("object_tree_delete(obj=%s:%d, name='%s'): rename of objects in tree is not supported yet", obj->oclass->name, obj->id, name); */
+	OBJECTNAMEITEM **slot = object_name_slot(name);
+	if(slot != NULL && (*slot)->obj == obj){
+		object_name_release(*slot);
+		*slot = &name_deleted;
 	}
 }
 
@@ -2361,12 +2499,10 @@ void object_tree_delete(OBJECT *obj, OBJECTNAME name)
 	@return a pointer to the OBJECT structure
  **/
 OBJECT *object_find_name(OBJECTNAME name){
-	OBJECTTREE **item = NULL;
-
-	item = findin_tree(top, name);
+	OBJECTNAMEITEM **slot = object_name_slot(name);
 	
-	if(item != NULL && *item != NULL){
-		return (*item)->obj;
+	if(slot != NULL){
+		return (*slot)->obj;
 	} else {
 		/* normal operation, remain silent */
 		return NULL;
@@ -2411,7 +2547,7 @@ int object_build_name(OBJECT *obj, char *buffer, int len){
 	Throws an exception when a memory error occurs or when the name is already taken by another object.
  **/
 OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name){
-	OBJECTTREE *item = NULL;
+	OBJECTNAMEITEM *item = NULL;
 
 	if((isalpha(name[0]) != 0) || (name[0] == '_')){
 		; // good
@@ -2424,7 +2560,11 @@ OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name){
 		}
 	}
 	if(obj->name != NULL){
-		object_tree_delete(obj,name);
+		if(name != NULL && strcmp(obj->name,name) == 0){
+			return obj->name; // already named so, and name may point into the item in use
+		}
+		object_name_delete(obj,obj->name);
+		obj->name = NULL;
 	}
 	
 	if(name != NULL){
@@ -2436,7 +2576,7 @@ OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name){
 			*/
 			return NULL;
 		}
-		item = object_tree_add(obj,name);
+		item = object_name_add(obj,name);
 		if(item != NULL){
 			obj->name = item->name;
 		}
@@ -2459,7 +2599,7 @@ void remove_objects(){
 	while(obj1 != NULL){
 		first_object = obj1->next;
 		obj1->oclass->profiler.numobjs--;
-		free(obj1);
+		object_slab_free(obj1);
 		obj1 = first_object;
 	}
 
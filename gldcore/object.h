@@ -25,6 +25,8 @@ typedef unsigned int OBJECTNUM; /** Object id number */
 typedef char * OBJECTNAME; /** Object name */
 typedef char FULLNAME[1024]; /** Full object name (including space name) */
 
+#define OBJECT_SYNC_BATCHSIZE 64	/**< maximum number of objects passed in one call to a class's sync_batch function */
+
 /* object flags */
 #define OF_NONE			0x00000000	/**< Object flag; none set */
 #define OF_HASPLC		0x00000001	/**< Object flag; external PLC is attached, disables local PLC */
@@ -329,6 +331,11 @@ typedef struct s_callbacks {
 		unsigned int (*build)(void);
 		const char * (*branch)(void);
 	} version;
+	TIMESTAMP (*threadpool_run)(TIMESTAMP (*call)(void*,unsigned int,unsigned int), void *arg, unsigned int n_items, unsigned int minitems);
+	struct {
+		void (*enter)(OBJECT *obj);
+		void (*leave)(OBJECT *obj);
+	} sync_batch;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -372,6 +379,9 @@ int object_locate_property(void *addr, OBJECT **pObj, PROPERTY **pProp);
 int object_get_oflags(KEYWORD **extflags);
 
 TIMESTAMP object_sync(OBJECT *obj, TIMESTAMP to,PASSCONFIG pass);
+void object_sync_batch(OBJECT **obj, unsigned int n, TIMESTAMP to, PASSCONFIG pass, TIMESTAMP *t2);
+void object_sync_batch_enter(OBJECT *obj);
+void object_sync_batch_leave(OBJECT *obj);
 OBJECT **object_get_object(OBJECT *obj, PROPERTY *prop);
 OBJECT **object_get_object_by_name(OBJECT *obj, char *name);
 enumeration *object_get_enum(OBJECT *obj, PROPERTY *prop);
@@ -31,6 +31,7 @@
 #include "lock.h"
 #include "platform.h"
 #include "exec.h"
+#include "threadpool.h"
 
 SET_MYCONTEXT(DMC_RANDOM)
 
@@ -1346,18 +1347,52 @@ size_t randomvar_getspec(char *str, size_t size, const randomvar *var)
 		return 0;
 }
 
+static randomvar **randomvar_index = NULL; /* the randomvar list as an array for slicing */
+static unsigned int n_indexed = 0;
+
+/* synchronize a slice of the random variables */
+static TIMESTAMP randomvar_syncslice(void *arg, unsigned int first, unsigned int last)
+{
+	TIMESTAMP t1 = *(TIMESTAMP*)arg;
+	TIMESTAMP t2 = TS_NEVER;
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		TIMESTAMP t3 = randomvar_sync(randomvar_index[n],t1);
+		if ( absolute_timestamp(t3)<absolute_timestamp(t2) ) t2 = t3;
+	}
+	return t2;
+}
+
 TIMESTAMP randomvar_syncall(TIMESTAMP t1)
 {
 	if ( randomvar_list )
 	{
-		randomvar *var;
-		TIMESTAMP t2 = TS_NEVER;
+		TIMESTAMP t2;
 		clock_t ts = (clock_t)exec_clock();
-		for (var=randomvar_list; var!=NULL; var=var->next)
+
+		/* index the random variables created since the last pass */
+		if ( n_indexed!=n_randomvars )
 		{
-			TIMESTAMP t3 = randomvar_sync(var,t1);
-			if ( absolute_timestamp(t3)<absolute_timestamp(t2) ) t2 = t3;
+			randomvar *var;
+			unsigned int n = 0;
+			randomvar **index = (randomvar**)realloc(randomvar_index,sizeof(randomvar*)*n_randomvars);
+			if ( index==NULL )
+			{
+				output_error("randomvar_syncall(): unable to index random variables for synchronization");
+				/* TROUBLESHOOT
+					The random variable synchronization index could not be allocated.
+					Try freeing up memory by making more heap available or making the model smaller. 
+				 */
+				return TS_INVALID;
+			}
+			for (var=randomvar_list; var!=NULL && n<n_randomvars; var=var->next)
+				index[n++] = var;
+			randomvar_index = index;
+			n_indexed = n_randomvars;
 		}
+
+		t2 = threadpool_run(randomvar_syncslice,&t1,n_indexed,64);
 		randomvar_synctime += (clock_t)exec_clock() - ts;
 		return t2!=TS_NEVER ? -absolute_timestamp(t2) : TS_NEVER;
 	}
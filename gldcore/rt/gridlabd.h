@@ -759,11 +759,12 @@ typedef struct s_datetime { ///< The s_datetime structure
 
 struct s_schedule {
 	char name[64];						/**< the name of the schedule */
-	char definition[65536];				/**< the definition string of the schedule */
+	char *definition;					/**< the definition string of the schedule */
 	char blockname[MAXBLOCKS][64];		/**< the name of each block */
 	unsigned char block;				/**< the last block used (4 max) */
-	unsigned char index[14][366*24*60];	/**< the schedule index (enough room for all 14 annual calendars to 1 minute resolution) */
-	uint32 dtnext[14][366*24*60];/**< the time until the next schedule change (in minutes) */
+	unsigned char (*index)[366*24*60];	/**< the full schedule index (only while compiling) */
+	struct s_scheduletable *table;		/**< the compiled schedule index */
+	unsigned int invalid;				/**< the number of invalid definition entries ignored by the compiler */
 	double data[MAXBLOCKS*MAXVALUES];	/**< the list of values used in each block */
 	unsigned int weight[MAXBLOCKS*MAXVALUES];	/**< the weight (in minutes) associate with each value */
 	double sum[MAXBLOCKS];				/**< the sum of values for each block -- used to normalize */
@@ -1325,6 +1326,11 @@ typedef struct s_callbacks {
 		unsigned int (*build)(void);
 		const char * (*branch)(void);
 	} version;
+	TIMESTAMP (*threadpool_run)(TIMESTAMP (*call)(void*,unsigned int,unsigned int), void *arg, unsigned int n_items, unsigned int minitems);
+	struct {
+		void (*enter)(OBJECT *obj);
+		void (*leave)(OBJECT *obj);
+	} sync_batch;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -20,7 +20,7 @@ static char *sanitize_name(OBJECT *obj)
 {
 	SAFENAME *safe = (SAFENAME*)malloc(sizeof(SAFENAME));
 	if ( !safe ) return NULL;
-	safe->old = obj->name;
+	safe->old = strdup(obj->name); // renaming releases the old name
 	char buffer[1024];
 	sprintf(buffer,"%s%llX",global_sanitizeprefix.get_string(),(unsigned int64)safe);
 	safe->name = object_set_name(obj,buffer);
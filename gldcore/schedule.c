@@ -12,6 +12,25 @@
 #include <float.h>
 #include <ctype.h>
 #include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+#include <io.h>
+#include <process.h>
+#include <direct.h>
+typedef struct _stat STAT;
+#define FSTAT _fstat
+#define mkdir(P,M) _mkdir((P))
+#define getpid _getpid
+#define unlink _unlink
+#define snprintf _snprintf
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+typedef struct stat STAT;
+#define FSTAT fstat
+#endif
 
 #include "platform.h"
 #include "object.h"
@@ -21,12 +40,14 @@
 #include "exception.h"
 #include "lock.h"
 #include "exec.h"
+#include "globals.h"
+#include "timeheap.h"
+#include "threadpool.h"
 
 SET_MYCONTEXT(DMC_SCHEDULE)
 
 static SCHEDULE *schedule_list = NULL;
 static uint32 n_schedules = 0;
-static int interpolated_schedules = FALSE;
 
 #ifdef _DEBUG
 unsigned int schedule_checksum(SCHEDULE *sch)
@@ -234,16 +255,14 @@ int schedule_compile_block(SCHEDULE *sch, char *blockname, char *blockdef)
 		else if ( strcmp(token,"absolute")==0 )
 			sch->flags |= SN_NORMAL|SN_ABSOLUTE;
 		else if ( strcmp(token,"interpolated")==0 )
-		{
 			sch->flags |= SN_INTERPOLATED;
-			interpolated_schedules = TRUE;
-		}
 		else if (sscanf(token,"%s%*[ \t]%s%*[ \t]%s%*[ \t]%s%*[ \t]%s%*[ \t]%lf",matcher[0].pattern,matcher[1].pattern,matcher[2].pattern,matcher[3].pattern,matcher[4].pattern,&value)<5) /* value can be missing -> defaults to 1.0 */
 		{
 			output_error("schedule_compile(SCHEDULE *sch='{name=%s, ...}') ignored an invalid definition '%s'", sch->name, token);
 			/* TROUBLESHOOT
 			   The schedule definition is not valid and has been ignored.  Check the syntax of your schedule and try again.
 			 */
+			sch->invalid++;
 			continue;
 		}
 		else
@@ -363,6 +382,14 @@ int schedule_compile(SCHEDULE *sch)
 		/* this is single block unnamed schedule */
 		/* remove leading whitespace */
 		while (isspace(*p)) p++;
+		if (strlen(p)>=sizeof(blockdef))
+		{
+			output_error("schedule %s: definition is too long", sch->name);
+			/* TROUBLESHOOT
+				The definition given the schedule is too long to be used.  Use a definition that is less than 65536 characters and try again.
+			 */
+			return 0;
+		}
 		strcpy(blockdef,p);
 		if (schedule_compile_block(sch,"*",blockdef))
 		{
@@ -454,10 +481,7 @@ int schedule_compile(SCHEDULE *sch)
 				else if (strcmp(blockname,"boolean")==0)
 					sch->flags |= SN_BOOLEAN;
 				else if (strcmp(blockname,"interpolated")==0)
-				{
 					sch->flags |= SN_INTERPOLATED;
-					interpolated_schedules = TRUE;
-				}
 				else
 					output_error("schedule %s: block option '%s' is not recognized", sch->name, blockname);
 				state = CLOSE;
@@ -515,6 +539,346 @@ int schedule_compile(SCHEDULE *sch)
 	return 1;
 }
 
+static SCHEDULETABLE *schedule_tables = NULL;
+static pthread_mutex_t schedule_tablelock = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int schedule_hash(unsigned int hash, const void *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	while ( len-->0 )
+		hash = (hash^*p++)*16777619u;
+	return hash;
+}
+
+/* compares the content of two schedule tables */
+static int schedule_table_equal(SCHEDULETABLE *a, SCHEDULETABLE *b)
+{
+	unsigned int calendar;
+	if ( a->hash!=b->hash || a->invariant!=b->invariant )
+		return 0;
+	for ( calendar=0 ; calendar<14 ; calendar++ )
+	{
+		if ( a->nruns[calendar]!=b->nruns[calendar]
+			|| memcmp(a->run[calendar],b->run[calendar],sizeof(SCHEDULERUN)*a->nruns[calendar])!=0 )
+			return 0;
+	}
+	return 1;
+}
+
+/* encodes the full minute index of a schedule as runs of equal values
+   returns the table, NULL on failure
+ */
+static SCHEDULETABLE *schedule_encode(SCHEDULE *sch)
+{
+	const unsigned int nminutes = sizeof(sch->index[0])/sizeof(sch->index[0][0]);
+	unsigned int calendar, total = 0;
+	SCHEDULETABLE *table;
+	SCHEDULERUN *run;
+
+	/* count the runs so the table can be allocated in one block */
+	for ( calendar=0 ; calendar<14 ; calendar++ )
+	{
+		unsigned int t;
+		total++;
+		for ( t=1 ; t<nminutes ; t++ )
+		{
+			if ( sch->index[calendar][t]!=sch->index[calendar][t-1] )
+				total++;
+		}
+	}
+	table = (SCHEDULETABLE*)malloc(sizeof(SCHEDULETABLE)+sizeof(SCHEDULERUN)*total);
+	if ( table==NULL )
+		return NULL;
+	memset(table,0,sizeof(SCHEDULETABLE));
+	table->hash = 2166136261u;
+	table->invariant = 1;
+	run = (SCHEDULERUN*)(table+1);
+	memset(run,0,sizeof(SCHEDULERUN)*total);
+
+	for ( calendar=0 ; calendar<14 ; calendar++ )
+	{
+		unsigned int t, n, change = nminutes; /* loopback is taken to be a value change */
+		table->run[calendar] = run;
+		for ( t=0 ; t<nminutes ; t++ )
+		{
+			if ( t==0 || sch->index[calendar][t]!=sch->index[calendar][t-1] )
+			{
+				run->start = t;
+				run->index = sch->index[calendar][t];
+				run++;
+				table->nruns[calendar]++;
+			}
+		}
+
+		/* scan backwards through the runs to find when each value next changes */
+		for ( n=table->nruns[calendar] ; n-->0 ; )
+		{
+			SCHEDULERUN *r = table->run[calendar]+n;
+			r->change = change;
+			if ( n>0 && sch->data[r->index]!=sch->data[(r-1)->index] )
+			{
+				change = r->start;
+				table->invariant = 0;
+			}
+		}
+		table->hash = schedule_hash(table->hash,table->run[calendar], sizeof(SCHEDULERUN)*table->nruns[calendar]);
+	}
+
+	IN_MYCONTEXT output_debug("schedule '%s' index uses %d runs (%.1f kB)", sch->name, total, (sizeof(SCHEDULETABLE)+sizeof(SCHEDULERUN)*total)/1000.0);
+	return table;
+}
+
+/* registers a new schedule table unless an identical one exists
+   returns the table to use
+ */
+static SCHEDULETABLE *schedule_share_table(SCHEDULE *sch, SCHEDULETABLE *table)
+{
+	SCHEDULETABLE *other;
+	pthread_mutex_lock(&schedule_tablelock);
+	for ( other=schedule_tables ; other!=NULL ; other=other->next )
+	{
+		if ( schedule_table_equal(table,other) )
+		{
+			other->refcount++;
+			pthread_mutex_unlock(&schedule_tablelock);
+			IN_MYCONTEXT output_debug("schedule '%s' shares its index with another schedule", sch->name);
+			return other;
+		}
+	}
+	table->refcount = 1;
+	table->next = schedule_tables;
+	schedule_tables = table;
+	pthread_mutex_unlock(&schedule_tablelock);
+	return table;
+}
+
+/* finds the run that contains the indexed minute */
+static SCHEDULERUN *schedule_find_run(SCHEDULE *sch, unsigned int cal, unsigned int min)
+{
+	SCHEDULERUN *run = sch->table->run[cal];
+	unsigned int lo = 0, hi = sch->table->nruns[cal];
+	while ( hi-lo>1 )
+	{
+		unsigned int mid = (lo+hi)/2;
+		if ( run[mid].start<=min )
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return run+lo;
+}
+
+/* compiled schedule cache file header
+   the header is followed by the definition (padded to 8 bytes) and the runs of each calendar
+   so the runs can be used directly from a memory map of the file
+ */
+#define SCHEDULECACHE_MAGIC "GLDSCH1"
+typedef struct s_schedulecache {
+	char magic[8];
+	unsigned int size;		/* sizeof(SCHEDULECACHE), rejects files written by other builds */
+	unsigned int length;	/* the length of the definition */
+	char timezone[64];
+	int flags;
+	unsigned int block;
+	int invariant;
+	unsigned int nruns[14];
+	char blockname[MAXBLOCKS][64];
+	double data[MAXBLOCKS*MAXVALUES];
+	unsigned int weight[MAXBLOCKS*MAXVALUES];
+	double sum[MAXBLOCKS];
+	double abs[MAXBLOCKS];
+	unsigned int count[MAXBLOCKS];
+	unsigned int minutes[MAXBLOCKS];
+} SCHEDULECACHE;
+
+#define SCHEDULECACHE_RUNS(L) (sizeof(SCHEDULECACHE)+(((L)+8)&~7)) /* offset of the runs */
+
+/* gets the cache file name of a schedule from the hash of its definition and the timezone
+   returns 1 if the cache is enabled, 0 if not
+ */
+static int schedule_cache_file(SCHEDULE *sch, char *file, size_t len)
+{
+	char *tz = timestamp_current_timezone();
+	uint64 hash = 14695981039346656037ULL;
+	const unsigned char *p;
+	if ( global_schedule_cache[0]=='\0' )
+		return 0;
+	for ( p=(const unsigned char*)sch->definition ; *p!='\0' ; p++ )
+		hash = (hash^*p)*1099511628211ULL;
+	hash = (hash^'\n')*1099511628211ULL;
+	for ( p=(const unsigned char*)tz ; *p!='\0' ; p++ )
+		hash = (hash^*p)*1099511628211ULL;
+	snprintf(file,len,"%s/%016llx.sch",(char*)global_schedule_cache,(unsigned long long)hash);
+	return 1;
+}
+
+static unsigned int sc_cachelock = 0;
+static unsigned int sc_savecount = 0; /* number of cache files written, to keep temporary file names unique */
+
+/* loads a compiled schedule from the cache
+   returns 1 if the schedule was loaded, 0 if it must be compiled
+ */
+static int schedule_cache_load(SCHEDULE *sch)
+{
+	char file[1024];
+	size_t length = strlen(sch->definition), size;
+	SCHEDULECACHE *cache;
+	SCHEDULETABLE *table;
+	SCHEDULERUN *run;
+	unsigned int calendar, total = 0;
+	STAT info;
+	FILE *fp;
+
+	if ( !schedule_cache_file(sch,file,sizeof(file)) || (fp=fopen(file,"rb"))==NULL )
+		return 0;
+	if ( FSTAT(fileno(fp),&info)!=0 || (size_t)info.st_size<SCHEDULECACHE_RUNS(length) )
+	{
+		fclose(fp);
+		return 0;
+	}
+	size = (size_t)info.st_size;
+#ifdef WIN32
+	cache = (SCHEDULECACHE*)malloc(size);
+	if ( cache!=NULL && fread(cache,1,size,fp)!=size )
+	{
+		free(cache);
+		cache = NULL;
+	}
+#else
+	cache = (SCHEDULECACHE*)mmap(NULL,size,PROT_READ,MAP_PRIVATE,fileno(fp),0);
+	if ( cache==(SCHEDULECACHE*)MAP_FAILED )
+		cache = NULL;
+#endif
+	fclose(fp);
+	if ( cache==NULL )
+		return 0;
+
+	/* check that the file is for this definition */
+	for ( calendar=0 ; calendar<14 ; calendar++ )
+		total += cache->nruns[calendar];
+	if ( memcmp(cache->magic,SCHEDULECACHE_MAGIC,sizeof(cache->magic))!=0
+		|| cache->size!=sizeof(SCHEDULECACHE)
+		|| cache->length!=length
+		|| cache->block>MAXBLOCKS
+		|| strcmp(cache->timezone,timestamp_current_timezone())!=0
+		|| memcmp(cache+1,sch->definition,length)!=0
+		|| SCHEDULECACHE_RUNS(length)+sizeof(SCHEDULERUN)*total!=size
+		|| (table=(SCHEDULETABLE*)malloc(sizeof(SCHEDULETABLE)))==NULL )
+	{
+		IN_MYCONTEXT output_debug("schedule '%s' cache file '%s' is not usable", sch->name, file);
+#ifdef WIN32
+		free(cache);
+#else
+		munmap(cache,size);
+#endif
+		return 0;
+	}
+
+	/* use the runs in place */
+	memset(table,0,sizeof(SCHEDULETABLE));
+	table->hash = 2166136261u;
+	table->invariant = cache->invariant;
+	run = (SCHEDULERUN*)((char*)cache+SCHEDULECACHE_RUNS(length));
+	for ( calendar=0 ; calendar<14 ; calendar++ )
+	{
+		table->nruns[calendar] = cache->nruns[calendar];
+		table->run[calendar] = run;
+		table->hash = schedule_hash(table->hash,run,sizeof(SCHEDULERUN)*table->nruns[calendar]);
+		run += table->nruns[calendar];
+	}
+
+	/* restore the compiled values */
+	sch->flags |= cache->flags;
+	sch->block = (unsigned char)cache->block;
+	memcpy(sch->blockname,cache->blockname,sizeof(sch->blockname));
+	memcpy(sch->data,cache->data,sizeof(sch->data));
+	memcpy(sch->weight,cache->weight,sizeof(sch->weight));
+	memcpy(sch->sum,cache->sum,sizeof(sch->sum));
+	memcpy(sch->abs,cache->abs,sizeof(sch->abs));
+	memcpy(sch->count,cache->count,sizeof(sch->count));
+	memcpy(sch->minutes,cache->minutes,sizeof(sch->minutes));
+
+	sch->table = schedule_share_table(sch,table);
+	if ( sch->table!=table )
+	{
+		free(table);
+#ifdef WIN32
+		free(cache);
+#else
+		munmap(cache,size);
+#endif
+	}
+	wlock(&sc_cachelock);
+	global_schedule_cache_hits++;
+	wunlock(&sc_cachelock);
+	IN_MYCONTEXT output_debug("schedule '%s' loaded from cache file '%s'", sch->name, file);
+	return 1;
+}
+
+/* saves a newly compiled schedule to the cache
+   the file is written under a temporary name and renamed so concurrent runs never read a partial file
+ */
+static void schedule_cache_save(SCHEDULE *sch)
+{
+	char file[1024], tmpfile[1100];
+	size_t length = strlen(sch->definition);
+	SCHEDULECACHE *cache;
+	unsigned int calendar, save;
+	int ok;
+	FILE *fp;
+
+	if ( !schedule_cache_file(sch,file,sizeof(file)) )
+		return;
+	cache = (SCHEDULECACHE*)malloc(SCHEDULECACHE_RUNS(length));
+	if ( cache==NULL )
+		return;
+	memset(cache,0,SCHEDULECACHE_RUNS(length));
+	memcpy(cache->magic,SCHEDULECACHE_MAGIC,sizeof(cache->magic));
+	cache->size = sizeof(SCHEDULECACHE);
+	cache->length = (unsigned int)length;
+	strncpy(cache->timezone,timestamp_current_timezone(),sizeof(cache->timezone)-1);
+	cache->flags = sch->flags;
+	cache->block = sch->block;
+	cache->invariant = sch->table->invariant;
+	memcpy(cache->nruns,sch->table->nruns,sizeof(cache->nruns));
+	memcpy(cache->blockname,sch->blockname,sizeof(cache->blockname));
+	memcpy(cache->data,sch->data,sizeof(cache->data));
+	memcpy(cache->weight,sch->weight,sizeof(cache->weight));
+	memcpy(cache->sum,sch->sum,sizeof(cache->sum));
+	memcpy(cache->abs,sch->abs,sizeof(cache->abs));
+	memcpy(cache->count,sch->count,sizeof(cache->count));
+	memcpy(cache->minutes,sch->minutes,sizeof(cache->minutes));
+	memcpy(cache+1,sch->definition,length);
+
+	/* identical definitions compiled on different threads save the same file, so each save gets its own temporary name */
+	wlock(&sc_cachelock);
+	save = ++sc_savecount;
+	wunlock(&sc_cachelock);
+	snprintf(tmpfile,sizeof(tmpfile),"%s.%d.%u.tmp",file,getpid(),save);
+	fp = fopen(tmpfile,"wb");
+	if ( fp==NULL && mkdir(global_schedule_cache,0775)==0 )
+		fp = fopen(tmpfile,"wb");
+	if ( fp==NULL )
+	{
+		output_warning("schedule '%s' cannot be saved in the schedule cache '%s'", sch->name, (char*)global_schedule_cache);
+		/* TROUBLESHOOT
+			The compiled schedule could not be written to the folder given by the <b>schedule_cache</b> global variable.
+			Make sure the folder can be created and written, or clear <b>schedule_cache</b> to disable the cache.
+		 */
+		free(cache);
+		return;
+	}
+	ok = fwrite(cache,1,SCHEDULECACHE_RUNS(length),fp)==SCHEDULECACHE_RUNS(length);
+	for ( calendar=0 ; calendar<14 && ok ; calendar++ )
+		ok = fwrite(sch->table->run[calendar],sizeof(SCHEDULERUN),sch->table->nruns[calendar],fp)==sch->table->nruns[calendar];
+	ok = (fclose(fp)==0) && ok;
+	free(cache);
+	if ( !ok || rename(tmpfile,file)!=0 )
+		unlink(tmpfile);
+	else
+		IN_MYCONTEXT output_debug("schedule '%s' saved to cache file '%s'", sch->name, file);
+}
+
 static pthread_cond_t sc_active = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t sc_activelock = PTHREAD_MUTEX_INITIALIZER;
 static STATUS sc_status = SUCCESS;
@@ -537,104 +901,53 @@ void *schedule_createproc(void *args)
 	pthread_cond_broadcast(&sc_active);
 	pthread_mutex_unlock(&sc_activelock);
 
-	/* compile the schedule */
-	if (schedule_compile(sch))
+	/* use the cached compilation if there is one */
+	if ( !schedule_cache_load(sch) )
 	{
-		/* construct the dtnext array */
-		unsigned char calendar;
-		int invariant = 1;
-		for (calendar=0; calendar<14; calendar++)
+		/* compile the schedule into a full minute index and encode it as runs */
+		sch->index = (unsigned char(*)[366*24*60])calloc(14,sizeof(sch->index[0]));
+		if ( sch->index==NULL )
 		{
-			/* number of minutes that are indexed */
-			int t = sizeof(sch->dtnext[calendar])/sizeof(sch->dtnext[calendar][0])-1;
-
-			/* assume that loopback results in a value change in 1 minute */
-			sch->dtnext[calendar][t] = 1; 
-
-			/* scan backwards through time */
-			for (t--; t>=0; t--)
-			{
-				/* get this and the next index to values */
-				int index0 = sch->index[calendar][t];
-				int index1 = sch->index[calendar][t+1];
-
-				/* if the values are the same */
-				if (sch->data[index0]==sch->data[index1])
-				{	
-					/* if we haven't reached the maximum delta-t (for unsigned char dtnext) */
-					if (sch->dtnext[calendar][t+1]<255)
-
-						/* add 1 minute to next values time */
-						sch->dtnext[calendar][t] = sch->dtnext[calendar][t+1] + 1;
-					else
-
-						/* start the time over at 1 minute (to next value) */
-						sch->dtnext[calendar][t] = 1;
-				}
-				else
-				{
-					/* start the time over at 1 minute (to next value) */
-					sch->dtnext[calendar][t] = 1;
-					invariant = 0;
-				}
-			}
-		}
-
-		/* special case for invariant schedule */
-		if (invariant)
-			memset(sch->dtnext,0,sizeof(sch->dtnext)); /* zero means never */
-
-		/* check for gaps in the schedule */
-		else
-		{
-			int ngaps = 0;
-			int ingap = 0;
-			for (calendar=0; calendar<14; calendar++)
-			{
-				int t;
-				for ( t=0; t<sizeof(sch->dtnext[calendar])/sizeof(sch->dtnext[calendar][0])-1; t++ )
-				{
-					if ( sch->dtnext[calendar][t] == 0 && !ingap)
-					{
-						int day = t/60/24;
-						int hour = t/60 - day*24;
-						int minute = t - hour*60 - day*24*60;
-						IN_MYCONTEXT output_debug("schedule '%s' gap in calendar %d at day %d, hour %d, minute %d lasting %d minutes", sch->name, day, hour, minute);
-						ingap = 1;
-						ngaps++;
-					}
-					else if ( sch->dtnext[calendar][t] != 0 && ingap )
-						ingap = 0;
-				}
-			}
-			if (ngaps>0)
-				output_error("schedule '%s' has %d gaps which may cause erroneous results", sch->name, ngaps);
-				/* TROUBLESHOOT
-					The definition given the schedule has missing data that will cause time synchronization problems.
-					Make sure that all the time covered by the schedule has values given.
-				 */
+			output_error("schedule '%s' index allocation failed", sch->name);
+			/* TROUBLESHOOT
+				The schedule compiler could not allocate enough memory for the schedule index.  Try freeing system memory and try again.
+			 */
+			status = FAILED;
+			goto Done;
 		}
-
-		/* normalize */
-		if (sch->flags!=0)
-			schedule_normalize(sch,sch->flags);
-
-		/* validate */
-		if ((sch->flags&(SN_POSITIVE|SN_NONZERO|SN_BOOLEAN)) != 0 && ! schedule_validate(sch,sch->flags))
+		if ( schedule_compile(sch) )
+			sch->table = schedule_encode(sch);
+		free(sch->index);
+		sch->index = NULL;
+		if ( sch->table==NULL )
 		{
 			status = FAILED;
 			goto Done;
 		}
+		sch->table = schedule_share_table(sch,sch->table);
 
-#ifdef _DEBUG
-		/* calculate checksum */
-		sch->checksum = schedule_checksum(sch);
-		IN_MYCONTEXT output_debug("schedule '%s' checksum is %0x08d", sch->name, sch->checksum);
-#endif
-		status = SUCCESS;
+		/* definitions with ignored entries are recompiled so the errors are reported every run */
+		if ( sch->invalid==0 )
+			schedule_cache_save(sch);
 	}
-	else
+
+	/* normalize */
+	if (sch->flags!=0)
+		schedule_normalize(sch,sch->flags);
+
+	/* validate */
+	if ((sch->flags&(SN_POSITIVE|SN_NONZERO|SN_BOOLEAN)) != 0 && ! schedule_validate(sch,sch->flags))
+	{
 		status = FAILED;
+		goto Done;
+	}
+
+#ifdef _DEBUG
+	/* calculate checksum */
+	sch->checksum = schedule_checksum(sch);
+	IN_MYCONTEXT output_debug("schedule '%s' checksum is %0x08d", sch->name, sch->checksum);
+#endif
+	status = SUCCESS;
 Done:
 	pthread_mutex_lock(&sc_activelock);
 	sc_running--;
@@ -715,7 +1028,6 @@ SCHEDULE *schedule_create(char *name,		/**< the name of the schedule */
 		 */
 		return NULL;
 	}
-	IN_MYCONTEXT output_debug("schedule '%s' uses %.1f MB of memory", name, sizeof(SCHEDULE)/1000000.0);
 	if (strlen(name)>=sizeof(sch->name))
 	{
 		output_error("schedule_create(char *name='%s', char *definition='%s') name too long)", name, definition);
@@ -726,11 +1038,12 @@ SCHEDULE *schedule_create(char *name,		/**< the name of the schedule */
 		return NULL;
 	}
 	strcpy(sch->name,name);
-	if (strlen(definition)>=sizeof(sch->definition))
+	sch->definition = (char*)malloc(strlen(definition)+1);
+	if (sch->definition==NULL)
 	{
-		output_error("schedule_create(char *name='%s', char *definition='%s') definition too long)", name, definition);
+		output_error("schedule_create(char *name='%s', char *definition='%s') memory allocation failed)", name, definition);
 		/* TROUBLESHOOT
-			The definition given the schedule is too long to be used.  Use a definition that is less than 1024 characters and try again.
+			The schedule module could not allocate enough memory to create a schedule item.  Try freeing system memory and try again.
 		 */
 		free(sch);
 		return NULL;
@@ -751,6 +1064,7 @@ SCHEDULE *schedule_create(char *name,		/**< the name of the schedule */
 		else
 		{
 			/* error message should be given by schedule_compile */
+			free(sch->definition);
 			free(sch);
 			sch = NULL;
 			return NULL;
@@ -949,7 +1263,7 @@ double schedule_value(SCHEDULE *sch,		/**< the schedule to read */
 	int32 min = GET_MINUTE(index);
 	if ( cal>=14 || min>=60*24*366 )
 		output_error("schedule_index(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	return sch->data[sch->index[cal][min]];
+	return sch->data[schedule_find_run(sch,cal,min)->index];
 }
 
 /** reads the time until the next change in the schedule 
@@ -962,7 +1276,11 @@ int32 schedule_dtnext(SCHEDULE *sch,			/**< the schedule to read */
 	int32 min = GET_MINUTE(index);
 	if ( cal>=14 || min>=60*24*366 )
 		output_error("schedule_dtnext(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	return sch->dtnext[cal][min];
+	if ( sch->table->invariant )
+		return 0; /* zero means never */
+
+	/* changes more than 255 minutes away are reported in steps of at most 255 minutes */
+	return (schedule_find_run(sch,cal,min)->change-min-1)%255 + 1;
 }
 
 int32 schedule_duration(SCHEDULE *sch,			/**< the schedule to read */
@@ -973,7 +1291,7 @@ int32 schedule_duration(SCHEDULE *sch,			/**< the schedule to read */
 	int block;
 	if ( cal>=14 || min>=60*24*366 )
 		output_error("schedule_duration(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	block = (sch->index[cal][min]>>6)&MAXBLOCKS; // these change if MAXVALUES or MAXBLOCKS changes
+	block = (schedule_find_run(sch,cal,min)->index>>6)&MAXBLOCKS; // these change if MAXVALUES or MAXBLOCKS changes
 	return sch->minutes[block];
 }
 
@@ -984,7 +1302,7 @@ double schedule_weight(SCHEDULE *sch,			/**< the schedule to read */
 	int32 min = GET_MINUTE(index);
 	if ( cal>=14 || min>=60*24*366 )
 		output_error("schedule_weight(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	return sch->weight[sch->index[cal][min]];
+	return sch->weight[schedule_find_run(sch,cal,min)->index];
 }
 
 /** synchronize the schedule to the time given
@@ -1065,197 +1383,107 @@ TIMESTAMP schedule_sync(SCHEDULE *sch, /**< the schedule that is to be synchroni
 	return sch->next_t;
 }
 
-typedef struct s_schedulesyncdata {
-	unsigned int n;
-	pthread_t pt;
-	bool ok;
-	SCHEDULE *sch;
-	unsigned int nsch;
-	TIMESTAMP t0;
-} SCHEDULESYNCDATA;
+/* schedules waiting for their next change */
+static TIMEHEAP schedule_heap;
+static SCHEDULE *schedule_queued = NULL; /* the most recent schedule already queued */
 
-static pthread_cond_t start_sch = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t startlock_sch = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t done_sch = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t donelock_sch = PTHREAD_MUTEX_INITIALIZER;
-static TIMESTAMP next_t1_sch;
-static TIMESTAMP next_t2_sch = TS_ZERO;
-static unsigned int donecount_sch;
+/* interpolated schedules are re-interpolated on every pass */
+static SCHEDULE **interpolated_list = NULL;
+static unsigned int n_interpolated = 0;
+static unsigned int max_interpolated = 0;
 
 clock_t schedule_synctime = 0;
 
-void *schedule_syncproc(void *ptr)
+/* queue the schedules created since the last pass so they are synchronized right away */
+static int schedule_queue_new(void)
 {
-	SCHEDULESYNCDATA *data = (SCHEDULESYNCDATA*)ptr;
 	SCHEDULE *sch;
-	unsigned int n;
-	TIMESTAMP t2;
-
-	// begin processing loop
-	while ( data->ok )
+	for ( sch=schedule_list ; sch!=schedule_queued ; sch=sch->next )
 	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_sch);
-
-		// wait for thread start condition
-		while (data->t0==next_t1_sch) 
-			pthread_cond_wait(&start_sch,&startlock_sch);
-		
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_sch);
-
-		// process the list for this thread
-		t2 = TS_NEVER;
-		for ( sch=data->sch, n=0 ; sch!=NULL, n<data->nsch ; sch=sch->next, n++ )
+		if ( (sch->flags&SN_INTERPOLATED)==SN_INTERPOLATED )
 		{
-			TIMESTAMP t = schedule_sync(sch,next_t1_sch);
-			if (t<t2) t2 = t;
+			if ( n_interpolated==max_interpolated )
+			{
+				unsigned int size = max_interpolated>0 ? max_interpolated*2 : 16;
+				SCHEDULE **list = (SCHEDULE**)realloc(interpolated_list,sizeof(SCHEDULE*)*size);
+				if ( list==NULL )
+					return 0;
+				interpolated_list = list;
+				max_interpolated = size;
+			}
+			interpolated_list[n_interpolated++] = sch;
 		}
+		else if ( !timeheap_push(&schedule_heap,TS_ZERO,sch) )
+			return 0;
+	}
+	schedule_queued = schedule_list;
+	return 1;
+}
 
-		// signal completed condition
-		data->t0 = next_t1_sch;
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock_sch);
-
-		// signal thread is done for now
-		donecount_sch--;
-		if ( t2<next_t2_sch ) next_t2_sch = t2;
-
-		// signal change in done condition
-		pthread_cond_broadcast(&done_sch);
+typedef struct s_schedulesyncdata {
+	TIMEHEAPENTRY *due;
+	TIMESTAMP t1;
+} SCHEDULESYNCDATA;
 
-		// unlock access to done count
-		pthread_mutex_unlock(&donelock_sch);
+/* synchronize a slice of the due schedules */
+static TIMESTAMP schedule_syncslice(void *arg, unsigned int first, unsigned int last)
+{
+	SCHEDULESYNCDATA *data = (SCHEDULESYNCDATA*)arg;
+	TIMESTAMP t2 = TS_NEVER;
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		TIMESTAMP t = data->due[n].t = schedule_sync((SCHEDULE*)data->due[n].item,data->t1);
+		if (t<t2) t2 = t;
 	}
-	pthread_exit((void*)0);
-	return (void*)0;
+	return t2;
 }
 
 /** synchronized all the schedules to the time given
+
+	Only the schedules whose next change is due at \p t1 are synchronized;
+	the others wait in the schedule heap.  Interpolated schedules are
+	synchronized on every call.
+
     @return the time of the next schedule change
  **/
 TIMESTAMP schedule_syncall(TIMESTAMP t1) /**< the time to which the schedule is synchronized */
 {
-	static unsigned int n_threads_sch=0;
-	static SCHEDULESYNCDATA *thread_sch = NULL;
-	TIMESTAMP t2 = TS_NEVER;
+	SCHEDULESYNCDATA data;
+	TIMESTAMP t2;
+	unsigned int n;
 	clock_t ts = (clock_t)exec_clock();
 
 	// skip schedule_syncall if there's no schedule in the glm
 	if (n_schedules == 0)
 		return TS_NEVER;
 
-
-	// number of threads desired
-	if (n_threads_sch==0) 
+	// queue any new schedules
+	if ( schedule_queued!=schedule_list && !schedule_queue_new() )
 	{
-		SCHEDULE *sch;
-		int n_items, schn=0;
-
-		IN_MYCONTEXT output_debug("loadshape_syncall setting up for %d shapes", n_schedules);
-
-		// determine needed threads
-		n_threads_sch = global_threadcount;
-		if (n_threads_sch>1)
-		{
-			unsigned int n;
-			if (n_schedules<n_threads_sch*4)
-				n_threads_sch = n_schedules/4;
-
-			// only need 1 thread if n_schedules is less than 4
-			if (n_threads_sch == 0)
-				n_threads_sch = 1;
-
-			// determine shapes per thread
-			n_items = n_schedules/n_threads_sch;
-			n_threads_sch = n_schedules/n_items;
-			if (n_threads_sch*n_items<n_schedules) // not enough slots yet
-				n_threads_sch++; // add one underused threads
-
-			IN_MYCONTEXT output_debug("schedule_syncall is using %d of %d available threads", n_threads_sch, global_threadcount);
-			IN_MYCONTEXT output_debug("schedule_syncall is assigning %d shapes per thread", n_items);
-
-			// allocate thread list
-			thread_sch = (SCHEDULESYNCDATA*)malloc(sizeof(SCHEDULESYNCDATA)*n_threads_sch);
-			memset(thread_sch,0,sizeof(SCHEDULESYNCDATA)*n_threads_sch);
-
-			// assign starting shape for each thread
-			for (sch=schedule_list; sch!=NULL; sch=sch->next)
-			{
-				if (thread_sch[schn].nsch==n_items)
-					schn++;
-				if (thread_sch[schn].nsch==0)
-					thread_sch[schn].sch = sch;
-				thread_sch[schn].nsch++;
-			}
-
-			// create threads
-			for (n=0; n<n_threads_sch; n++)
-			{
-				thread_sch[n].ok = true;
-				if ( pthread_create(&(thread_sch[n].pt),NULL,schedule_syncproc,&(thread_sch[n]))!=0 )
-				{
-					output_fatal("loadshape_sync thread creation failed");
-					thread_sch[n].ok = false;
-				}
-				else
-					thread_sch[n].n = n;
-			}
-		}
+		output_error("schedule_syncall(): unable to queue schedules for synchronization");
+		/* TROUBLESHOOT
+			The schedule synchronization queue could not be allocated.
+			Try freeing up memory by making more heap available or making the model smaller. 
+		 */
+		return TS_INVALID;
 	}
 
-	// don't update if no schedules ever expect to change again
-	if (next_t2_sch == TS_NEVER)
-		return TS_NEVER;
+	// synchronize the schedules that are due on the worker pool
+	n = timeheap_due(&schedule_heap,t1);
+	data.due = schedule_heap.due;
+	data.t1 = t1;
+	threadpool_run(schedule_syncslice,&data,n,32);
 
-	// don't update if next_t2 < next_t1, but override this if there are interpolated schedules
-	if (next_t2_sch > t1 && !interpolated_schedules)
-		return next_t2_sch;
+	// put the synchronized schedules back until their next change
+	timeheap_requeue(&schedule_heap);
+	t2 = timeheap_next(&schedule_heap);
 
-	// no threading required
-	if (n_threads_sch<2) 
+	// interpolated schedules change continuously
+	for ( n=0 ; n<n_interpolated ; n++ )
 	{
-		// process list directly
-		SCHEDULE *sch;
-		for (sch=schedule_list; sch!=NULL; sch=sch->next)
-		{
-			TIMESTAMP t3 = schedule_sync(sch,t1);
-			if (t3<t2) t2 = t3;
-		}
-		next_t2_sch = t2;
-	}
-	else
-	{
-		// lock access to done count
-		pthread_mutex_lock(&donelock_sch);
-
-		// initialize wait count
-		donecount_sch = n_threads_sch;
-
-		// lock access to start condition
-		pthread_mutex_lock(&startlock_sch);
-
-		// update start condition
-		next_t1_sch = t1;
-		next_t2_sch = TS_NEVER;
-
-		// signal all the threads
-		pthread_cond_broadcast(&start_sch);
-
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock_sch);
-
-		// begin wait
-		while (donecount_sch>0) 
-			pthread_cond_wait(&done_sch,&donelock_sch);
-		IN_MYCONTEXT output_debug("passed donecount==0 condition");
-
-		// unlock done count
-		pthread_mutex_unlock(&donelock_sch);
-
-		// process results from all threads
-		if (next_t2_sch<t2) t2=next_t2_sch;
+		TIMESTAMP t3 = schedule_sync(interpolated_list[n],t1);
+		if (t3<t2) t2 = t3;
 	}
 
 	schedule_synctime += (clock_t)exec_clock() - ts;
@@ -1358,7 +1586,7 @@ void schedule_dump(SCHEDULE *sch, char *file, char *mode)
 	int calendar;
 
 	fprintf(fp,"schedule %s { %s }\n", sch->name, sch->definition);
-	fprintf(fp,"sizeof(SCHEDULE) = %.3f MB\n", (double)sizeof(SCHEDULE)/1024/1024);
+	fprintf(fp,"sizeof(SCHEDULE) = %.3f kB\n", (double)sizeof(SCHEDULE)/1024);
 	for (calendar=0; calendar<14; calendar++)
 	{
 		int year=0, month, y;
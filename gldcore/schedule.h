@@ -50,6 +50,24 @@ typedef uint32 SCHEDULEINDEX;
 #define SCHEDULE_MAGIC 0x47ab617e
 #endif
 
+/** A run of minutes in one annual calendar that share the same value */
+typedef struct s_schedulerun {
+	uint32 start;						/**< the minute of year at which the run starts */
+	uint32 change;						/**< the minute of year at which the value next changes */
+	unsigned char index;				/**< the index of the value (see SCHEDULE::data) */
+} SCHEDULERUN;
+
+/** The compiled run tables of a schedule.  Identical tables are shared by all the schedules that compile to them. */
+typedef struct s_scheduletable SCHEDULETABLE;
+struct s_scheduletable {
+	unsigned int hash;					/**< the content hash of the runs */
+	unsigned int refcount;				/**< the number of schedules using the table */
+	int invariant;						/**< non-zero if the value never changes */
+	unsigned int nruns[14];				/**< the number of runs in each annual calendar */
+	SCHEDULERUN *run[14];				/**< the runs of each annual calendar, sorted by start minute */
+	SCHEDULETABLE *next;	/* next table in list */
+};
+
 /** The SCHEDULE structure defines POSIX style schedules */
 typedef struct s_schedule SCHEDULE;
 struct s_schedule {
@@ -59,11 +77,12 @@ struct s_schedule {
 	unsigned int magic1;	/* values between magic1 and magic2 should never change once compiled */
 #endif
 	char name[64];						/**< the name of the schedule */
-	char definition[65536];				/**< the definition string of the schedule */
+	char *definition;					/**< the definition string of the schedule */
 	char blockname[MAXBLOCKS][64];		/**< the name of each block */
 	unsigned char block;				/**< the last block used (4 max) */
-	unsigned char index[14][366*24*60];	/**< the schedule index (enough room for all 14 annual calendars to 1 minute resolution) */
-	unsigned char dtnext[14][366*24*60];/**< the time until the next schedule change (in minutes) */
+	unsigned char (*index)[366*24*60];	/**< the full schedule index for all 14 annual calendars to 1 minute resolution (only while compiling) */
+	SCHEDULETABLE *table;				/**< the compiled schedule index */
+	unsigned int invalid;				/**< the number of invalid definition entries ignored by the compiler */
 	double data[MAXBLOCKS*MAXVALUES];	/**< the list of values used in each block */
 	unsigned int weight[MAXBLOCKS*MAXVALUES];	/**< the weight (in minutes) associate with each value */
 	double sum[MAXBLOCKS];				/**< the sum of values for each block -- used to normalize */
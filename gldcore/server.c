@@ -8,6 +8,7 @@
 #ifdef WIN32
 
 #include <winsock2.h>
+#define poll WSAPoll
 
 #else
 
@@ -16,6 +17,8 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/errno.h>
 #define SOCKET int
 #define INVALID_SOCKET (-1)
@@ -34,6 +37,7 @@
 #include "exec.h"
 #include "timestamp.h"
 #include "load.h"
+#include "find.h"
 
 #include "legal.h"
 
@@ -46,6 +50,8 @@ SET_MYCONTEXT(DMC_SERVER)
 static int shutdown_server = 0; /**< flag to stop accepting incoming connections */
 SOCKET sockfd = (SOCKET)0; /**< socket on which incomming connections are accepted */
 
+static void server_wakeup(void);
+
 /** Callback function to shut server down
  
     This process halts both the server and the simulator.
@@ -64,6 +70,7 @@ static void shutdown_now(void)
 		shutdown(sockfd,SHUT_RDWR);
 #endif
 	sockfd = (SOCKET)0;
+	server_wakeup();
 	gui_wait_status(GUIACT_HALT);
 	IN_MYCONTEXT output_verbose("server shutdown on exit done");
 }
@@ -79,7 +86,6 @@ int GetLastError()
 #endif
 
 void server_request(int);	// Function to handle clients' request(s)
-void *http_response(void *ptr);
 
 /** Send the data to the client
 	@returns the number of bytes sent if successful, -1 if failed (errno is set).
@@ -88,6 +94,8 @@ static size_t send_data(SOCKET s, char *buffer, size_t len)
 {
 #ifdef WIN32
 	return (size_t)send(s,buffer,(int)len,0);
+#elif defined MSG_NOSIGNAL
+	return (size_t)send(s,buffer,len,MSG_NOSIGNAL); /* a client that hangs up must not raise SIGPIPE */
 #else
 	return (size_t)write(s,buffer,len);
 #endif	
@@ -109,66 +117,7 @@ int client_allowed(char *saddr)
 {
 	return strncmp(saddr,global_client_allowed,strlen(global_client_allowed))==0;
 }
-/** Main server wait loop 
-    @returns a pointer to the status flag
- **/
-static unsigned int n_threads = 0;
-static pthread_t thread_id;
-static void *server_routine(void *arg)
-{
-	static int status = 0;
-	static int started = 0;
-	if (started)
-	{
-		output_error("server routine is already running");
-		return NULL;
-	}
-	started = 1;
-	sockfd = (SOCKET)arg;
-	// repeat forever..
-	static int active = 0;
-	void *result = NULL;
-	while (!shutdown_server)
-	{
-		struct sockaddr_in cli_addr;
-		SOCKET newsockfd;
-
-		int clilen = sizeof(cli_addr);
-
-		/* accept client request and get client address */
-		newsockfd = accept(sockfd,(struct sockaddr *)&cli_addr,&clilen);
-		if ((int)newsockfd<0 && errno!=EINTR)
-		{
-			status = GetLastError();
-			output_error("server accept error on fd=%d: code %d", sockfd, status);
-			goto Done;
-		}
-		else if ((int)newsockfd > 0)
-		{
-			char *saddr = inet_ntoa(cli_addr.sin_addr);
-			if ( !client_allowed(saddr) )
-			{
-				output_error("denying connection from %s on port %d",saddr, cli_addr.sin_port);
-				close(newsockfd);
-				continue;
-			}
-			IN_MYCONTEXT output_verbose("accepting connection from %s on port %d",saddr, cli_addr.sin_port);
-			if ( active )
-				pthread_join(thread_id,&result);
-			if ( pthread_create(&thread_id,NULL, http_response,(void*)newsockfd)!=0 )
-				output_error("unable to start http response thread");
-			if (global_server_quit_on_close)
-				shutdown_now();
-			else
-				gui_wait_status(0);
-			active = 1;
-		}
-	}
-	IN_MYCONTEXT output_verbose("server shutdown");
-Done:
-	started = 0;
-	return (void*)&status;
-}
+static void *server_routine(void *arg);
 
 /** Start accepting incoming connections on the designated server socket
 	@returns SUCCESS/FAILED status code
@@ -285,7 +234,7 @@ STATUS server_join(void)
  */
 
 typedef struct s_httpcnx {
-	char query[1024];
+	char *query; /**< request line of the request being answered */
 	char *buffer;
 	size_t len;
 	size_t max;
@@ -293,6 +242,12 @@ typedef struct s_httpcnx {
 	char *type;
 	SOCKET s;
 	bool cooked;
+	char *in; /**< data received from the client that has not been answered yet */
+	size_t in_len;
+	size_t in_max;
+	bool keep_alive; /**< connection stays open after the response is sent */
+	bool closed; /**< connection was closed while answering the request */
+	struct s_httpcnx *next; /**< next connection waiting for a worker */
 } HTTPCNX;
 
 /** Create an HTTPCNX connection handle
@@ -301,13 +256,30 @@ typedef struct s_httpcnx {
 static HTTPCNX *http_create(SOCKET s)
 {
 	HTTPCNX *http = (HTTPCNX*)malloc(sizeof(HTTPCNX));
+	if ( http==NULL )
+		return NULL;
 	memset(http,0,sizeof(HTTPCNX));
 	http->s = s;
 	http->max = 65536;
 	http->buffer = malloc(http->max);
+	if ( http->buffer==NULL )
+	{
+		free(http);
+		return NULL;
+	}
 	return http;
 }
 
+/** Release an HTTPCNX connection handle
+    @returns Nothing
+ **/
+static void http_free(HTTPCNX *http)
+{
+	free(http->buffer);
+	free(http->in);
+	free(http);
+}
+
 /** Reset an HTTPCNX connection handle
 
 	This function clears the contents of HTTPCNX connection block so that it can be reused to handle a new message.
@@ -386,6 +358,7 @@ static void http_send(HTTPCNX *http)
 	len += sprintf(header+len, "Cache-Control: no-cache\n");
 	len += sprintf(header+len, "Cache-Control: no-store\n");
 	len += sprintf(header+len, "Expires: -1\n");
+	len += sprintf(header+len, "Connection: %s\n", http->keep_alive ? "keep-alive" : "close");
 	len += sprintf(header+len,"\n");
 	send_data(http->s,header,len);
 	if (http->len>0)
@@ -484,6 +457,7 @@ static void http_close(HTTPCNX *http)
 #else
 	close(http->s);
 #endif
+	http->closed = true;
 }
 /** Set the response MIME type **/
 static void http_mime(HTTPCNX *http, char *path)
@@ -581,10 +555,10 @@ static char hex(char c)
 /** Decode the contents of a buffer (in place) **/
 void http_decode(char *buffer)
 {
-	char result[1024], *in, *out = result;
+	char *in, *out = buffer;
 	for ( in=buffer ; *in!='\0' ; in++ )
 	{
-		if (*in=='%')
+		if (*in=='%' && in[1]!='\0' && in[2]!='\0')
 		{
 			char hi = *++in;
 			char lo = *++in;
@@ -594,7 +568,6 @@ void http_decode(char *buffer)
 			*out++ = *in;
 	}
 	*out='\0';
-	strcpy(buffer,result);
 }
 
 int get_value_with_unit(OBJECT *obj, char *arg1, char *arg2, char *buffer, size_t len)
@@ -1091,6 +1064,262 @@ int http_json_request(HTTPCNX *http,char *uri)
 	return 0;
 }
 
+/** Split the next item off a batch list; items are separated by semicolons or newlines
+	@returns the item, or NULL when the list is exhausted
+ **/
+static char *batch_next_item(char **list)
+{
+	char *item = *list, *p;
+	while ( *item==';' || *item=='\r' || *item=='\n' )
+		item++;
+	if ( *item=='\0' )
+		return NULL;
+	p = item+strcspn(item,";\r\n");
+	if ( *p!='\0' )
+		*p++ = '\0';
+	*list = p;
+	return item;
+}
+
+/** Split the next property off a comma-separated property list, leaving unit specs such as [W,4g] intact
+	@returns the property, or NULL when the list is exhausted
+ **/
+static char *batch_next_property(char **list)
+{
+	char *prop = *list, *p;
+	int depth = 0;
+	if ( prop==NULL || *prop=='\0' )
+		return NULL;
+	for ( p=prop ; *p!='\0' ; p++ )
+	{
+		if ( *p=='[' ) depth++;
+		else if ( *p==']' ) depth--;
+		else if ( *p==',' && depth==0 ) break;
+	}
+	if ( *p!='\0' )
+		*p++ = '\0';
+	*list = p;
+	http_decode(prop);
+	return prop;
+}
+
+/** Batch item callback
+	@param obj the object found, or NULL if the item did not match an object
+	@param name the item target as given in the request
+	@param props the comma-separated property list of the item
+	@param n the number of objects reported before this one
+ **/
+typedef void (*BATCHCALL)(HTTPCNX *http, OBJECT *obj, char *name, char *props, unsigned int n);
+
+/** Run a batch request
+
+	A batch is a list of items separated by semicolons (or newlines when
+	the list is posted).  Each item names a target and the properties to
+	read from it, e.g. \p house1/air_temperature,hvac_load[kW].  The target is
+	either an object name, \p class:id, or \p find=<expression> to report
+	every object matched by a find expression, e.g. \p find=class=house.
+
+	@returns the number of objects reported
+ **/
+static unsigned int http_batch(HTTPCNX *http, char *list, BATCHCALL call)
+{
+	unsigned int n = 0;
+	char *item;
+	while ( (item=batch_next_item(&list))!=NULL )
+	{
+		char *props = strchr(item,'/');
+		if ( props!=NULL )
+			*props++ = '\0';
+		else
+			props = "";
+		http_decode(item);
+		if ( strncmp(item,"find=",5)==0 )
+		{
+			FINDPGM *pgm = find_mkpgm(item+5);
+			FINDLIST *found = pgm ? find_runpgm(NULL,pgm) : NULL;
+			OBJECT *obj;
+			if ( found==NULL )
+			{
+				(*call)(http,NULL,item,props,n++);
+				if ( pgm ) free(pgm);
+				continue;
+			}
+			for ( obj=find_first(found) ; obj!=NULL ; obj=find_next(found,obj) )
+				(*call)(http,obj,item,props,n++);
+			free(found);
+			free(pgm);
+		}
+		else
+		{
+			char *id = strchr(item,':');
+			OBJECT *obj = id==NULL ? object_find_name(item) : object_find_by_id(atoi(id+1));
+			(*call)(http,obj,item,props,n++);
+		}
+	}
+	return n;
+}
+
+/** Send a string as a JSON string, escaping quotes, backslashes and control characters **/
+static void http_json_string(HTTPCNX *http, char *str)
+{
+	char *p, *run = str;
+	http_write(http,"\"",1);
+	for ( p=str ; *p!='\0' ; p++ )
+	{
+		if ( *p=='"' || *p=='\\' || (unsigned char)*p<0x20 )
+		{
+			http_write(http,run,p-run);
+			if ( *p=='"' || *p=='\\' )
+				http_format(http,"\\%c",*p);
+			else
+				http_format(http,"\\u%04x",(unsigned char)*p);
+			run = p+1;
+		}
+	}
+	http_write(http,run,p-run);
+	http_write(http,"\"",1);
+}
+
+static void batch_json(HTTPCNX *http, OBJECT *obj, char *name, char *props, unsigned int n)
+{
+	char list[4096], buffer[1024], *p = list, *prop;
+	unsigned int m = 0;
+	http_format(http,"%s\n\t{\"object\": ", n>0 ? "," : "");
+	if ( obj==NULL )
+	{
+		/* the name comes from the request, so it may contain anything */
+		http_json_string(http,name);
+		http_format(http,", \"error\": \"object not found\"}");
+		return;
+	}
+	http_json_string(http,object_name(obj,buffer,sizeof(buffer)));
+	http_format(http,", \"values\": {");
+	strncpy(list,props,sizeof(list)-1);
+	list[sizeof(list)-1] = '\0';
+	while ( (prop=batch_next_property(&p))!=NULL )
+	{
+		char arg2[1024];
+		strncpy(arg2,prop,sizeof(arg2)-1);
+		arg2[sizeof(arg2)-1] = '\0';
+		http_format(http,"%s",m++>0?", ":"");
+		http_json_string(http,prop);
+		http_format(http,": ");
+		if ( get_value_with_unit(obj,name,arg2,buffer,sizeof(buffer)) )
+			http_json_string(http,http_unquote(buffer));
+		else
+			http_format(http,"null");
+	}
+	http_format(http,"}}");
+}
+
+/** Read a property as doubles for a binary batch, converting to the unit given as \p prop[unit] if any
+	@returns the number of values stored in \p x (2 for complex properties)
+ **/
+static unsigned int batch_value(OBJECT *obj, char *prop, double x[2])
+{
+	PROPERTYSTRUCT pstruct;
+	PROPERTY *pp;
+	void *addr;
+	UNIT *unit = NULL;
+	char *uname = strchr(prop,'[');
+	x[0] = QNAN;
+	if ( uname!=NULL )
+	{
+		*uname++ = '\0';
+		uname[strcspn(uname,",]")] = '\0';
+		unit = unit_find(uname);
+		if ( unit==NULL )
+			return 1;
+	}
+	pp = object_get_property(obj,prop,&pstruct);
+	if ( pp==NULL )
+		return 1;
+	if ( unit!=NULL && pp->unit==NULL )
+		return 1;
+	if ( pstruct.part[0]!='\0' )
+	{
+		x[0] = property_get_part(obj,pp,pstruct.part);
+		if ( unit!=NULL && !unit_convert_ex(pp->unit,unit,&x[0]) )
+			x[0] = QNAN;
+		return 1;
+	}
+	addr = (char*)obj+sizeof(OBJECT)+(int64)(pp->addr);
+	switch ( pp->ptype ) {
+	case PT_double:
+		x[0] = *object_get_double_quick(obj,pp);
+		if ( unit!=NULL && !unit_convert_ex(pp->unit,unit,&x[0]) )
+			x[0] = QNAN;
+		return 1;
+	case PT_complex:
+		{
+			complex c = *object_get_complex_quick(obj,pp);
+			if ( unit!=NULL && !unit_convert_complex(pp->unit,unit,&c) )
+				c.r = c.i = QNAN;
+			x[0] = c.r;
+			x[1] = c.i;
+			return 2;
+		}
+	case PT_int16: x[0] = (double)*(int16*)addr; return 1;
+	case PT_int32: x[0] = (double)*(int32*)addr; return 1;
+	case PT_int64: x[0] = (double)*(int64*)addr; return 1;
+	case PT_enumeration: x[0] = (double)*(enumeration*)addr; return 1;
+	case PT_set: x[0] = (double)*(set*)addr; return 1;
+	case PT_bool: x[0] = *(bool*)addr ? 1.0 : 0.0; return 1;
+	case PT_timestamp: x[0] = (double)*(TIMESTAMP*)addr; return 1;
+	default:
+		return 1;
+	}
+}
+
+static void batch_binary(HTTPCNX *http, OBJECT *obj, char *name, char *props, unsigned int n)
+{
+	char list[4096], *p = list, *prop;
+	strncpy(list,props,sizeof(list)-1);
+	list[sizeof(list)-1] = '\0';
+	while ( (prop=batch_next_property(&p))!=NULL )
+	{
+		/* every value takes two doubles whatever the property turns out to be, so the layout depends only on the request */
+		double x[2] = {QNAN,QNAN};
+		if ( obj!=NULL && batch_value(obj,prop,x)==1 && !isnan(x[0]) )
+			x[1] = 0.0;
+		http_write(http,(char*)x,sizeof(x));
+	}
+}
+
+/** Process an incoming batch JSON request, e.g. /batch/house1/air_temperature;find=class=meter/measured_real_power[kW]
+
+	The response is an array with one entry per object reported, giving the
+	object name and a dictionary of the requested values (\p null for a
+	property that could not be read).
+	@returns non-zero on success, 0 on failure
+ **/
+int http_batch_request(HTTPCNX *http, char *list)
+{
+	http_format(http,"[");
+	http_batch(http,list,batch_json);
+	http_format(http,"\n]\n");
+	http_type(http,"text/json");
+	return 1;
+}
+
+/** Process an incoming batch binary request
+
+	Takes the same list as http_batch_request() but the response is a packed
+	array of native doubles, two per requested value in request order.  Complex
+	values send their real and imaginary parts, other numeric values send the
+	value and 0, and values that cannot be read or are not numeric (including
+	every value of an object that is not found) are sent as two NaNs.  A
+	\p find= item sends one such record per object found, or a single record
+	of NaNs when nothing matches.
+	@returns non-zero on success, 0 on failure
+ **/
+int http_batchbin_request(HTTPCNX *http, char *list)
+{
+	http_batch(http,list,batch_binary);
+	http_type(http,"application/octet-stream");
+	return 1;
+}
+
 /** Process an incoming GUI request
 	@returns non-zero on success, 0 on failure (errno set)
  **/
@@ -1748,14 +1977,15 @@ int http_favicon(HTTPCNX *http)
 	return http_copy(http,"icon",fullpath,false,0);
 }
 
-/** Process an incoming request
-	@returns nothing
+/** Process an incoming request held in the first \p len bytes of the connection's input buffer
+	@returns non-zero if the connection should be kept open for another request
  **/
-void *http_response(void *ptr)
+static int http_response(HTTPCNX *http, size_t hlen, size_t len)
 {
-	SOCKET fd = (SOCKET)ptr;
-	HTTPCNX *http = http_create(fd);
-	size_t len;
+	char *request = http->in;
+	char *body = http->in+hlen;
+	char next = http->in[len];
+	char *method, *uri, *version, *p;
 	int content_length = 0;
 	char *user_agent = NULL;
 	char *host = NULL;
@@ -1774,118 +2004,527 @@ void *http_response(void *ptr)
 		{"Connection", STRING, (void*)&connection, 0},
 		{"Accept", STRING, (void*)&accept, 0},
 	};
+	int v;
 
-	while ( (int)(len=recv_data(fd,http->query,sizeof(http->query)))>0 )
-	{
-		/* first term is always the request */
-		char *request = http->query;
-		char method[32];
-		char uri[1024];
-		char version[32];
-		char *p = strchr(http->query,'\r');
-		int v;
-		
-		/* initialize the response */
-		http_reset(http);
+	/* initialize the response */
+	http_reset(http);
 
-		/* read the request string */
-		if (sscanf(request,"%s %s %s",method,uri,version)!=3)
-		{
-			http_status(http,HTTP_BADREQUEST);
-			output_error("request [%s] is bad", request);
-			http_send(http);
-			break;
-		}
+	/* terminate the body and the header, the next request starts at in[len] */
+	http->in[len] = '\0';
+	http->in[hlen-2] = '\0';
+
+	/* read the request string */
+	p = strstr(request,"\r\n");
+	if ( p!=NULL )
+	{
+		*p = '\0';
+		p += 2;
+	}
+	http->query = request;
+	method = request;
+	uri = strchr(method,' ');
+	version = uri ? strchr(uri+1,' ') : NULL;
+	if ( version==NULL )
+	{
+		http_status(http,HTTP_BADREQUEST);
+		output_error("request [%s] is bad", request);
+		http_send(http);
+		return 0;
+	}
+	*uri++ = '\0';
+	*version++ = '\0';
 
-		/* read the rest of the header */
-		while (p!=NULL && (p=strchr(p,'\r'))!=NULL) 
+	/* read the rest of the header */
+	while ( p!=NULL && *p!='\0' )
+	{
+		char *eol = strstr(p,"\r\n");
+		if ( eol!=NULL )
+			*eol = '\0';
+		for ( v=0 ; v<sizeof(map)/sizeof(map[0]) ; v++ )
 		{
- 			*p = '\0';
-			p+=2;
-			for ( v=0 ; v<sizeof(map)/sizeof(map[0]) ; v++ )
+			if (map[v].sz==0) map[v].sz = strlen(map[v].name);
+			if (strnicmp(map[v].name,p,map[v].sz)==0 && strncmp(p+map[v].sz,": ",2)==0)
 			{
-				if (map[v].sz==0) map[v].sz = strlen(map[v].name);
-				if (strnicmp(map[v].name,p,map[v].sz)==0 && strncmp(p+map[v].sz,": ",2)==0)
-				{
-					if (map[v].type==INTEGER) { *(int*)(map[v].value) = atoi(p+map[v].sz+2); break; }
-					else if (map[v].type==STRING) { *(char**)map[v].value = p+map[v].sz+2; break; }
-				}
+				if (map[v].type==INTEGER) { *(int*)(map[v].value) = atoi(p+map[v].sz+2); break; }
+				else if (map[v].type==STRING) { *(char**)map[v].value = p+map[v].sz+2; break; }
 			}
 		}
-		IN_MYCONTEXT output_verbose("%s (host='%s', len=%d, keep-alive=%d)",http->query,host?host:"???",content_length, keep_alive);
+		p = eol ? eol+2 : NULL;
+	}
+	IN_MYCONTEXT output_verbose("%s %s %s (host='%s', len=%d, keep-alive=%d)",method,uri,version,host?host:"???",content_length, keep_alive);
+
+	/* HTTP/1.1 connections persist unless the client asks to close, HTTP/1.0 connections only if it asks to keep them */
+	if ( stricmp(version,"HTTP/1.1")==0 )
+		http->keep_alive = !(connection && stricmp(connection,"close")==0);
+	else
+		http->keep_alive = connection && stricmp(connection,"keep-alive")==0;
 
-		/* reject anything but a GET */
-		if (stricmp(method,"GET")!=0)
+	/* handle request */
+	if ( stricmp(method,"GET")==0 && strcmp(uri,"/favicon.ico")==0 )
+	{
+		if ( http_favicon(http) )
+			http_status(http,HTTP_OK);
+		else
+			http_status(http,HTTP_NOTFOUND);
+		http_send(http);
+	}
+	else {
+#define HR_POST 0x01 /* request may be posted, the body is used in place of the rest of the uri */
+#define HR_EXCLUSIVE 0x02 /* request uses shared state and is never run concurrently with another one */
+		static struct s_map {
+			char *path;
+			int (*request)(HTTPCNX*,char*);
+			char *success;
+			char *failure;
+			unsigned int flags;
+		} map[] = {
+			/* this is the map of recognize request types */
+			{"/control/",	http_control_request,	HTTP_ACCEPTED, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/open/",		http_open_request,		HTTP_ACCEPTED, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/raw/",		http_raw_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/xml/",		http_xml_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/gui/",		http_gui_request,		HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/output/",	http_output_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/action/",	http_action_request,	HTTP_ACCEPTED,HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/rt/",		http_get_rt,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/rb/",		http_get_rb,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/perl/",		http_run_perl,			HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/gnuplot/",	http_run_gnuplot,		HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/java/",		http_run_java,			HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/python/",	http_run_python,		HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/r/",			http_run_r,				HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/scilab/",	http_run_scilab,		HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/octave/",	http_run_octave,		HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/kml/", 		http_kml_request,		HTTP_OK, HTTP_NOTFOUND, HR_EXCLUSIVE},
+			{"/json/",		http_json_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/batch/",		http_batch_request,		HTTP_OK, HTTP_NOTFOUND, HR_POST},
+			{"/batchbin/",	http_batchbin_request,	HTTP_OK, HTTP_NOTFOUND, HR_POST},
+		};
+		static pthread_mutex_t exclusive = PTHREAD_MUTEX_INITIALIZER;
+		int n;
+		size_t plen = 0;
+		for ( n=0 ; n<sizeof(map)/sizeof(map[0]) ; n++ )
+		{
+			plen = strlen(map[n].path);
+			if ( strncmp(uri,map[n].path,plen)==0 )
+				break;
+		}
+		if ( n==sizeof(map)/sizeof(map[0]) )
+		{
+			output_error("request [%s %s %s]: '%s' is not a recognized request", method, uri, version, uri);
+			http_status(http,HTTP_NOTFOUND);
+			http_send(http);
+		}
+		else if ( stricmp(method,"GET")!=0 && !(stricmp(method,"POST")==0 && (map[n].flags&HR_POST)) )
 		{
 			http_status(http,HTTP_METHODNOTALLOWED);
 			/* technically, we should add an Allow entry to the response header */
 			output_error("request [%s %s %s]: '%s' is not an allowed method", method, uri, version, method);
 			http_send(http);
-			break;
 		}
-
-		/* handle request */
-		if ( strcmp(uri,"/favicon.ico")==0 )
+		else
 		{
-			if ( http_favicon(http) )
-				http_status(http,HTTP_OK);
-			else
-				http_status(http,HTTP_NOTFOUND);
+			char *arg = ( stricmp(method,"POST")==0 && *body!='\0' ) ? body : uri+plen;
+			int ok;
+			if ( map[n].flags&HR_EXCLUSIVE )
+				pthread_mutex_lock(&exclusive);
+			ok = map[n].request(http,arg);
+			if ( map[n].flags&HR_EXCLUSIVE )
+				pthread_mutex_unlock(&exclusive);
+
+			/* the request may have answered and closed the connection itself */
+			if ( http->closed )
+				return 0;
+			http_status(http,ok?map[n].success:map[n].failure);
 			http_send(http);
 		}
-		else {
-			static struct s_map {
-				char *path;
-				int (*request)(HTTPCNX*,char*);
-				char *success;
-				char *failure;
-			} map[] = {
-				/* this is the map of recognize request types */
-				{"/control/",	http_control_request,	HTTP_ACCEPTED, HTTP_NOTFOUND},
-				{"/open/",		http_open_request,		HTTP_ACCEPTED, HTTP_NOTFOUND},
-				{"/raw/",		http_raw_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/xml/",		http_xml_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/gui/",		http_gui_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/output/",	http_output_request,	HTTP_OK, HTTP_NOTFOUND},
-				{"/action/",	http_action_request,	HTTP_ACCEPTED,HTTP_NOTFOUND},
-				{"/rt/",		http_get_rt,			HTTP_OK, HTTP_NOTFOUND},
-				{"/rb/",		http_get_rb,			HTTP_OK, HTTP_NOTFOUND},
-				{"/perl/",		http_run_perl,			HTTP_OK, HTTP_NOTFOUND},
-				{"/gnuplot/",	http_run_gnuplot,		HTTP_OK, HTTP_NOTFOUND},
-				{"/java/",		http_run_java,			HTTP_OK, HTTP_NOTFOUND},
-				{"/python/",	http_run_python,		HTTP_OK, HTTP_NOTFOUND},
-				{"/r/",			http_run_r,				HTTP_OK, HTTP_NOTFOUND},
-				{"/scilab/",	http_run_scilab,		HTTP_OK, HTTP_NOTFOUND},
-				{"/octave/",	http_run_octave,		HTTP_OK, HTTP_NOTFOUND},
-				{"/kml/", 		http_kml_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/json/",		http_json_request,		HTTP_OK, HTTP_NOTFOUND},
-			};
-			int n;
-			for ( n=0 ; n<sizeof(map)/sizeof(map[0]) ; n++ )
-			{
-				size_t len = strlen(map[n].path);
-				if (strncmp(uri,map[n].path,len)==0)
-				{
-					if ( map[n].request(http,uri+len) )
-						http_status(http,map[n].success);
-					else
-						http_status(http,map[n].failure);
-					http_send(http);
+	}
+	http->in[len] = next;
+	return http->keep_alive;
+}
 
-					/* keep-alive not desired*/
-					if (connection && stricmp(connection,"close")==0)
-						break;
-					else
-						continue;
-				}
+/********************************************************
+ Connection handling
+
+ The server thread runs an event loop that accepts connections and
+ watches the idle ones with poll().  When data arrives on a connection it
+ is handed to one of global_server_threads workers, which answers every
+ complete request received so far (clients may pipeline requests) and
+ then gives the connection back to the event loop, unless it is closed.
+ Workers wake the event loop through a pipe so that the next request on a
+ kept-alive connection is picked up right away.
+ */
+
+#define HTTP_MAXREQUEST (1<<20) /**< largest request (header and body) accepted */
+
+static pthread_mutex_t server_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t server_work = PTHREAD_COND_INITIALIZER; /* connections are waiting for a worker */
+static HTTPCNX *work_first = NULL, *work_last = NULL; /* connections waiting for a worker */
+static HTTPCNX *returned = NULL; /* connections given back to the event loop by the workers */
+#ifdef WIN32
+#define SERVER_POLLTIME 10 /* WSAPoll() cannot watch a pipe, so look for returned connections often */
+#else
+#define SERVER_POLLTIME -1
+static int wakeup[2] = {-1,-1}; /* pipe used to wake the event loop */
+#endif
+
+/** Wake the event loop so it looks at the returned connections **/
+static void server_wakeup(void)
+{
+#ifndef WIN32
+	if ( wakeup[1]>=0 && write(wakeup[1],"",1)<0 )
+		IN_MYCONTEXT output_debug("server wakeup failed: %s", strerror(errno));
+#endif
+}
+
+/** Queue a connection for a worker **/
+static void server_queue(HTTPCNX *http)
+{
+	pthread_mutex_lock(&server_lock);
+	http->next = NULL;
+	if ( work_last!=NULL )
+		work_last->next = http;
+	else
+		work_first = http;
+	work_last = http;
+	pthread_cond_signal(&server_work);
+	pthread_mutex_unlock(&server_lock);
+}
+
+/** Receive whatever the client has sent into the connection's input buffer
+	@returns the number of bytes received, 0 if the connection was closed, failed, or the request is too large
+ **/
+static size_t http_receive(HTTPCNX *http)
+{
+	size_t len;
+	if ( http->in_max-http->in_len<1024 )
+	{
+		size_t max = http->in_max>0 ? http->in_max*2 : 8192;
+		char *more;
+		if ( http->in_len>=HTTP_MAXREQUEST )
+			return 0;
+		more = (char*)realloc(http->in,max);
+		if ( more==NULL )
+			return 0;
+		http->in = more;
+		http->in_max = max;
+	}
+	len = recv_data(http->s,http->in+http->in_len,http->in_max-http->in_len-1);
+	if ( (int)len<=0 )
+		return 0;
+	http->in_len += len;
+	http->in[http->in_len] = '\0';
+	return len;
+}
+
+/** Check whether a complete request has been received
+	@returns the length of the first request in the input buffer, or 0 if it is not complete or cannot be accepted (\p error is set)
+ **/
+static size_t http_complete(HTTPCNX *http, size_t *hlen, char **error)
+{
+	char *eoh, *p;
+	size_t content_length = 0;
+	int has_length = 0;
+	*error = NULL;
+	if ( http->in_len==0 )
+		return 0;
+	http->in[http->in_len] = '\0';
+	eoh = strstr(http->in,"\r\n\r\n");
+	if ( eoh==NULL )
+		return 0;
+	*hlen = eoh+4-http->in;
+	for ( p=strstr(http->in,"\r\n") ; p!=NULL && p<eoh ; p=strstr(p+2,"\r\n") )
+	{
+		if ( strnicmp(p+2,"Content-Length:",15)==0 )
+		{
+			char *value = p+17, *end;
+			unsigned long len;
+			while ( *value==' ' || *value=='\t' )
+				value++;
+			errno = 0;
+			len = strtoul(value,&end,10);
+			while ( *end==' ' || *end=='\t' )
+				end++;
+			if ( *value<'0' || *value>'9' || end[0]!='\r' || end[1]!='\n' || ( has_length && len!=content_length ) )
+			{
+				/* not a plain decimal number, or conflicting with an earlier Content-Length */
+				*error = HTTP_BADREQUEST;
+				return 0;
 			}
-			break;
+			if ( errno==ERANGE || len>HTTP_MAXREQUEST || *hlen+len>HTTP_MAXREQUEST )
+			{
+				*error = HTTP_REQUESTENTITYTOOLARGE;
+				return 0;
+			}
+			content_length = (size_t)len;
+			has_length = 1;
 		}
-		break;
 	}
+	return *hlen+content_length<=http->in_len ? *hlen+content_length : 0;
+}
+
+/** Answer every complete request waiting on a connection
+	@returns non-zero if the connection should be watched for more requests, 0 if it was closed
+ **/
+static int http_service(HTTPCNX *http)
+{
+	size_t len, hlen;
+	char *error = NULL;
+	int keep = 1;
+	if ( http_receive(http)==0 )
+	{
+		if ( http->in_len>=HTTP_MAXREQUEST )
+		{
+			http->keep_alive = false;
+			http_status(http,HTTP_REQUESTENTITYTOOLARGE);
+			http_send(http);
+		}
+		keep = 0;
+	}
+	while ( keep && (len=http_complete(http,&hlen,&error))>0 )
+	{
+		keep = http_response(http,hlen,len);
+		if ( http->closed )
+			return 0;
+		memmove(http->in,http->in+len,http->in_len-len);
+		http->in_len -= len;
+	}
+	if ( keep && error!=NULL )
+	{
+		/* the body length cannot be trusted so the connection cannot be resynchronized */
+		IN_MYCONTEXT output_verbose("socket %d request rejected (%s)",http->s,error);
+		http->keep_alive = false;
+		http_status(http,error);
+		http_send(http);
+		keep = 0;
+	}
+	if ( keep && !shutdown_server )
+		return 1;
 	http_close(http);
 	IN_MYCONTEXT output_verbose("socket %d closed",http->s);
 	return 0;
 }
 
+/** Server worker thread **/
+static void *server_worker(void *arg)
+{
+	for (;;)
+	{
+		HTTPCNX *http;
+		pthread_mutex_lock(&server_lock);
+		while ( work_first==NULL )
+			pthread_cond_wait(&server_work,&server_lock);
+		http = work_first;
+		work_first = http->next;
+		if ( work_first==NULL )
+			work_last = NULL;
+		pthread_mutex_unlock(&server_lock);
+
+		if ( http_service(http) )
+		{
+			pthread_mutex_lock(&server_lock);
+			http->next = returned;
+			returned = http;
+			pthread_mutex_unlock(&server_lock);
+			server_wakeup();
+		}
+		else
+			http_free(http);
+	}
+	return NULL;
+}
+
+/** Add a connection to the event loop's list of idle connections
+	@returns non-zero on success, 0 if the list could not be extended
+ **/
+static int server_watch(HTTPCNX ***watch, struct pollfd **fds, unsigned int *n_watch, unsigned int *max_watch, HTTPCNX *http)
+{
+	if ( *n_watch==*max_watch )
+	{
+		unsigned int max = *max_watch>0 ? *max_watch*2 : 64;
+		HTTPCNX **more = (HTTPCNX**)realloc(*watch,sizeof(HTTPCNX*)*max);
+		struct pollfd *morefds;
+		if ( more==NULL )
+			return 0;
+		*watch = more;
+		morefds = (struct pollfd*)realloc(*fds,sizeof(struct pollfd)*(max+2));
+		if ( morefds==NULL )
+			return 0;
+		*fds = morefds;
+		*max_watch = max;
+	}
+	(*watch)[(*n_watch)++] = http;
+	return 1;
+}
+
+/** Main server event loop
+    @returns a pointer to the status flag
+ **/
+static void *server_routine(void *arg)
+{
+	static int status = 0;
+	static int started = 0;
+	static int n_workers = 0;
+	HTTPCNX **watch = NULL; /* idle connections */
+	struct pollfd *fds = NULL;
+	unsigned int n_watch = 0, max_watch = 0, n_fixed, n, m;
+	if (started)
+	{
+		output_error("server routine is already running");
+		return NULL;
+	}
+	started = 1;
+	sockfd = (SOCKET)arg;
 
+	/* start the workers */
+#ifndef WIN32
+	if ( wakeup[0]<0 && pipe(wakeup)!=0 )
+	{
+		status = GetLastError();
+		output_error("unable to create server wakeup pipe: %s", strerror(status));
+		goto Done;
+	}
+#endif
+	for ( ; n_workers<(global_server_threads>0?global_server_threads:1) ; n_workers++ )
+	{
+		pthread_t worker;
+		if ( pthread_create(&worker,NULL,server_worker,NULL)!=0 )
+		{
+			status = GetLastError();
+			output_error("unable to start http response thread");
+			goto Done;
+		}
+		pthread_detach(worker);
+	}
+
+	while (!shutdown_server)
+	{
+		HTTPCNX *http;
+
+		/* take back the connections the workers are done with */
+		pthread_mutex_lock(&server_lock);
+		while ( (http=returned)!=NULL )
+		{
+			returned = http->next;
+			if ( !server_watch(&watch,&fds,&n_watch,&max_watch,http) )
+			{
+				output_error("server connection table allocation failed");
+				http_close(http);
+				http_free(http);
+			}
+		}
+		pthread_mutex_unlock(&server_lock);
+		if ( fds==NULL && (fds=(struct pollfd*)malloc(sizeof(struct pollfd)*2))==NULL )
+		{
+			output_error("server connection table allocation failed");
+			status = ENOMEM;
+			goto Done;
+		}
+
+		/* wait for a new connection or a request on an idle one */
+		n_fixed = 0;
+		fds[n_fixed].fd = sockfd;
+		fds[n_fixed++].events = POLLIN;
+#ifndef WIN32
+		fds[n_fixed].fd = wakeup[0];
+		fds[n_fixed++].events = POLLIN;
+#endif
+		for ( n=0 ; n<n_watch ; n++ )
+		{
+			fds[n_fixed+n].fd = watch[n]->s;
+			fds[n_fixed+n].events = POLLIN;
+		}
+		if ( poll(fds,n_fixed+n_watch,SERVER_POLLTIME)<0 )
+		{
+			if ( errno==EINTR )
+				continue;
+			status = GetLastError();
+			output_error("server poll error on fd=%d: code %d", sockfd, status);
+			goto Done;
+		}
+		if ( shutdown_server )
+			break;
+
+		/* hand the connections with requests waiting to the workers */
+		for ( n=m=0 ; n<n_watch ; n++ )
+		{
+			if ( fds[n_fixed+n].revents!=0 )
+				server_queue(watch[n]);
+			else
+				watch[m++] = watch[n];
+		}
+		n_watch = m;
+#ifndef WIN32
+		if ( fds[1].revents&POLLIN )
+		{
+			char buffer[256];
+			if ( read(wakeup[0],buffer,sizeof(buffer))<0 )
+				IN_MYCONTEXT output_debug("server wakeup read failed: %s", strerror(errno));
+		}
+#endif
+
+		/* accept client request and get client address */
+		if ( fds[0].revents!=0 )
+		{
+			struct sockaddr_in cli_addr;
+			SOCKET newsockfd;
+			int clilen = sizeof(cli_addr);
+			int enable = 1;
+			newsockfd = accept(sockfd,(struct sockaddr *)&cli_addr,&clilen);
+			if ((int)newsockfd<0 && errno!=EINTR)
+			{
+				status = GetLastError();
+				output_error("server accept error on fd=%d: code %d", sockfd, status);
+				goto Done;
+			}
+			else if ((int)newsockfd > 0)
+			{
+				char *saddr = inet_ntoa(cli_addr.sin_addr);
+				if ( !client_allowed(saddr) )
+				{
+					output_error("denying connection from %s on port %d",saddr, cli_addr.sin_port);
+					close(newsockfd);
+					continue;
+				}
+				IN_MYCONTEXT output_verbose("accepting connection from %s on port %d",saddr, cli_addr.sin_port);
+				/* responses are sent whole, so don't hold them back waiting for acks */
+				setsockopt(newsockfd,IPPROTO_TCP,TCP_NODELAY,(char*)&enable,sizeof(enable));
+				http = http_create(newsockfd);
+				if ( http==NULL )
+				{
+					output_error("unable to create http connection handle");
+					close(newsockfd);
+					continue;
+				}
+				if (global_server_quit_on_close)
+				{
+					/* the event loop stops now, so the worker waits for the request itself */
+					server_queue(http);
+					shutdown_now();
+				}
+				else
+				{
+					gui_wait_status(0);
+					if ( !server_watch(&watch,&fds,&n_watch,&max_watch,http) )
+					{
+						output_error("server connection table allocation failed");
+						http_close(http);
+						http_free(http);
+					}
+				}
+			}
+		}
+	}
+	IN_MYCONTEXT output_verbose("server shutdown");
+Done:
+	/* close the idle connections, busy ones are closed by their worker */
+	for ( n=0 ; n<n_watch ; n++ )
+	{
+		http_close(watch[n]);
+		http_free(watch[n]);
+	}
+	free(watch);
+	free(fds);
+	started = 0;
+	return (void*)&status;
+}
@@ -312,3 +312,201 @@ int mti_run(MTIDATA result, MTI *mti, MTIDATA input)
 	mti->runtime += (clock_t)exec_clock() - t0;
 	return 1;
 }
+
+/************************************************************************************** 
+   Persistent worker pool
+
+   The pool threads are shared by all the internal list synchronizations
+   (schedules, loadshapes, enduses, random variables).  A run is started by
+   incrementing the run counter; idle threads poll it for a short while
+   before sleeping on the start condition, so runs that follow one another
+   closely, as they do in syncall_internals(), do not pay for a wake-up.
+   Every pool thread takes part in every run, even when its slice is empty,
+   so no thread can fall behind by a run.
+ **************************************************************************************/
+#if defined(__APPLE__)
+	#include <libkern/OSAtomic.h>
+	#define atomic_decrement(ptr) OSAtomicDecrement32Barrier((volatile int32_t *) ptr)
+	#define memory_barrier() OSMemoryBarrier()
+#elif defined(WIN32) && !defined __MINGW32__
+	#include <intrin.h>
+	#pragma intrinsic(_InterlockedDecrement)
+	#define atomic_decrement(ptr) _InterlockedDecrement((volatile long *) ptr)
+	#define memory_barrier() MemoryBarrier()
+#elif defined HAVE___SYNC_ADD_AND_FETCH
+	#define atomic_decrement(ptr) __sync_sub_and_fetch(ptr, 1)
+	#define memory_barrier() __sync_synchronize()
+#else
+	#error "Atomic operations are not supported on this system"
+#endif
+
+#if defined(WIN32) && !defined __MINGW32__
+	#define pool_pause() YieldProcessor()
+#elif defined(__i386__) || defined(__x86_64__)
+	#define pool_pause() __asm__ __volatile__("pause")
+#else
+	#define pool_pause()
+#endif
+
+#include <sched.h>
+
+#define POOL_SPIN 10000 /**< number of polls before an idle pool thread sleeps */
+
+typedef struct s_poolslot {
+	TIMESTAMP t2;	/**< result of the slice */
+	char pad[64-sizeof(TIMESTAMP)]; /**< keep each slot on its own cache line */
+} POOLSLOT;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static unsigned int pool_threads = 0; /* number of pool threads, not counting the caller */
+static int pool_failed = 0;
+static volatile unsigned int pool_run = 0; /* incremented to start a run */
+static volatile long pool_remaining = 0; /* pool threads still working on the run */
+static unsigned int pool_sleeping = 0; /* pool threads waiting on pool_start */
+static POOLSLOT *pool_slot = NULL;
+static POOLCALLFN pool_call = NULL;
+static void *pool_arg = NULL;
+static unsigned int pool_items = 0;
+static unsigned int pool_slices = 0;
+
+static TIMESTAMP pool_slice(unsigned int n)
+{
+	unsigned int first, last;
+	if ( n>=pool_slices )
+		return TS_NEVER;
+	first = (unsigned int)((unsigned long long)pool_items*n/pool_slices);
+	last = (unsigned int)((unsigned long long)pool_items*(n+1)/pool_slices);
+	return first<last ? pool_call(pool_arg,first,last) : TS_NEVER;
+}
+
+static void *pool_proc(void *ptr)
+{
+	unsigned int id = (unsigned int)(size_t)ptr;
+	unsigned int seen = 0;
+	for (;;)
+	{
+		unsigned int spin;
+
+		/* wait for the next run */
+		for ( spin=0 ; pool_run==seen && spin<POOL_SPIN ; spin++ )
+			pool_pause();
+		if ( pool_run==seen )
+		{
+			pthread_mutex_lock(&pool_lock);
+			pool_sleeping++;
+			while ( pool_run==seen )
+				pthread_cond_wait(&pool_start,&pool_lock);
+			pool_sleeping--;
+			pthread_mutex_unlock(&pool_lock);
+		}
+		memory_barrier();
+		seen = pool_run;
+
+		/* process this thread's slice */
+		pool_slot[id].t2 = pool_slice(id);
+		atomic_decrement(&pool_remaining);
+	}
+	return NULL;
+}
+
+/* create the pool threads the first time they are needed */
+static int pool_init(void)
+{
+	unsigned int n, n_threads = global_threadcount;
+	if ( pool_threads>0 )
+		return 1;
+
+	/* spinning threads must not compete for cores */
+	if ( n_threads>(unsigned int)processor_count() )
+		n_threads = (unsigned int)processor_count();
+	if ( pool_failed || n_threads<2 )
+	{
+		pool_failed = 1;
+		return 0;
+	}
+	pool_slot = (POOLSLOT*)malloc(sizeof(POOLSLOT)*n_threads);
+	if ( pool_slot==NULL )
+	{
+		output_error("threadpool_run memory allocation failed");
+		/* TROUBLESHOOT
+		   Memory allocation failed while creating the worker pool.
+		   The internal synchronization will run single threaded.
+		   Free up memory and try again.
+		 */
+		pool_failed = 1;
+		return 0;
+	}
+	for ( n=1 ; n<n_threads ; n++ )
+	{
+		pthread_t pt;
+		if ( pthread_create(&pt,NULL,pool_proc,(void*)(size_t)n)!=0 )
+		{
+			output_error("threadpool_run thread creation failed");
+			/* TROUBLESHOOT
+			   A worker pool thread could not be created.  The internal
+			   synchronization will use fewer threads.  Reduce the
+			   value of the threadcount global variable and try again.
+			 */
+			break;
+		}
+		pthread_detach(pt);
+		pool_threads++;
+	}
+	if ( pool_threads==0 )
+	{
+		pool_failed = 1;
+		return 0;
+	}
+	return 1;
+}
+
+TIMESTAMP threadpool_run(POOLCALLFN call, void *arg, unsigned int n_items, unsigned int minitems)
+{
+	unsigned int n, n_slices, spin;
+	TIMESTAMP t2;
+
+	/* determine the number of slices needed */
+	if ( minitems==0 )
+		minitems = 1;
+	n_slices = n_items/minitems;
+	if ( n_slices>global_threadcount )
+		n_slices = global_threadcount;
+	if ( n_slices<2 || !pool_init() )
+		return n_items>0 ? call(arg,0,n_items) : TS_NEVER;
+	if ( n_slices>pool_threads+1 )
+		n_slices = pool_threads+1;
+
+	/* post the run */
+	pool_call = call;
+	pool_arg = arg;
+	pool_items = n_items;
+	pool_slices = n_slices;
+	pool_remaining = pool_threads;
+	memory_barrier();
+	pool_run++;
+	memory_barrier();
+	pthread_mutex_lock(&pool_lock);
+	if ( pool_sleeping>0 )
+		pthread_cond_broadcast(&pool_start);
+	pthread_mutex_unlock(&pool_lock);
+
+	/* the caller takes the first slice */
+	t2 = pool_slice(0);
+
+	/* wait for the pool threads to finish */
+	for ( spin=0 ; pool_remaining>0 ; spin++ )
+	{
+		if ( spin<POOL_SPIN )
+			pool_pause();
+		else
+			sched_yield();
+	}
+	memory_barrier();
+	for ( n=1 ; n<n_slices ; n++ )
+	{
+		if ( pool_slot[n].t2<t2 )
+			t2 = pool_slot[n].t2;
+	}
+	return t2;
+}
@@ -38,6 +38,10 @@ instead.
 
 An example of how this is done is implemented in exec.c for commit_all().
 
+The core's internal synchronization of schedules, loadshapes, enduses and
+random variables does not use MTIs.  Those lists are processed in slices
+on a single persistent worker pool using #threadpool_run().
+
 @{**/
 
 #ifndef _THREADPOOL_H
@@ -158,6 +162,31 @@ int mti_run(MTIDATA result,   /**< result of iterator */
             MTIDATA input);   /**< data to send to iterator call function */
 
 int processor_count(void);
+
+/** Worker pool slice call
+
+    Processes the items \p first through \p last-1 of a list.
+
+    @returns the earliest time at which any of the items needs to be processed again
+ **/
+typedef TIMESTAMP (*POOLCALLFN)(void *arg, unsigned int first, unsigned int last);
+
+/** Worker pool run
+
+    Call this function to process \p n_items items on the core's persistent
+    worker pool.  The items are split into contiguous slices of at least
+    \p minitems items, one per thread, and the calling thread processes the
+    first slice itself.  The pool threads are created the first time they are
+    needed (\p global_threadcount less one) and spin briefly between runs so
+    back-to-back runs do not have to wake sleeping threads.
+
+    @returns the earliest time returned by any of the slices
+ **/
+TIMESTAMP threadpool_run(POOLCALLFN call, /**< slice processing call */
+                         void *arg,       /**< data passed to each call */
+                         unsigned int n_items, /**< number of items to process */
+                         unsigned int minitems); /**< minimum number of items per thread */
+
 #ifdef __cplusplus
 }
 #endif
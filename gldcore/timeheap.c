@@ -0,0 +1,119 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file timeheap.c
+	@addtogroup timeheap Time-ordered event heap
+	@ingroup core
+
+	A time heap holds items (schedules, loadshapes) keyed on the next time
+	each one needs to be synchronized.  Each pass takes only the items that
+	are due with timeheap_due(), lets the caller synchronize them and write
+	their new next times back into the due list, and then puts them back
+	with timeheap_requeue().  Items that never change again stay at the
+	bottom of the heap and are never touched.
+ @{
+ **/
+
+#include <stdlib.h>
+#include "timeheap.h"
+
+static int timeheap_grow(TIMEHEAPENTRY **list, unsigned int *size, unsigned int need)
+{
+	TIMEHEAPENTRY *more;
+	unsigned int n = *size>0 ? *size : 64;
+	while ( n<need )
+		n *= 2;
+	more = (TIMEHEAPENTRY*)realloc(*list,sizeof(TIMEHEAPENTRY)*n);
+	if ( more==NULL )
+		return 0;
+	*list = more;
+	*size = n;
+	return 1;
+}
+
+/** add an item to the heap
+	@return 1 on success, 0 if memory could not be allocated
+ **/
+int timeheap_push(TIMEHEAP *heap, TIMESTAMP t, void *item)
+{
+	unsigned int i = heap->n;
+	if ( i==heap->size && !timeheap_grow(&heap->entry,&heap->size,i+1) )
+		return 0;
+
+	/* sift up */
+	while ( i>0 )
+	{
+		unsigned int parent = (i-1)/2;
+		if ( heap->entry[parent].t<=t )
+			break;
+		heap->entry[i] = heap->entry[parent];
+		i = parent;
+	}
+	heap->entry[i].t = t;
+	heap->entry[i].item = item;
+	heap->n++;
+	return 1;
+}
+
+/** get the time at which the next item is due
+	@return the earliest time in the heap, or TS_NEVER if it is empty
+ **/
+TIMESTAMP timeheap_next(TIMEHEAP *heap)
+{
+	return heap->n>0 ? heap->entry[0].t : TS_NEVER;
+}
+
+static void timeheap_pop(TIMEHEAP *heap, TIMEHEAPENTRY *top)
+{
+	TIMEHEAPENTRY last;
+	unsigned int i = 0;
+	*top = heap->entry[0];
+	last = heap->entry[--heap->n];
+
+	/* sift down */
+	for (;;)
+	{
+		unsigned int child = 2*i+1;
+		if ( child>=heap->n )
+			break;
+		if ( child+1<heap->n && heap->entry[child+1].t<heap->entry[child].t )
+			child++;
+		if ( last.t<=heap->entry[child].t )
+			break;
+		heap->entry[i] = heap->entry[child];
+		i = child;
+	}
+	if ( heap->n>0 )
+		heap->entry[i] = last;
+}
+
+/** take all the items due at or before \p t out of the heap and place them in \p heap->due
+	@return the number of items taken; items that do not fit in memory are left in the heap
+ **/
+unsigned int timeheap_due(TIMEHEAP *heap, TIMESTAMP t)
+{
+	heap->ndue = 0;
+	while ( heap->n>0 && heap->entry[0].t<=t )
+	{
+		if ( heap->ndue==heap->maxdue && !timeheap_grow(&heap->due,&heap->maxdue,heap->ndue+1) )
+			break;
+		timeheap_pop(heap,&heap->due[heap->ndue++]);
+	}
+	return heap->ndue;
+}
+
+/** put the items taken by the last timeheap_due() back into the heap using their updated times
+	@return 1 on success, 0 if memory could not be allocated
+ **/
+int timeheap_requeue(TIMEHEAP *heap)
+{
+	unsigned int n;
+	for ( n=0 ; n<heap->ndue ; n++ )
+	{
+		if ( !timeheap_push(heap,heap->due[n].t,heap->due[n].item) )
+			return 0;
+	}
+	heap->ndue = 0;
+	return 1;
+}
+
+/**@}*/
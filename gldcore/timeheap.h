@@ -0,0 +1,35 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file timeheap.h
+	@addtogroup timeheap
+	@ingroup core
+@{
+ **/
+
+#ifndef _TIMEHEAP_H
+#define _TIMEHEAP_H
+
+#include "timestamp.h"
+
+typedef struct s_timeheapentry {
+	TIMESTAMP t;	/**< the time at which the item is next due */
+	void *item;
+} TIMEHEAPENTRY;
+
+typedef struct s_timeheap {
+	unsigned int n;			/**< number of items waiting in the heap */
+	unsigned int size;		/**< capacity of the heap */
+	TIMEHEAPENTRY *entry;	/**< min-heap ordered on \p t */
+	unsigned int ndue;		/**< number of items taken by the last timeheap_due() */
+	unsigned int maxdue;	/**< capacity of the due list */
+	TIMEHEAPENTRY *due;		/**< items taken by the last timeheap_due() */
+} TIMEHEAP;
+
+int timeheap_push(TIMEHEAP *heap, TIMESTAMP t, void *item);
+TIMESTAMP timeheap_next(TIMEHEAP *heap);
+unsigned int timeheap_due(TIMEHEAP *heap, TIMESTAMP t);
+int timeheap_requeue(TIMEHEAP *heap);
+
+#endif
+
+/**@}*/
@@ -17,10 +17,13 @@
 #include "exception.h"
 #include "module.h"
 #include "exec.h"
+#include "threadpool.h"
+#include "timeheap.h"
 
 SET_MYCONTEXT(DMC_TRANSFORM)
 
 static TRANSFORM *schedule_xformlist=NULL;
+static unsigned int n_xforms = 0; /* number of transforms in schedule_xformlist */
 
 /****************************************************************
  * GridLAB-D Variable Handling for transform functions
@@ -206,6 +209,7 @@ int get_source_type(PROPERTY *prop)
 			prop->name,property_getspec(prop->ptype)->name);
 		break;
 	}
+	return source_type;
 }
 int transform_add_filter(OBJECT *target_obj,		/* pointer to the target object (lhs) */
 						 PROPERTY *target_prop,	/* pointer to the target property */
@@ -255,6 +259,7 @@ int transform_add_filter(OBJECT *target_obj,		/* pointer to the target object (l
 	xform->t2 = (int64)(global_starttime/tf->timestep)*tf->timestep + tf->timeskew;
 	xform->next = schedule_xformlist;
 	schedule_xformlist = xform;
+	n_xforms++;
 
 	if ( global_debug_output )
 	{
@@ -304,6 +309,7 @@ int transform_add_external(	OBJECT *target_obj,		/* pointer to the target object
 
 	xform->next = schedule_xformlist;
 	schedule_xformlist = xform;
+	n_xforms++;
 	IN_MYCONTEXT output_debug("added external transform %s:%s <- %s(%s:%s)", object_name(target_obj,buffer1,sizeof(buffer1)),target_prop->name,function, object_name(source_obj,buffer2,sizeof(buffer2)),source_prop->name);
 	return 1;
 }
@@ -334,6 +340,7 @@ int transform_add_linear(	TRANSFORMSOURCE stype,	/* specifies the type of source
 	xform->function_type = XT_LINEAR;
 	xform->next = schedule_xformlist;
 	schedule_xformlist = xform;
+	n_xforms++;
 	IN_MYCONTEXT output_debug("added linear transform %s:%s <- scale=%.3g, bias=%.3g", object_name(obj,buffer,sizeof(buffer)), prop->name, scale, bias);
 	return 1;
 }
@@ -431,38 +438,288 @@ TIMESTAMP transform_apply(TIMESTAMP t1, TRANSFORM *xform, double *source)
 	return t2;
 }
 
+/****************************************************************
+ * Transform synchronization
+ *
+ * The transform list is compiled into levels before it is first
+ * synchronized.  A transform is placed in the level after the last
+ * earlier transform (in list order) that writes its source, or that
+ * reads or writes its target, so the transforms in a level do not
+ * depend on each other and the levels give the same result as running
+ * the list in order.  Within a level the linear transforms are sorted
+ * so those reading the same skewed schedule are together and the
+ * schedule is only read once, and they are run in parallel slices.
+ * External transforms are run in order by the calling thread, and
+ * filters wait in a heap until their next sample time.
+ ****************************************************************/
+
+#define XS_NTYPES 6 /* number of source type bits */
+
+typedef struct s_transformlevel {
+	TRANSFORM **linear; ///< linear transforms, grouped by skewed schedule
+	unsigned int n_linear; ///< number of linear transforms
+	TRANSFORM **external; ///< external transforms, in list order
+	unsigned int n_external; ///< number of external transforms
+	TIMEHEAP filter[XS_NTYPES]; ///< filters by source type, keyed on their next sample time
+} TRANSFORMLEVEL;
+
+static TRANSFORMLEVEL *xform_level = NULL;
+static unsigned int n_levels = 0;
+static unsigned int n_compiled = 0; /* n_xforms when the levels were compiled */
+
+typedef struct s_xformaccess {
+	void *addr;
+	unsigned int read; ///< last level reading the address
+	unsigned int write; ///< last level writing the address
+} XFORMACCESS;
+
+static XFORMACCESS *find_access(XFORMACCESS *table, unsigned int mask, void *addr)
+{
+	static XFORMACCESS unknown;
+	unsigned int h = (unsigned int)(((size_t)addr>>3)*2654435761u) & mask;
+	if ( addr==NULL )
+	{
+		/* unbound variables do not order anything */
+		memset(&unknown,0,sizeof(unknown));
+		return &unknown;
+	}
+	while ( table[h].addr!=NULL && table[h].addr!=addr )
+		h = (h+1)&mask;
+	table[h].addr = addr;
+	return &table[h];
+}
+
+static void *transform_source(TRANSFORM *xform)
+{
+	return xform->function_type==XT_EXTERNAL ? gldvar_getaddr(xform->prhs,0) : xform->source;
+}
+
+static void *transform_target(TRANSFORM *xform)
+{
+	switch ( xform->function_type ) {
+	case XT_LINEAR: return xform->target;
+	case XT_EXTERNAL: return gldvar_getaddr(xform->plhs,0);
+	case XT_FILTER: return xform->y;
+	default: return NULL;
+	}
+}
+
+/* skewed schedule transforms sort by schedule and skew, all others sort first */
+static SCHEDULE *transform_skewed(TRANSFORM *xform)
+{
+	return ( xform->source_type==XS_SCHEDULE && xform->target_obj->schedule_skew!=0 ) ? xform->source_schedule : NULL;
+}
+static int compare_linear(const void *a, const void *b)
+{
+	TRANSFORM *xa = *(TRANSFORM**)a, *xb = *(TRANSFORM**)b;
+	SCHEDULE *sa = transform_skewed(xa), *sb = transform_skewed(xb);
+	if ( sa!=sb ) return sa<sb ? -1 : 1;
+	if ( sa==NULL ) return 0;
+	if ( xa->target_obj->schedule_skew!=xb->target_obj->schedule_skew )
+		return xa->target_obj->schedule_skew<xb->target_obj->schedule_skew ? -1 : 1;
+	return 0;
+}
+
+static void transform_release(void)
+{
+	unsigned int n, k;
+	for ( n=0 ; n<n_levels ; n++ )
+	{
+		free(xform_level[n].linear);
+		free(xform_level[n].external);
+		for ( k=0 ; k<XS_NTYPES ; k++ )
+		{
+			free(xform_level[n].filter[k].entry);
+			free(xform_level[n].filter[k].due);
+		}
+	}
+	free(xform_level);
+	xform_level = NULL;
+	n_levels = 0;
+}
+
+/* compile the transform list into levels
+   @return 1 on success, 0 on failure
+ */
+static int transform_compile(void)
+{
+	unsigned int mask, n, *level = NULL;
+	XFORMACCESS *table = NULL;
+	TRANSFORM *xform;
+	int ok = 0;
+
+	transform_release();
+	n_compiled = n_xforms;
+	if ( n_xforms==0 )
+		return 1;
+
+	/* find the level of each transform */
+	for ( mask=1 ; mask<4*n_xforms ; mask<<=1 ) {}
+	table = (XFORMACCESS*)calloc(mask,sizeof(XFORMACCESS));
+	level = (unsigned int*)malloc(sizeof(unsigned int)*n_xforms);
+	if ( table==NULL || level==NULL )
+		goto Done;
+	mask--;
+	for ( n=0, xform=schedule_xformlist ; xform!=NULL ; n++, xform=xform->next )
+	{
+		XFORMACCESS *source = find_access(table,mask,transform_source(xform));
+		XFORMACCESS *target = find_access(table,mask,transform_target(xform));
+		unsigned int after = source->write;
+		if ( target->write>after ) after = target->write;
+		if ( target->read>after ) after = target->read;
+		level[n] = after+1;
+		if ( source->read<level[n] ) source->read = level[n];
+		target->write = level[n];
+		if ( level[n]>n_levels ) n_levels = level[n];
+	}
+
+	/* fill the levels */
+	xform_level = (TRANSFORMLEVEL*)calloc(n_levels,sizeof(TRANSFORMLEVEL));
+	if ( xform_level==NULL )
+	{
+		n_levels = 0;
+		goto Done;
+	}
+	for ( n=0, xform=schedule_xformlist ; xform!=NULL ; n++, xform=xform->next )
+	{
+		TRANSFORMLEVEL *lvl = &xform_level[level[n]-1];
+		if ( xform->function_type==XT_LINEAR )
+		{
+			if ( lvl->n_linear==0 && (lvl->linear=(TRANSFORM**)malloc(sizeof(TRANSFORM*)*n_xforms))==NULL )
+				goto Done;
+			lvl->linear[lvl->n_linear++] = xform;
+		}
+		else if ( xform->function_type==XT_EXTERNAL )
+		{
+			if ( lvl->n_external==0 && (lvl->external=(TRANSFORM**)malloc(sizeof(TRANSFORM*)*n_xforms))==NULL )
+				goto Done;
+			lvl->external[lvl->n_external++] = xform;
+		}
+		else if ( xform->function_type==XT_FILTER )
+		{
+			unsigned int k;
+			for ( k=0 ; k<XS_NTYPES && (xform->source_type&(1<<k))==0 ; k++ ) {}
+			if ( k<XS_NTYPES && !timeheap_push(&lvl->filter[k],xform->t2,xform) )
+				goto Done;
+		}
+	}
+	for ( n=0 ; n<n_levels ; n++ )
+		qsort(xform_level[n].linear,xform_level[n].n_linear,sizeof(TRANSFORM*),compare_linear);
+	IN_MYCONTEXT output_debug("transform_compile(): %d transforms compiled into %d levels", n_xforms, n_levels);
+	ok = 1;
+Done:
+	free(table);
+	free(level);
+	if ( !ok )
+		transform_release();
+	return ok;
+}
+
+typedef struct s_transformsyncdata {
+	TRANSFORM **list;
+	TIMESTAMP t1;
+	TRANSFORMSOURCE source;
+} TRANSFORMSYNCDATA;
+
+static TIMESTAMP transform_linearslice(void *arg, unsigned int first, unsigned int last)
+{
+	TRANSFORMSYNCDATA *data = (TRANSFORMSYNCDATA*)arg;
+	TIMESTAMP t1 = data->t1, t2 = TS_NEVER;
+	SCHEDULE *sched = NULL;
+	TIMESTAMP skew = 0, tnext = TS_NEVER;
+	double value = 0;
+	int current = 0;
+	unsigned int n;
+	for ( n=first ; n<last ; n++ )
+	{
+		TRANSFORM *xform = data->list[n];
+		SCHEDULE *skewed;
+		if ( (xform->source_type&data->source)==0 )
+			continue;
+		skewed = transform_skewed(xform);
+		if ( skewed!=NULL )
+		{
+			/* read the schedule once for all the targets with the same skew */
+			if ( skewed!=sched || xform->target_obj->schedule_skew!=skew )
+			{
+				TIMESTAMP tskew = t1 - xform->target_obj->schedule_skew; // subtract so the +12 is 'twelve seconds later', not earlier
+				SCHEDULEINDEX index = schedule_index(skewed,tskew);
+				int32 dtnext = schedule_dtnext(skewed,index)*60;
+				value = schedule_value(skewed,index);
+				tnext = (dtnext == 0 ? TS_NEVER : t1 + dtnext - (tskew % 60));
+				current = !((tskew <= skewed->since) || (tskew >= skewed->next_t));
+				sched = skewed;
+				skew = xform->target_obj->schedule_skew;
+			}
+			if ( tnext<t2 ) t2 = tnext;
+			transform_apply(t1,xform,current?NULL:&value);
+		}
+		else
+			transform_apply(t1,xform,NULL);
+	}
+	return t2;
+}
+
 clock_t transform_synctime = 0;
 TIMESTAMP transform_syncall(TIMESTAMP t1, TRANSFORMSOURCE source)
 {
-	TRANSFORM *xform;
 	clock_t start = (clock_t)exec_clock();
-	TIMESTAMP t2 = TS_NEVER;
-	TIMESTAMP tskew, tSkewSince, tSkewNext, t;
+	TIMESTAMP t2 = TS_NEVER, t;
+	unsigned int n, m, k;
 
-	/* process the schedule transformations */
-	for (xform=schedule_xformlist; xform!=NULL; xform=xform->next)
-	{	
-		if (xform->source_type&source){
-			if((xform->source_type == XS_SCHEDULE) && (xform->target_obj->schedule_skew != 0)){
-			    tskew = t1 - xform->target_obj->schedule_skew; // subtract so the +12 is 'twelve seconds later', not earlier
-			    SCHEDULEINDEX index = schedule_index(xform->source_schedule,tskew);
-			    int32 dtnext = schedule_dtnext(xform->source_schedule,index)*60;
-			    double value = schedule_value(xform->source_schedule,index);
-			    t = (dtnext == 0 ? TS_NEVER : t1 + dtnext - (tskew % 60));
-			    if ( t < t2 ) t2 = t;
-				if((tskew <= xform->source_schedule->since) || (tskew >= xform->source_schedule->next_t)){
-					t = transform_apply(t1,xform,&value);
-					if ( t<t2 ) t2=t;
-				} 
-				else 
-				{
-					t = transform_apply(t1,xform,NULL);
-					if ( t<t2 ) t2=t;
-				}
-			} else {
+	if ( n_compiled!=n_xforms && !transform_compile() )
+	{
+		output_error("transform_syncall(): unable to compile the transform list");
+		/* TROUBLESHOOT
+			The memory needed to organize the transforms for synchronization could not be allocated.
+			Try freeing up memory by making more heap available or making the model smaller.
+		 */
+		return TS_INVALID;
+	}
+
+	for ( n=0 ; n<n_levels ; n++ )
+	{
+		TRANSFORMLEVEL *lvl = &xform_level[n];
+
+		/* linear transforms */
+		if ( lvl->n_linear>0 )
+		{
+			TRANSFORMSYNCDATA data = {lvl->linear,t1,source};
+			t = threadpool_run(transform_linearslice,&data,lvl->n_linear,64);
+			if ( t<t2 ) t2 = t;
+		}
+
+		/* external transforms */
+		for ( m=0 ; m<lvl->n_external ; m++ )
+		{
+			TRANSFORM *xform = lvl->external[m];
+			if ( xform->source_type&source )
+			{
 				t = transform_apply(t1,xform,NULL);
-				if ( t<t2 ) t2=t;
+				if ( t<t2 ) t2 = t;
+			}
+		}
+
+		/* filters that are due for a sample */
+		for ( k=0 ; k<XS_NTYPES ; k++ )
+		{
+			TIMEHEAP *heap = &lvl->filter[k];
+			if ( (source&(1<<k))==0 || heap->n==0 )
+				continue;
+			timeheap_due(heap,t1);
+			for ( m=0 ; m<heap->ndue ; m++ )
+				heap->due[m].t = transform_apply(t1,(TRANSFORM*)heap->due[m].item,NULL);
+			if ( !timeheap_requeue(heap) )
+			{
+				output_error("transform_syncall(): unable to reschedule filter transforms");
+				/* TROUBLESHOOT
+					The memory needed to reschedule the filter transforms could not be allocated.
+					Try freeing up memory by making more heap available or making the model smaller.
+				 */
+				return TS_INVALID;
 			}
+			t = timeheap_next(heap);
+			if ( t<t2 ) t2 = t;
 		}
 	}
 	transform_synctime += (clock_t)exec_clock() - start;
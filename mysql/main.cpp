@@ -1271,10 +1271,18 @@ bool export_schedules(MYSQL *mysql)
 		return false;
 	for ( SCHEDULE *schedule=gl_schedule_getfirst() ; schedule!=NULL ; schedule=schedule->next )
 	{
-		char quoted[sizeof(schedule->definition)*2+1];
-		mysql_real_escape_string(mysql,quoted,schedule->definition,strlen(schedule->definition));
-		if ( !query(mysql,"REPLACE INTO `%s` (`name`,`definition`) VALUES (\"%s\",\"%s\")", get_table_name("schedules"),
-				schedule->name, quoted) )
+		size_t len = strlen(schedule->definition);
+		char *quoted = (char*)malloc(len*2+1);
+		if ( quoted==NULL )
+		{
+			gl_error("memory allocation failed");
+			return false;
+		}
+		mysql_real_escape_string(mysql,quoted,schedule->definition,len);
+		bool ok = query(mysql,"REPLACE INTO `%s` (`name`,`definition`) VALUES (\"%s\",\"%s\")", get_table_name("schedules"),
+				schedule->name, quoted);
+		free(quoted);
+		if ( !ok )
 			return false;
 	}
 	return true;
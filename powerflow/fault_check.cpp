@@ -53,6 +53,7 @@ int fault_check::isa(char *classname)
 int fault_check::create(void)
 {
 	int result = powerflow_object::create();
+	int phase_idx;
 	prev_time = 0;
 	phases = PHASE_A;	//Arbitrary - set so powerflow_object shuts up (library doesn't grant us access to synch)
 
@@ -71,6 +72,18 @@ int fault_check::create(void)
 
 	associated_grid = NULL;	//Null the array
 
+	//Connectivity tracking is allocated on the first support check
+	for (phase_idx=0; phase_idx<3; phase_idx++)
+	{
+		island_parent[phase_idx] = NULL;
+		island_next[phase_idx] = NULL;
+		island_work[phase_idx] = NULL;
+		island_rank[phase_idx] = NULL;
+	}
+	island_reset = NULL;
+	island_link_phases = NULL;
+	island_mode = -1;
+
 	grid_association_mode = false;	//By default, we go to normal "Highlander" grid (there can be only one!)
 
 	return result;
@@ -173,7 +186,7 @@ TIMESTAMP fault_check::sync(TIMESTAMP t0)
 	{
 		perform_check = true;	//Flag for a check
 	}//end single check
-	else if ((fcheck_state == ONCHANGE) && (NR_admit_change == true))	//Admittance change has been flagged
+	else if ((fcheck_state == ONCHANGE) && ((NR_admit_change == true) || (NR_admit_delta_count > 0)))	//Admittance change has been flagged
 	{
 		perform_check = true;	//Flag the check
 	}//end onchange check
@@ -344,271 +357,319 @@ TIMESTAMP fault_check::sync(TIMESTAMP t0)
 }
 
 
-void fault_check::search_links(int node_int)
+//Phases a link carries for the connectivity check.  Radial checks follow the present phases of the link,
+//mesh checks follow the original phases of anything that isn't an open switch, sectionalizer or recloser
+unsigned char fault_check::connectivity_link_phases(unsigned int branch_int, bool mesh_mode)
 {
-	unsigned int index, indexb;
-	bool both_handled, from_val, first_resto, proceed_in;
-	int branch_val;
-	BRANCHDATA temp_branch;
-	unsigned char work_phases;
-
-	//Loop through the connectivity and populate appropriately
-	for (index=0; index<NR_busdata[node_int].Link_Table_Size; index++)	//parse through our connected link
-	{
-		temp_branch = NR_branchdata[NR_busdata[node_int].Link_Table[index]];	//Get connecting link information
+	unsigned char temp_phases;
 
-		first_resto = false;		//Flag that restoration hasn't gone off
-		proceed_in = false;			//Flag that we need to go the next link in
+	temp_phases = NR_branchdata[branch_int].phases & 0x07;
 
-		//Check for no phase condition
-		if ((temp_branch.phases & 0x07) != 0x00)
+	if (mesh_mode == true)
+	{
+		//Are we a switch
+		if ((NR_branchdata[branch_int].lnk_type == 2) || (NR_branchdata[branch_int].lnk_type == 5) || (NR_branchdata[branch_int].lnk_type == 6))
 		{
-			for (indexb=0; indexb<3; indexb++)	//Handle phases
+			if (*NR_branchdata[branch_int].status == 1)
 			{
-				work_phases = 0x04 >> indexb;	//Pull off the phase reference
+				temp_phases |= NR_branchdata[branch_int].origphases & 0x07;
+			}
+		}
+		else
+		{
+			temp_phases |= NR_branchdata[branch_int].origphases & 0x07;
+		}
+	}
 
-				if ((temp_branch.phases & work_phases) == work_phases)	//We are of the proper phase
-				{
-					both_handled = false;	//Reset flag
+	return temp_phases;
+}
 
-					//See which end we are, and if the other end has been handled
-					if (temp_branch.from == node_int)	//We're the from
-					{
-						from_val = true;	//Flag us as the from end (so we don't have to check it again later)
-					}
-					else	//Must be the to
-					{
-						from_val = false;	//Flag us as the to end (so we don't have to check it again later)
-					}
+//Union-find root of the island a bus is in, for one phase -- path halving keeps the trees flat
+unsigned int fault_check::connectivity_find(int phase_idx, unsigned int node_int)
+{
+	unsigned int *parent = island_parent[phase_idx];
 
-					//See if both sides of this link are already set - if so, don't bother going back in
-					if ((Supported_Nodes[temp_branch.to][indexb]==1) && (Supported_Nodes[temp_branch.from][indexb]==1))
-						both_handled=true;
+	while (parent[node_int] != node_int)
+	{
+		parent[node_int] = parent[parent[node_int]];
+		node_int = parent[node_int];
+	}
 
-					//If not handled, proceed with logic-ness
-					if (both_handled==false)
-					{
-						//Figure out the indexing so we can tell what we are
-						if (from_val)	//From end
-						{
-							branch_val = temp_branch.to;
+	return node_int;
+}
 
-							//See if our FROM end is properly supported (paranoia check)
-							if (Supported_Nodes[temp_branch.from][indexb] == 1)
-							{
-								proceed_in = true;		//Flag to progress when done
-							}
-							else
-							{
-								continue;		//Somehow is checking, but neither of our ends are set - skip us for now
-							}
-						}
-						else	//To end
-						{
-							branch_val = temp_branch.from;
+//Join the islands of two buses for one phase
+void fault_check::connectivity_union(int phase_idx, unsigned int node_a, unsigned int node_b)
+{
+	unsigned int temp_node;
 
-							//See if our TO end is properly supported (paranoia check)
-							if (Supported_Nodes[temp_branch.to][indexb] == 1)
-							{
-								proceed_in = true;		//Flag to progress when done
-							}
-							else
-							{
-								continue;		//Somehow is checking, but neither of our ends are set - skip us for now
-							}
-						}
+	node_a = connectivity_find(phase_idx,node_a);
+	node_b = connectivity_find(phase_idx,node_b);
 
-						//Flag us as connected
-						Supported_Nodes[branch_val][indexb] = 1;
+	if (node_a == node_b)	//Already the same island
+		return;
 
-					}//End both not handled (work to be done)
-				}//End are a proper phase
-			}//End phase testloop
+	//Union by rank
+	if (island_rank[phase_idx][node_a] < island_rank[phase_idx][node_b])
+	{
+		temp_node = node_a;
+		node_a = node_b;
+		node_b = temp_node;
+	}
+	else if (island_rank[phase_idx][node_a] == island_rank[phase_idx][node_b])
+	{
+		island_rank[phase_idx][node_a]++;
+	}
+	island_parent[phase_idx][node_b] = node_a;
 
-			if (proceed_in)
-			{
-				//Recursion!!
-				search_links(branch_val);
-			}
-		}//End has phases test loop
-	}//End link table loop
+	//Splice the member lists together
+	temp_node = island_next[phase_idx][node_a];
+	island_next[phase_idx][node_a] = island_next[phase_idx][node_b];
+	island_next[phase_idx][node_b] = temp_node;
 }
 
-//Mesh searching function -- checks to see how something was removed
-void fault_check::search_links_mesh(int node_int)
+//Bring the per-phase islands up to date with the present link states.  Links that gained a phase
+//are joined in place.  Islands holding a link that lost a phase are broken back into single buses and
+//rebuilt from their own links, so the rest of the system is left alone.
+void fault_check::update_connectivity(bool mesh_mode)
 {
-	unsigned int index, device_value, node_value;
-	unsigned char temp_phases, temp_compare_phases;
+	unsigned int indexa, indexb, node_val, island_size[3];
+	int phase_idx;
+	unsigned char new_phases, lost_phases, gained_phases, phase_bit;
+	bool full_rebuild;
 
-	//Check our entry mode -- if grid association mode, do this as a recursion
-	if (grid_association_mode == false)	//Nope, do "normally"
+	//Allocate on first use
+	if (island_link_phases == NULL)
 	{
-		//Loop through our connected nodes
-		for (index=0; index<NR_busdata[node_int].Link_Table_Size; index++)
+		island_link_phases = (unsigned char*)gl_malloc(NR_branch_count*sizeof(unsigned char));
+		island_reset = (unsigned char*)gl_malloc(NR_bus_count*sizeof(unsigned char));
+
+		if ((island_link_phases == NULL) || (island_reset == NULL))
 		{
-			//Pull link index -- just for readabiiity
-			device_value = NR_busdata[node_int].Link_Table[index];
+			GL_THROW("fault_check: connectivity tracking allocation failure");
+			/*  TROUBLESHOOT
+			The fault_check object has failed to allocate the arrays used to track which buses are connected
+			on each phase.  Please try again and if the problem persists, submit your code and a bug report
+			via the ticketing system.
+			*/
+		}
 
-			//Get our opposite end reference
-			if (node_int == NR_branchdata[device_value].from)
+		for (phase_idx=0; phase_idx<3; phase_idx++)
+		{
+			island_parent[phase_idx] = (unsigned int*)gl_malloc(NR_bus_count*sizeof(unsigned int));
+			island_next[phase_idx] = (unsigned int*)gl_malloc(NR_bus_count*sizeof(unsigned int));
+			island_work[phase_idx] = (unsigned int*)gl_malloc(NR_bus_count*sizeof(unsigned int));
+			island_rank[phase_idx] = (unsigned char*)gl_malloc(NR_bus_count*sizeof(unsigned char));
+
+			if ((island_parent[phase_idx] == NULL) || (island_next[phase_idx] == NULL) || (island_work[phase_idx] == NULL) || (island_rank[phase_idx] == NULL))
 			{
-				//Extract our index
-				node_value = NR_branchdata[device_value].to;
+				GL_THROW("fault_check: connectivity tracking allocation failure");
+				//Defined above
 			}
-			else	//Must be the TO side, so check from
+		}
+
+		for (indexa=0; indexa<NR_bus_count; indexa++)
+		{
+			island_reset[indexa] = 0x00;
+		}
+
+		island_mode = -1;	//Nothing built yet
+	}
+
+	//Build from scratch the first time, or if the link phase rule changed
+	full_rebuild = (island_mode != (mesh_mode ? 1 : 0));
+
+	if (full_rebuild == true)
+	{
+		for (indexa=0; indexa<NR_branch_count; indexa++)
+		{
+			island_link_phases[indexa] = 0x00;
+		}
+
+		for (phase_idx=0; phase_idx<3; phase_idx++)
+		{
+			for (indexa=0; indexa<NR_bus_count; indexa++)
 			{
-				//Extract our index
-				node_value = NR_branchdata[device_value].from;
+				island_parent[phase_idx][indexa] = indexa;
+				island_next[phase_idx][indexa] = indexa;
+				island_rank[phase_idx][indexa] = 0;
 			}
+		}
 
-			//Get initial phasing information - the ones that are available
-			temp_phases = NR_branchdata[device_value].phases;
+		island_mode = (mesh_mode ? 1 : 0);
+	}
+
+	//Collect the buses of every island that lost a link -- nothing is joined until they are reset
+	for (phase_idx=0; phase_idx<3; phase_idx++)
+	{
+		island_size[phase_idx] = 0;
+	}
 
-			//See if either end has any valid phases
-			if ((valid_phases[node_int] != 0x00) || (valid_phases[node_value] != 0x00))
+	for (indexa=0; indexa<NR_branch_count; indexa++)
+	{
+		new_phases = connectivity_link_phases(indexa,mesh_mode);
+		lost_phases = island_link_phases[indexa] & ~new_phases;
+
+		for (phase_idx=0; (phase_idx<3) && (lost_phases != 0x00); phase_idx++)
+		{
+			phase_bit = 0x04 >> phase_idx;
+
+			if (((lost_phases & phase_bit) == phase_bit) && ((island_reset[NR_branchdata[indexa].from] & phase_bit) != phase_bit))
 			{
-				//Are we a switch
-				if ((NR_branchdata[device_value].lnk_type == 2) || (NR_branchdata[device_value].lnk_type == 5) || (NR_branchdata[device_value].lnk_type == 6))
-				{
-					if (*NR_branchdata[device_value].status == 1)
-					{
-						temp_phases |= NR_branchdata[device_value].origphases & 0x07;
-					}
-				}
-				else
+				//Walk the island's member list
+				node_val = NR_branchdata[indexa].from;
+				do
 				{
-					temp_phases |= NR_branchdata[device_value].origphases & 0x07;
-				}
+					island_reset[node_val] |= phase_bit;
+					island_work[phase_idx][island_size[phase_idx]++] = node_val;
+					node_val = island_next[phase_idx][node_val];
+				} while (node_val != NR_branchdata[indexa].from);
 			}
+		}
+	}
 
-			//Populate the phase information
-			valid_phases[node_value] |= (valid_phases[node_int] & temp_phases);
-		}//End of node link table traversion
-	}//End not grid association mode
-	else	//Grid association mode
+	//Break those islands back into single buses
+	for (phase_idx=0; phase_idx<3; phase_idx++)
 	{
-		//Loop through our connected nodes
-		for (index=0; index<NR_busdata[node_int].Link_Table_Size; index++)
+		for (indexa=0; indexa<island_size[phase_idx]; indexa++)
 		{
-			//Pull link index -- just for readabiiity
-			device_value = NR_busdata[node_int].Link_Table[index];
+			node_val = island_work[phase_idx][indexa];
+			island_parent[phase_idx][node_val] = node_val;
+			island_next[phase_idx][node_val] = node_val;
+			island_rank[phase_idx][node_val] = 0;
+		}
+	}
 
-			//Get our opposite end reference
-			if (node_int == NR_branchdata[device_value].from)
-			{
-				//Extract our index
-				node_value = NR_branchdata[device_value].to;
-			}
-			else	//Must be the TO side, so check from
+	//Join the links that gained phases and record the new states
+	for (indexa=0; indexa<NR_branch_count; indexa++)
+	{
+		new_phases = connectivity_link_phases(indexa,mesh_mode);
+		gained_phases = new_phases & ~island_link_phases[indexa];
+
+		for (phase_idx=0; (phase_idx<3) && (gained_phases != 0x00); phase_idx++)
+		{
+			if ((gained_phases & (0x04 >> phase_idx)) != 0x00)
 			{
-				//Extract our index
-				node_value = NR_branchdata[device_value].from;
+				connectivity_union(phase_idx,NR_branchdata[indexa].from,NR_branchdata[indexa].to);
 			}
+		}
+
+		island_link_phases[indexa] = new_phases;
+	}
 
-			//Get initial phasing information - the ones that are available
-			temp_phases = NR_branchdata[device_value].phases;
+	//Rebuild the broken islands from the links of their buses
+	for (phase_idx=0; phase_idx<3; phase_idx++)
+	{
+		phase_bit = 0x04 >> phase_idx;
+
+		for (indexa=0; indexa<island_size[phase_idx]; indexa++)
+		{
+			node_val = island_work[phase_idx][indexa];
 
-			//See if either end has any valid phases
-			if ((valid_phases[node_int] != 0x00) || (valid_phases[node_value] != 0x00))
+			for (indexb=0; indexb<NR_busdata[node_val].Link_Table_Size; indexb++)
 			{
-				//Are we a switch
-				if ((NR_branchdata[device_value].lnk_type == 2) || (NR_branchdata[device_value].lnk_type == 5) || (NR_branchdata[device_value].lnk_type == 6))
-				{
-					if (*NR_branchdata[device_value].status == 1)
-					{
-						temp_phases |= NR_branchdata[device_value].origphases & 0x07;
-					}
-				}
-				else
+				if ((island_link_phases[NR_busdata[node_val].Link_Table[indexb]] & phase_bit) == phase_bit)
 				{
-					temp_phases |= NR_branchdata[device_value].origphases & 0x07;
+					connectivity_union(phase_idx,NR_branchdata[NR_busdata[node_val].Link_Table[indexb]].from,NR_branchdata[NR_busdata[node_val].Link_Table[indexb]].to);
 				}
 			}
 
-			//Check our "contributions" against the other end - use this to determine recursion
-			temp_compare_phases = (valid_phases[node_value] | (valid_phases[node_int] & temp_phases));
-
-			//See if it is the same
-			if (valid_phases[node_value] != temp_compare_phases)
-			{
-				//Populate the phase information - store what we just did (no point doing twice)
-				valid_phases[node_value] = temp_compare_phases;
-
-				//Recurse in, do this node now
-				search_links_mesh(node_value);
-			}
-			//Default else -- they match, so don't bother
-		}//End of node link table traversion
-	}//End grid association mode
+			island_reset[node_val] &= ~phase_bit;
+		}
+	}
 }
 
 void fault_check::support_check(int swing_node_int)
 {
-	unsigned int index;
+	unsigned int index, swing_root;
+	int phase_idx;
 	unsigned char phase_vals;
 
 	//Reset the node status list
 	reset_support_check();
 
-	//Swing node has support - if the phase exists (changed for complete faults)
-	for (index=0; index<3; index++)
+	//Update the islands for the present link phases
+	update_connectivity(false);
+
+	//Anything in the swing node's island has support - if the swing has the phase (changed for complete faults)
+	for (phase_idx=0; phase_idx<3; phase_idx++)
 	{
-		phase_vals = 0x04 >> index;	//Set up phase value
+		phase_vals = 0x04 >> phase_idx;	//Set up phase value
 
 		if ((NR_busdata[swing_node_int].phases & phase_vals) == phase_vals)	//Has this phase
-			Supported_Nodes[swing_node_int][index] = 1;	//Flag it as supported
-	}
+		{
+			swing_root = connectivity_find(phase_idx,swing_node_int);
 
-	//Call the node link-erator (node support check) - call it on the swing, the details are handled inside
-	search_links(swing_node_int);
+			for (index=0; index<NR_bus_count; index++)
+			{
+				if (connectivity_find(phase_idx,index) == swing_root)
+					Supported_Nodes[index][phase_idx] = 1;	//Flag it as supported
+			}
+		}
+	}
 }
 
 //Mesh-capable version of support check -- by default, it doesn't support restoration object
 void fault_check::support_check_mesh(int swing_node_int)
 {
-	unsigned int indexa, indexb;
+	unsigned int indexa;
+	int phase_idx;
+	unsigned char phase_vals;
 
 	//Reset the node status list
 	reset_support_check();
 
-	if (grid_association_mode == false)	//Not needing to do grid association, use normal, inefficient method
+	//Update the islands for the present switch states
+	update_connectivity(true);
+
+	//Flag the islands with a source in them - island_reset is clear between updates, so borrow it
+	if (grid_association_mode == false)	//Not needing to do grid association, just the swing
 	{
 		//Swing node has support - if the phase exists (changed for complete faults)
-		valid_phases[swing_node_int] = NR_busdata[swing_node_int].phases & 0x07;
+		phase_vals = NR_busdata[swing_node_int].phases & 0x07;
 
-		//Call the node link-erator (node support check) - call it on the swing, the details are handled inside
-		//Supports possibly meshed topology - brute force method
-		for (indexa=0; indexa<NR_bus_count; indexa++)
+		for (phase_idx=0; phase_idx<3; phase_idx++)
 		{
-			for (indexb=0; indexb<NR_bus_count; indexb++)
-			{
-				//Call the search link on individual nodes
-				search_links_mesh(indexb);
-			}
+			if ((phase_vals & (0x04 >> phase_idx)) != 0x00)
+				island_reset[connectivity_find(phase_idx,swing_node_int)] |= (0x04 >> phase_idx);
 		}
 	}
-	else	//Grid association mode, do slightly different
+	else	//Grid association mode, every source supports its own island
 	{
-		//Traverse the whole bus list, just in case (since may be altered in the future)
 		for (indexa=0; indexa<NR_bus_count; indexa++)
 		{
 			//See if we're a SWING node
 			if ((NR_busdata[indexa].type == 2) || ((NR_busdata[indexa].type == 3) && (NR_busdata[indexa].swing_functions_enabled == true)) || ((*NR_busdata[indexa].busflag & NF_ISSOURCE) == NF_ISSOURCE))	//SWING node, of some form
 			{
-				//Check and see if we've apparently been "sourced" before
-				if ((NR_busdata[indexa].phases & 0x07) != valid_phases[indexa])	//We don't match, so something came to us, but not the other way
-				{
-					//Extract our phases
-					valid_phases[indexa] |= (NR_busdata[indexa].phases & 0x07);
+				phase_vals = NR_busdata[indexa].phases & 0x07;
 
-					//Call the support check
-					search_links_mesh(indexa);
+				for (phase_idx=0; phase_idx<3; phase_idx++)
+				{
+					if ((phase_vals & (0x04 >> phase_idx)) != 0x00)
+						island_reset[connectivity_find(phase_idx,indexa)] |= (0x04 >> phase_idx);
 				}
-				//Default else -- we were already handled
 			}
 			//Default else -- not a swing
 		}
 	}
+
+	//Every bus gets the phases of the sourced islands it is in
+	for (indexa=0; indexa<NR_bus_count; indexa++)
+	{
+		for (phase_idx=0; phase_idx<3; phase_idx++)
+		{
+			phase_vals = 0x04 >> phase_idx;
+
+			if ((island_reset[connectivity_find(phase_idx,indexa)] & phase_vals) == phase_vals)
+				valid_phases[indexa] |= phase_vals;
+		}
+	}
+
+	//Clear the flags again
+	for (indexa=0; indexa<NR_bus_count; indexa++)
+	{
+		island_reset[indexa] = 0x00;
+	}
 }
 
 void fault_check::reset_support_check(void)
@@ -987,7 +1048,7 @@ void fault_check::support_check_alterations(int baselink_int, bool rest_mode)
 
 			if ((NR_busdata[base_bus_val].phases & 0x07) != 0x00)	//We have phase, means OK above us
 			{
-				//Recurse our way in - adjusted version of original search_links function above (but no storage, because we don't care now)
+				//Recurse our way in - adjusted version of the original recursive support check (but no storage, because we don't care now)
 				support_search_links(base_bus_val, base_bus_val, rest_mode);
 			}
 			else
@@ -997,7 +1058,7 @@ void fault_check::support_check_alterations(int baselink_int, bool rest_mode)
 		{
 			gl_verbose("Alterations support check called removal on bus %s",NR_busdata[base_bus_val].name);
 
-			//Recurse our way in - adjusted version of original search_links function above (but no storage, because we don't care now)
+			//Recurse our way in - adjusted version of the original recursive support check (but no storage, because we don't care now)
 			support_search_links(base_bus_val, base_bus_val, rest_mode);
 		}
 	}
@@ -1432,7 +1493,7 @@ void fault_check::special_object_alteration_handle(int branch_idx)
 }
 
 //Recursive function to traverse powerflow and alter phases as necessary
-//Based on search_links code from above
+//Based on the original recursive support check
 void fault_check::support_search_links(int node_int, int node_start, bool impact_mode)
 {
 	unsigned int index;
@@ -37,8 +37,10 @@ public:
 	int create(void);
 	int init(OBJECT *parent=NULL);
 	int isa(char *classname);
-	void search_links(int node_int);							//Function to check connectivity and support of nodes
-	void search_links_mesh(int node_int);						//Function to check connectivity and support of nodes, but more in the "mesh" sense
+	unsigned char connectivity_link_phases(unsigned int branch_int, bool mesh_mode);	//Function to get the phases a link connects for the support checks
+	unsigned int connectivity_find(int phase_idx, unsigned int node_int);				//Function to find the island a node is in, for one phase
+	void connectivity_union(int phase_idx, unsigned int node_a, unsigned int node_b);	//Function to join the islands of two nodes, for one phase
+	void update_connectivity(bool mesh_mode);											//Function to bring the per-phase islands up to date with the link states
 	void support_check(int swing_node_int);						//Function that performs the connectivity check - this way so can be easily externally accessed
 	void support_check_mesh(int swing_node_int);				//Function that performs the connectivity check for not-so-radial systems
 	void reset_support_check(void);								//Function to re-init the support matrix
@@ -64,6 +66,14 @@ private:
 	TIMESTAMP prev_time;	//Previous timestamp - mainly for intialization
 	FUNCTIONADDR restoration_fxn;	// Function address for restoration object reconfiguration call
 	int *associated_grid;	//Array for assignment of nodes to different "main connection" points
+
+	unsigned int *island_parent[3];		//Per-phase union-find parent of each node
+	unsigned int *island_next[3];		//Per-phase circular list of the nodes in each island, so one island can be rebuilt on its own
+	unsigned int *island_work[3];		//Per-phase list of the nodes being rebuilt
+	unsigned char *island_rank[3];		//Per-phase union-find rank of each node
+	unsigned char *island_reset;		//Phases each node is being rebuilt on (hex mapped)
+	unsigned char *island_link_phases;	//Phases each link connected at the last update (hex mapped)
+	int island_mode;					//Link phase rule the islands were built with -- -1 = not built, 0 = radial, 1 = mesh
 };
 
 EXPORT int powerflow_alterations(OBJECT *thisobj, int baselink,bool rest_mode);
@@ -793,7 +793,7 @@ void fuse::fuse_sync_function(void)
 		if ((status != prev_status) || (pres_status != prev_full_status))
 		{
 			LOCK_OBJECT(NR_swing_bus);	//Lock SWING since we'll be modifying this
-			NR_admit_change = true;	//Flag an admittance change
+			NR_admit_branch_change(NR_branch_reference);	//Flag an admittance change on just this branch
 			UNLOCK_OBJECT(NR_swing_bus);	//Finished
 		}
 
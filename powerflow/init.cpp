@@ -81,9 +81,15 @@ EXPORT CLASS *init(CALLBACKS *fntable, MODULE *module, int argc, char *argv[])
 	gl_global_create("powerflow::line_capacitance",PT_bool,&use_line_cap,NULL);
 	gl_global_create("powerflow::line_limits",PT_bool,&use_link_limits,NULL);
 	gl_global_create("powerflow::lu_solver",PT_char256,&LUSolverName,NULL);
+	gl_global_create("powerflow::NR_matrix_solver",PT_enumeration,&matrix_solver_method,PT_DESCRIPTION,"Sparse LU solver used by Newton-Raphson - EXTERN is set when lu_solver loads an external library",
+		PT_KEYWORD,"SUPERLU",MM_SUPERLU,
+		PT_KEYWORD,"EXTERN",MM_EXTERN,
+		PT_KEYWORD,"KLU",MM_KLU,
+		NULL);
 	gl_global_create("powerflow::NR_iteration_limit",PT_int64,&NR_iteration_limit,NULL);
 	gl_global_create("powerflow::NR_deltamode_iteration_limit",PT_int64,&NR_delta_iteration_limit,NULL);
 	gl_global_create("powerflow::NR_superLU_procs",PT_int32,&NR_superLU_procs,NULL);
+	gl_global_create("powerflow::NR_superLU_reuse_symbolic",PT_bool,&NR_superLU_reuse_symbolic,PT_DESCRIPTION,"Reuse the superLU column ordering and elimination tree between Newton-Raphson solutions while the admittance pattern is unchanged",NULL);
 	gl_global_create("powerflow::default_maximum_voltage_error",PT_double,&default_maximum_voltage_error,NULL);
 	gl_global_create("powerflow::default_maximum_power_error",PT_double,&default_maximum_power_error,NULL);
 	gl_global_create("powerflow::NR_admit_change",PT_bool,&NR_admit_change,NULL);
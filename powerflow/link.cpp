@@ -212,6 +212,8 @@ int link_object::create(void)
 	protect_locations[0] = protect_locations[1] = protect_locations[2] = -1;	//Initalize cleared
 
 	current_in[0] = current_in[1] = current_in[2] = complex(0,0);
+	FBS_from_current[0] = FBS_from_current[1] = FBS_from_current[2] = complex(0,0);
+	FBS_attached = false;
 
 	link_limits[0][0] = link_limits[0][1] = link_limits[0][2] = link_limits[1][0] = link_limits[1][2] = link_limits[1][3] = NULL;
 	
@@ -2661,6 +2663,21 @@ TIMESTAMP link_object::sync(TIMESTAMP t0)
 #endif
 	OBJECT *obj = OBJECTHDR(this);
 
+	if (solver_method==SM_FBS)
+	{
+		//The from node sums our current in its own sync - hook in the first time through
+		if (!FBS_attached)
+		{
+			WRITELOCK_OBJECT(from);
+			OBJECTDATA(from,node)->FBS_attach_child(FBS_from_current);
+			WRITEUNLOCK_OBJECT(from);
+
+			FBS_attached = true;
+		}
+
+		FBS_from_current[0] = FBS_from_current[1] = FBS_from_current[2] = complex(0,0);
+	}
+
 	if (is_closed())
 	{
 		if (solver_method==SM_FBS)
@@ -2672,10 +2689,8 @@ TIMESTAMP link_object::sync(TIMESTAMP t0)
 #ifdef SUPPORT_OUTAGES
 			tNode->condition=fNode->condition;
 #endif
-			/* compute currents */
-			READLOCK_OBJECT(to);
+			/* compute currents - the to node finished its sync earlier in this pass */
 			complex tc[] = {t->current_inj[0], t->current_inj[1], t->current_inj[2]};
-			UNLOCK_OBJECT(to);
 
 			complex i0, i1, i2;
 
@@ -2701,11 +2716,9 @@ TIMESTAMP link_object::sync(TIMESTAMP t0)
 				d_mat[2][1] * tc[1] +
 				d_mat[2][2] * tc[2];
 
-			WRITELOCK_OBJECT(from);
-			f->current_inj[0] += i0;
-			f->current_inj[1] += i1;
-			f->current_inj[2] += i2;
-			WRITEUNLOCK_OBJECT(from);
+			FBS_from_current[0] = i0;
+			FBS_from_current[1] = i1;
+			FBS_from_current[2] = i2;
 		}
 	}
 #ifdef SUPPORT_OUTAGES
@@ -3015,9 +3028,7 @@ TIMESTAMP link_object::postsync(TIMESTAMP t0)
 		set reverse = get_flow(&f,&t);
 
 		// update published current_out values;
-		READLOCK_OBJECT(to);
 		complex tc[] = {t->current_inj[0], t->current_inj[1], t->current_inj[2]};
-		READUNLOCK_OBJECT(to);
 
 		read_I_out[0] = tc[0];
 		read_I_out[1] = tc[1];
@@ -3052,11 +3063,10 @@ TIMESTAMP link_object::postsync(TIMESTAMP t0)
 				B_mat[2][1] * tc[1] -
 				B_mat[2][2] * tc[2];
 
-			WRITELOCK_OBJECT(to);
+			//Only this link feeds the to node, so no lock is needed
 			t->voltage[0] = v0;
 			t->voltage[1] = v1;
 			t->voltage[2] = v2;
-			WRITEUNLOCK_OBJECT(to);
 
 #ifdef SUPPORT_OUTAGES		
 			t->condition=f->condition;
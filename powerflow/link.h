@@ -74,6 +74,8 @@ public:
 	OBJECT *from;			///< from_node - source node
 	OBJECT *to;				///< to_node - load node
 	complex current_in[3];		///< current flow to link (w.r.t from node)
+	complex FBS_from_current[3];	///< FBS - current drawn from the from node in this pass (zero while open), summed by the from node's sync
+	bool FBS_attached;		///< FBS - FBS_from_current has been attached to the from node
 	complex current_out[3];	///< current flow out of link (w.r.t. to node)
 	complex read_I_in[3];	///< published current flow to link (w.r.t from node)
 	complex read_I_out[3];  ///< published current flow out of link (w.r.t to node)
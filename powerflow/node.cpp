@@ -53,6 +53,7 @@
 #include <math.h>
 
 #include "solver_nr.h"
+#include "solver_klu.h"
 #include "node.h"
 #include "link.h"
 #include "capacitor.h"
@@ -238,6 +239,10 @@ int node::create(void)
 	SubNode = NONE;
 	SubNodeParent = NULL;
 	TopologicalParent = NULL;
+	FBS_child_inj = NULL;
+	FBS_child_count = 0;
+	FBS_child_alloc = 0;
+	FBS_attached = false;
 	NR_subnode_reference = NULL;
 	Extra_Data=NULL;
 	NR_link_table = NULL;
@@ -704,9 +709,36 @@ int node::init(OBJECT *parent)
 		//Make sure it is the "master swing" too
 		if (obj == NR_swing_bus)
 		{
-			if (LUSolverName[0]=='\0')	//Empty name, default to superLU
+			if (LUSolverName[0]=='\0')	//Empty name, use one of the built-in solvers
 			{
-				matrix_solver_method=MM_SUPERLU;	//This is the default, but we'll set it here anyways
+				if (matrix_solver_method==MM_KLU)	//Built-in KLU-style solver - hook it in like an external one
+				{
+					LUSolverFcns.dllLink = NULL;
+					LUSolverFcns.ext_init = (void *)klu_solver_init;
+					LUSolverFcns.ext_alloc = (void *)klu_solver_alloc;
+					LUSolverFcns.ext_solve = (void *)klu_solver_solve;
+					LUSolverFcns.ext_destroy = (void *)klu_solver_destroy;
+
+					gl_verbose("Built-in KLU solver selected, utilizing for NR");
+					/*  TROUBLESHOOT
+					The built-in KLU-style sparse LU solver was selected with NR_matrix_solver, so NR will
+					be calculated using it instead of superLU.
+					*/
+				}
+				else
+				{
+					if (matrix_solver_method==MM_EXTERN)
+					{
+						gl_warning("NR_matrix_solver EXTERN requires lu_solver to name the external library, defaulting to superLU");
+						/*  TROUBLESHOOT
+						The NR_matrix_solver global was set to EXTERN, but no external LU solver library was named
+						with the lu_solver global.  superLU is being used instead.  Specify lu_solver to load an
+						external solver.
+						*/
+					}
+
+					matrix_solver_method=MM_SUPERLU;	//This is the default, but we'll set it here anyways
+				}
 			}
 			else	//Something is there, see if we can find it
 			{
@@ -2218,6 +2250,14 @@ TIMESTAMP node::sync(TIMESTAMP t0)
 	{
 	case SM_FBS:
 		{
+		//Pull in the currents of the links and child nodes below us - they synced earlier in this pass
+		for (unsigned int child_index=0; child_index<FBS_child_count; child_index++)
+		{
+			current_inj[0] += FBS_child_inj[child_index][0];
+			current_inj[1] += FBS_child_inj[child_index][1];
+			current_inj[2] += FBS_child_inj[child_index][2];
+		}
+
 		if (phases&PHASE_S)
 		{	// Split phase
 			complex temp_inj[2];
@@ -2456,12 +2496,15 @@ TIMESTAMP node::sync(TIMESTAMP t0)
 			//Check to make sure phases are correct - ignore Deltas and neutrals (load changes take care of those)
 			if (((pNode->phases & phases) & (!(PHASE_D | PHASE_N))) == (phases & (!(PHASE_D | PHASE_N))))
 			{
-				// add the injections on this node to the parent
-				WRITELOCK_OBJECT(obj->parent);
-				pNode->current_inj[0] += current_inj[0];
-				pNode->current_inj[1] += current_inj[1];
-				pNode->current_inj[2] += current_inj[2];
-				WRITEUNLOCK_OBJECT(obj->parent);
+				// the parent adds our injections in its own sync - just hook in the first time through
+				if (!FBS_attached)
+				{
+					WRITELOCK_OBJECT(obj->parent);
+					pNode->FBS_attach_child(current_inj);
+					WRITEUNLOCK_OBJECT(obj->parent);
+
+					FBS_attached = true;
+				}
 			}
 			else
 				GL_THROW("Node:%d's parent does not have the proper phase connection to be a parent.",obj->id);
@@ -2757,6 +2800,41 @@ TIMESTAMP node::postsync(TIMESTAMP t0)
 	return RetValue;
 }
 
+//Adds a current contribution that FBS sync sums into current_inj (links fed from this node and child nodes)
+//Called once per child, the first time it syncs - caller holds the lock on this node
+void node::FBS_attach_child(complex *child_inj)
+{
+	complex **temp_list;
+	unsigned int index;
+
+	if (FBS_child_count == FBS_child_alloc)
+	{
+		FBS_child_alloc = (FBS_child_alloc == 0) ? 4 : 2*FBS_child_alloc;
+
+		temp_list = (complex **)gl_malloc(FBS_child_alloc*sizeof(complex *));
+
+		if (temp_list == NULL)
+		{
+			GL_THROW("Node:%s failed to allocate space for its FBS child list",OBJECTHDR(this)->name ? OBJECTHDR(this)->name : "unnamed");
+			/*  TROUBLESHOOT
+			While attaching the links and child nodes it sums currents from in the forward-backward sweep,
+			a node failed to allocate memory.  Please try again.  If the error persists, please submit
+			your code and a bug report via the trac website.
+			*/
+		}
+
+		for (index=0; index<FBS_child_count; index++)
+			temp_list[index] = FBS_child_inj[index];
+
+		if (FBS_child_inj != NULL)
+			gl_free(FBS_child_inj);
+
+		FBS_child_inj = temp_list;
+	}
+
+	FBS_child_inj[FBS_child_count++] = child_inj;
+}
+
 int node::kmlinit(int (*stream)(const char*,...))
 {
 	gld_global host("hostname");
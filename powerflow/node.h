@@ -247,6 +247,12 @@ public:
 	int NR_current_update(bool postpass, bool parentcall);
 	object TopologicalParent;	/// Child node's original parent as per the topological configuration in the GLM file
 
+	complex **FBS_child_inj;			/// FBS - current contributions of the links fed from this node and of child nodes, summed in sync
+	unsigned int FBS_child_count;		/// FBS - number of entries in FBS_child_inj
+	unsigned int FBS_child_alloc;		/// FBS - allocated size of FBS_child_inj
+	bool FBS_attached;					/// FBS - this node's current_inj has been attached to its parent node
+	void FBS_attach_child(complex *child_inj);
+
 	friend class link_object;
 	friend class meter;	// needs access to current_inj
 	friend class substation; //needs access to current_inj
@@ -29,7 +29,7 @@ void print_matrix(complex mat[3][3]);
 #define IMPORT_CLASS(name) extern CLASS *name##_class
 
 typedef enum {SM_FBS=0, SM_GS=1, SM_NR=2} SOLVERMETHOD;		/**< powerflow solver methodology */
-typedef enum {MM_SUPERLU=0, MM_EXTERN=1} MATRIXSOLVERMETHOD;	/**< NR matrix solver methodlogy */
+typedef enum {MM_SUPERLU=0, MM_EXTERN=1, MM_KLU=2} MATRIXSOLVERMETHOD;	/**< NR matrix solver methodlogy */
 typedef enum {
 	MD_NONE=0,			///< No matrix dump desired
 	MD_ONCE=1,			///< Single matrix dump desired
@@ -70,7 +70,10 @@ GLOBAL int NR_curr_branch INIT(-1);					/**< Newton-Raphson current branch indic
 GLOBAL int64 NR_iteration_limit INIT(500);			/**< Newton-Raphson iteration limit (per GridLAB-D iteration) */
 GLOBAL bool NR_dyn_first_run INIT(true);			/**< Newton-Raphson first run indicator - used by deltamode functionality for initialization powerflow */
 GLOBAL bool NR_admit_change INIT(true);				/**< Newton-Raphson admittance matrix change detector - used to prevent complete recalculation of admittance at every timestep */
+GLOBAL unsigned int NR_admit_delta_count INIT(0);	/**< Newton-Raphson admittance changes confined to single branches - number of branches queued in NR_admit_delta_branch */
+GLOBAL int *NR_admit_delta_branch INIT(NULL);		/**< Newton-Raphson branches queued by NR_admit_branch_change - their elements are patched instead of rebuilding the admittance */
 GLOBAL int NR_superLU_procs INIT(1);				/**< Newton-Raphson related - superLU MT processor count to request - separate from thread_count */
+GLOBAL bool NR_superLU_reuse_symbolic INIT(true);	/**< Newton-Raphson related - keep the superLU column ordering and elimination tree while the matrix pattern is unchanged */
 GLOBAL TIMESTAMP NR_retval INIT(TS_NEVER);			/**< Newton-Raphson current return value - if t0 objects know we aren't going anywhere */
 GLOBAL OBJECT *NR_swing_bus INIT(NULL);				/**< Newton-Raphson swing bus */
 GLOBAL int NR_swing_bus_reference INIT(-1);			/**< Newton-Raphson swing bus index reference in NR_busdata */
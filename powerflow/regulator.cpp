@@ -809,7 +809,7 @@ TIMESTAMP regulator::presync(TIMESTAMP t0)
 		{
 			//Flag an update
 			LOCK_OBJECT(NR_swing_bus);	//Lock SWING since we'll be modifying this
-			NR_admit_change = true;
+			NR_admit_branch_change(NR_branch_reference);	//Flag an admittance change on just this branch
 			UNLOCK_OBJECT(NR_swing_bus);	//Unlock
 
 			//Update our previous tap positions
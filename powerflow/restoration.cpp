@@ -4383,6 +4383,13 @@ LinkedBase::LinkedBase(int nVer)
 	dfs_time = 0;
 	numEdges = 0;
 
+	//Compact adjacency is allocated by the first traversal
+	csrStart = NULL;
+	csrVert = NULL;
+	csrQueue = NULL;
+	csrVerSize = 0;
+	csrEdgSize = 0;
+
 	if (nVer == 0)
 	{
 		numVertices = 0;
@@ -4527,6 +4534,24 @@ void LinkedBase::delAllVer(void)
 		dTime = NULL;
 		fTime = NULL;
 	}
+
+	//Release the traversal arrays too - callers re-construct the graph in place afterwards
+	if (csrStart != NULL)
+	{
+		gl_free(csrStart);
+		gl_free(csrQueue);
+	}
+
+	if (csrVert != NULL)
+	{
+		gl_free(csrVert);
+	}
+
+	csrStart = NULL;
+	csrVert = NULL;
+	csrQueue = NULL;
+	csrVerSize = 0;
+	csrEdgSize = 0;
 }
 
 //Return the number of vertices
@@ -4634,11 +4659,92 @@ int LinkedBase::nextVertex(int index)
 	return iterPos[index]->next();
 }
 
+//Pack the adjacency list into compact arrays for a traversal.  Neighbors keep their
+//adjacency list order, so the traversals visit vertices exactly as the chains would
+void LinkedBase::buildCSR(void)
+{
+	int idx, count;
+	CHAINNODE *tNode;
+
+	//Size the vertex arrays - kept between calls, since the graphs are traversed over and over
+	if (csrVerSize < (numVertices + 1))
+	{
+		if (csrStart != NULL)
+		{
+			gl_free(csrStart);
+			gl_free(csrQueue);
+		}
+
+		csrStart = (int *)gl_malloc((numVertices + 1)*sizeof(int));
+		csrQueue = (int *)gl_malloc((numVertices + 1)*sizeof(int));
+
+		if ((csrStart == NULL) || (csrQueue == NULL))
+		{
+			GL_THROW("Restoration:Failed to allocate compact adjacency");
+			/*  TROUBLESHOOT
+			While attempting to allocate the compact adjacency arrays used to traverse one of the restoration
+			program's graphs, an error was encountered.  Please try again.  If the error persists, please submit
+			your code and a bug report via the ticket system.
+			*/
+		}
+
+		csrVerSize = numVertices + 1;
+	}
+
+	//Count the neighbors of each vertex
+	count = 0;
+	for (idx=0; idx<numVertices; idx++)
+	{
+		csrStart[idx] = count;
+
+		if (adjList[idx] != NULL)
+		{
+			for (tNode = adjList[idx]->first; tNode != NULL; tNode = tNode->link)
+			{
+				count++;
+			}
+		}
+	}
+	csrStart[numVertices] = count;
+
+	//Size the neighbor array
+	if (csrEdgSize < count)
+	{
+		if (csrVert != NULL)
+		{
+			gl_free(csrVert);
+		}
+
+		csrVert = (int *)gl_malloc(count*sizeof(int));
+
+		if (csrVert == NULL)
+		{
+			GL_THROW("Restoration:Failed to allocate compact adjacency");
+			//Defined above
+		}
+
+		csrEdgSize = count;
+	}
+
+	//Copy the neighbors in
+	count = 0;
+	for (idx=0; idx<numVertices; idx++)
+	{
+		if (adjList[idx] != NULL)
+		{
+			for (tNode = adjList[idx]->first; tNode != NULL; tNode = tNode->link)
+			{
+				csrVert[count] = tNode->data;
+				count++;
+			}
+		}
+	}
+}
+
 // Breadth-first search
 void LinkedBase::BFS(int s)
 {
-	int index, u, v;
-	LinkedQueue *Q;
+	int index, u, v, k, q_head, q_tail;
 
     // Intialization
     for (index=0; index<numVertices; index++)
@@ -4652,48 +4758,34 @@ void LinkedBase::BFS(int s)
 	status_value[s] = 1;
 	dist[s] = 0.0;
 
-	// Use the queue to manager vertices whose status is '1'
-	//Create a temporary Q
-	Q = (LinkedQueue *)gl_malloc(sizeof(LinkedQueue));
-
-	//Make sure it worked
-	if (Q == NULL)
-	{
-		GL_THROW("Restoration:Failed to allocate new LinkedQueue");
-	}
-
-	//Call the constructor, just in case
-	new (Q) LinkedQueue();
+	// Pack the adjacency for the search
+	buildCSR();
 
-	Q->enQueue(s);
-    
-	// Initialize the iterator
-	initializePos();
+	// Use the queue to manager vertices whose status is '1' - each vertex enters it once
+	q_head = 0;
+	q_tail = 0;
+	csrQueue[q_tail++] = s;
 
 	// Search process
-	while (Q->isempty() != true)
+	while (q_head < q_tail)
 	{
-		u = Q->deQueue();
-        v = beginVertex(u);
+		u = csrQueue[q_head++];
 
-		while (v != -1)
+		for (k=csrStart[u]; k<csrStart[u+1]; k++)
 		{
+			v = csrVert[k];
+
             if (status_value[v] == 0) // v has not been discovered yet
 			{
 				status_value[v] = 1;
 				dist[v] = dist[u] + 1.0;
 				parent_value[v] = u;
-				Q->enQueue(v);
+				csrQueue[q_tail++] = v;
 			}
-
-			v = nextVertex(u);
 		}
 
 		status_value[u] = 2;
 	}
-	
-	// Deactive the iterator
-	deactivatePos();
 }
 
 // Depth-first search I: create a depth-first forest
@@ -4710,8 +4802,8 @@ void LinkedBase::DFS1(void)
 
 	dfs_time = 0;
 
-	// Initialize the iterator
-	initializePos();
+	// Pack the adjacency for the search
+	buildCSR();
 
 	// Search from each vertex that is not discovered
     for (u = 0; u < numVertices; u++)
@@ -4721,8 +4813,6 @@ void LinkedBase::DFS1(void)
             DFSVisit(u);
 		}
 	}
-    // Deactive the iterator
-    deactivatePos();
 }
 
 // Depth-first search II: create a depth-first tree with a specified root.
@@ -4740,21 +4830,19 @@ void LinkedBase::DFS2(int s)
 
 	dfs_time = 0;
 
-    // Initialize the iterator
-	initializePos();
+	// Pack the adjacency for the search
+	buildCSR();
 
 	// Search from the source
 	source = s;
 	DFSVisit(s);
-
-	// Deactive the iterator
-	deactivatePos();
 }
 
 //visits vertices in depth first search and marks them as visited; u is a vertex
+//Uses the compact adjacency packed by DFS1/DFS2
 void LinkedBase::DFSVisit(int u)
 {
-	int v;
+	int v, k;
 
 	status_value[u] = 1;
 
@@ -4762,17 +4850,15 @@ void LinkedBase::DFSVisit(int u)
 
 	dTime[u] = dfs_time;
 
-	v = beginVertex(u);
-    
-	while (v != -1) // Explore eage (u, v)
+	for (k=csrStart[u]; k<csrStart[u+1]; k++) // Explore eage (u, v)
 	{
+		v = csrVert[k];
+
         if (status_value[v] == 0)
 		{
 			parent_value[v] = u;
 			DFSVisit(v);
 		}
-
-		v = nextVertex(u);
 	}
 
 	status_value[u] = 2;	//Finished
@@ -5122,15 +5208,16 @@ void LinkedUndigraph::findFunCutSet(CHORDSET *chordSet, BRANCHVERTICES *tBranch,
 		parent_back = iIndex;
 	}
 
+	// Set the status of all vertices to '0' -- each chord then marks with its own number (idx+1),
+	// so the marks don't need clearing between chords
+	for (k=0; k<numVertices; k++)
+	{
+		status_value[k] = 0;
+	}
+
 	// Fine fundmental cut set
 	for (idx=0; idx<chordSet->currSize; idx++)
 	{
-		// Set the status of all vertices to '0'
-		for (k=0; k<numVertices; k++)
-		{
-			status_value[k] = 0;
-		}
-
 		iIndex = chordSet->data_1[idx];
 		jIndex = chordSet->data_2[idx];
 
@@ -5141,7 +5228,7 @@ void LinkedUndigraph::findFunCutSet(CHORDSET *chordSet, BRANCHVERTICES *tBranch,
 
 		while (curIndex != -1)
 		{
-			status_value[curIndex] = 1;
+			status_value[curIndex] = idx + 1;
 			curIndex = parent_value[curIndex];
 
 			debug_counter++;	//Added to prevent it from getting stuck (circular loops)
@@ -5168,7 +5255,7 @@ void LinkedUndigraph::findFunCutSet(CHORDSET *chordSet, BRANCHVERTICES *tBranch,
 		curIndex = jIndex;
 		while (curIndex != -1)
 		{
-			if (status_value[curIndex] == 1)
+			if (status_value[curIndex] == (idx + 1))
 			{
 				isCutSetEle = false; // (i,j) is not a element of the fundmental cut set
 				break;
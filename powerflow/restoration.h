@@ -114,6 +114,11 @@ public: // member properties
 	TIMESTAMP dfs_time;			//Previous timestamp - mainly for intialization
 	TIMESTAMP *dTime;			//timestamp array I for DFS, records when each vertex is discovered
 	TIMESTAMP *fTime;			//timestamp array II for DFS, records when the search finishes exaining the adjacency list for each vertex
+	int *csrStart;				//compact (CSR) adjacency for traversals - index of each vertex's first neighbor in csrVert
+	int *csrVert;				//compact (CSR) adjacency for traversals - neighbors of every vertex, in adjacency list order
+	int *csrQueue;				//work queue for BFS
+	int csrVerSize;				//allocated length of csrStart and csrQueue
+	int csrEdgSize;				//allocated length of csrVert
 public: // member functions
 	LinkedBase(int nVer);				//Initializer
 	void delAllVer(void);				//delete all elements in the adjacency list
@@ -130,6 +135,7 @@ public: // member functions
 	void DFSVisit(int u);				//visits vertices in depth first search and marks them as visited; u is a vertex
 	void copy(LinkedBase *graph1);		//copy a graph, but only vertices, edges, and adjacency.  Properties for iterator and graph traversal excluded
 	void addAIsoVer(int n);				//add n isolated vertices into a graph
+	void buildCSR(void);				//pack the adjacency list into csrStart/csrVert for a traversal
 };
 
 //LinkedDigraph class
@@ -0,0 +1,1043 @@
+/* $Id
+ * Built-in KLU-style sparse LU solver for the Newton-Raphson solver
+ *
+ * Circuit matrices are very sparse, nearly structurally symmetric and change only
+ * in value between Newton-Raphson iterations.  The solver follows the KLU approach:
+ *   - a maximum transversal and Tarjan's strongly connected components give a
+ *     block upper triangular (BTF) form, so only the diagonal blocks are factored
+ *   - each diagonal block is ordered by minimum degree on the pattern of B+B'
+ *   - the blocks are factored with a left-looking (Gilbert-Peierls) LU using
+ *     threshold partial pivoting, preferring the diagonal
+ *   - while the pattern is unchanged, later solutions reuse the pivot sequence and
+ *     the L/U pattern and only recompute the values (refactorization).  A pivot that
+ *     became too small triggers a full factorization instead.
+ *
+ * The functions use the same calling convention as an external LU solver library,
+ * so solver_nr calls them through LUSolverFcns.
+ */
+
+#include "solver_klu.h"
+
+/* access to module global variables */
+#include "powerflow.h"
+
+//Relative threshold for partial pivoting - the diagonal is kept if it is at least this fraction of the column maximum
+#define KLU_PIVOT_TOLERANCE 0.001
+
+//Allocation helper - GLD heap, throws on failure
+static void *klu_malloc(unsigned int count, unsigned int size)
+{
+	void *temp_ptr;
+
+	temp_ptr = gl_malloc((count > 0 ? count : 1)*size);
+
+	if (temp_ptr == NULL)
+	{
+		GL_THROW("NR: Failed to allocate memory for the KLU solver");
+		/*  TROUBLESHOOT
+		While attempting to allocate the working space of the built-in KLU solver, an error
+		occurred.  Please try again.  If the error persists, please submit your code and a
+		bug report via the trac website.
+		*/
+	}
+
+	return temp_ptr;
+}
+
+//Free helper - NULLs the pointer after
+static void klu_free(void **ptr)
+{
+	if (*ptr != NULL)
+	{
+		gl_free(*ptr);
+		*ptr = NULL;
+	}
+}
+
+//Free everything that depends on the matrix pattern
+static void klu_release(KLU_SOLVER_VARS *kv)
+{
+	klu_free((void **)&kv->pat_cols);
+	klu_free((void **)&kv->pat_rows);
+	klu_free((void **)&kv->Q);
+	klu_free((void **)&kv->Prow);
+	klu_free((void **)&kv->R);
+	klu_free((void **)&kv->Amap);
+	klu_free((void **)&kv->Cp);
+	klu_free((void **)&kv->Ci);
+	klu_free((void **)&kv->Cx);
+	klu_free((void **)&kv->Fp);
+	klu_free((void **)&kv->Fi);
+	klu_free((void **)&kv->Fx);
+	klu_free((void **)&kv->Lp);
+	klu_free((void **)&kv->Li);
+	klu_free((void **)&kv->Lx);
+	klu_free((void **)&kv->Up);
+	klu_free((void **)&kv->Ui);
+	klu_free((void **)&kv->Ux);
+	klu_free((void **)&kv->pinv);
+	klu_free((void **)&kv->work);
+	klu_free((void **)&kv->iwork);
+
+	kv->Lcap = 0;
+	kv->Ucap = 0;
+	kv->nblocks = 0;
+	kv->analyzed = false;
+	kv->factored = false;
+}
+
+//Grow a factor's entry storage so at least needed entries fit
+static void klu_grow(int **index, double **value, unsigned int *cap, unsigned int used, unsigned int needed)
+{
+	unsigned int newcap;
+	int *new_index;
+	double *new_value;
+
+	if (needed <= *cap)
+		return;
+
+	newcap = 2 * (*cap) + needed;
+
+	new_index = (int *)klu_malloc(newcap,sizeof(int));
+	new_value = (double *)klu_malloc(newcap,sizeof(double));
+
+	if (used > 0)
+	{
+		memcpy(new_index,*index,used*sizeof(int));
+		memcpy(new_value,*value,used*sizeof(double));
+	}
+
+	klu_free((void **)index);
+	klu_free((void **)value);
+
+	*index = new_index;
+	*value = new_value;
+	*cap = newcap;
+}
+
+//Maximum transversal - matches each column to a row so the permuted matrix has a zero-free diagonal
+//Diagonal entries are taken first, the rest are found by depth-first augmenting paths
+//Returns the number of unmatched columns (0 unless the matrix is structurally singular)
+static int klu_maxtrans(int n, int *Ap, int *Ai, int *colmatch)
+{
+	int *rowmatch, *visited, *cheap, *js, *is, *ps;
+	int i, j, k, p, head, unmatched;
+	bool found;
+
+	rowmatch = (int *)klu_malloc(n,sizeof(int));
+	visited = (int *)klu_malloc(n,sizeof(int));
+	cheap = (int *)klu_malloc(n,sizeof(int));
+	js = (int *)klu_malloc(n,sizeof(int));
+	is = (int *)klu_malloc(n,sizeof(int));
+	ps = (int *)klu_malloc(n,sizeof(int));
+
+	for (i=0; i<n; i++)
+	{
+		rowmatch[i] = -1;
+		colmatch[i] = -1;
+		visited[i] = -1;
+		cheap[i] = Ap[i];
+	}
+
+	//Keep the diagonal wherever it exists - the NR Jacobian nearly always has it
+	for (j=0; j<n; j++)
+	{
+		for (p=Ap[j]; p<Ap[j+1]; p++)
+		{
+			if ((Ai[p] == j) && (rowmatch[j] == -1))
+			{
+				rowmatch[j] = j;
+				colmatch[j] = j;
+				break;
+			}
+		}
+	}
+
+	//Augment the remaining columns
+	for (k=0; k<n; k++)
+	{
+		if (colmatch[k] != -1)
+			continue;
+
+		found = false;
+		head = 0;
+		js[0] = k;
+		i = -1;
+
+		while (head >= 0)
+		{
+			j = js[head];
+
+			if (visited[j] != k)	//First visit - try a cheap assignment
+			{
+				visited[j] = k;
+
+				for (p=cheap[j]; (p<Ap[j+1]) && !found; p++)
+				{
+					i = Ai[p];
+					found = (rowmatch[i] == -1);
+				}
+				cheap[j] = p;
+
+				if (found)
+				{
+					is[head] = i;
+					break;
+				}
+
+				ps[head] = Ap[j];
+			}
+
+			//Depth-first - continue through a row whose column is not yet on the path
+			for (p=ps[head]; p<Ap[j+1]; p++)
+			{
+				i = Ai[p];
+
+				if (visited[rowmatch[i]] == k)
+					continue;
+
+				ps[head] = p + 1;
+				is[head] = i;
+				head++;
+				js[head] = rowmatch[i];
+				break;
+			}
+
+			if (p == Ap[j+1])	//Dead end
+				head--;
+		}
+
+		//Flip the path
+		if (found)
+		{
+			for (p=head; p>=0; p--)
+			{
+				rowmatch[is[p]] = js[p];
+			}
+		}
+	}
+
+	//Rebuild the column side and count failures
+	unmatched = n;
+	for (j=0; j<n; j++)
+		colmatch[j] = -1;
+
+	for (i=0; i<n; i++)
+	{
+		if (rowmatch[i] != -1)
+		{
+			colmatch[rowmatch[i]] = i;
+			unmatched--;
+		}
+	}
+
+	gl_free(rowmatch);
+	gl_free(visited);
+	gl_free(cheap);
+	gl_free(js);
+	gl_free(is);
+	gl_free(ps);
+
+	return unmatched;
+}
+
+//Strongly connected components of the matched matrix (Tarjan, non-recursive)
+//Node j is column j, with an edge to the column matched to each row of column j
+//Components come out sinks first, which is exactly block upper triangular order
+//Fills order with the columns grouped by block and R with the block boundaries - returns the block count
+static int klu_btf(int n, int *Ap, int *Ai, int *rowcol, int *order, int *R)
+{
+	int *index, *low, *stack, *call, *ptr;
+	bool *onstack;
+	int s, v, u, w, p, idx, top, calltop, outpos, nb;
+
+	index = (int *)klu_malloc(n,sizeof(int));
+	low = (int *)klu_malloc(n,sizeof(int));
+	stack = (int *)klu_malloc(n,sizeof(int));
+	call = (int *)klu_malloc(n,sizeof(int));
+	ptr = (int *)klu_malloc(n,sizeof(int));
+	onstack = (bool *)klu_malloc(n,sizeof(bool));
+
+	for (v=0; v<n; v++)
+	{
+		index[v] = -1;
+		onstack[v] = false;
+	}
+
+	idx = 0;
+	top = 0;
+	outpos = 0;
+	nb = 0;
+	R[0] = 0;
+
+	for (s=0; s<n; s++)
+	{
+		if (index[s] != -1)
+			continue;
+
+		calltop = 0;
+		call[0] = s;
+		ptr[0] = Ap[s];
+		index[s] = low[s] = idx++;
+		stack[top++] = s;
+		onstack[s] = true;
+
+		while (calltop >= 0)
+		{
+			v = call[calltop];
+			p = ptr[calltop];
+
+			if (p < Ap[v+1])
+			{
+				ptr[calltop]++;
+				u = rowcol[Ai[p]];
+
+				if (index[u] == -1)	//Descend
+				{
+					index[u] = low[u] = idx++;
+					stack[top++] = u;
+					onstack[u] = true;
+					calltop++;
+					call[calltop] = u;
+					ptr[calltop] = Ap[u];
+				}
+				else if (onstack[u] && (index[u] < low[v]))
+				{
+					low[v] = index[u];
+				}
+			}
+			else	//Done with v
+			{
+				calltop--;
+
+				if (low[v] == index[v])	//Root of a component - pop it as the next block
+				{
+					do {
+						w = stack[--top];
+						onstack[w] = false;
+						order[outpos++] = w;
+					} while (w != v);
+
+					nb++;
+					R[nb] = outpos;
+				}
+
+				if ((calltop >= 0) && (low[v] < low[call[calltop]]))
+				{
+					low[call[calltop]] = low[v];
+				}
+			}
+		}
+	}
+
+	gl_free(index);
+	gl_free(low);
+	gl_free(stack);
+	gl_free(call);
+	gl_free(ptr);
+	gl_free(onstack);
+
+	return nb;
+}
+
+//Append an entry to an elimination graph adjacency list
+static void klu_adj_add(int **adj, int *len, int *cap, int v, int u)
+{
+	int *temp_list;
+
+	if (len[v] == cap[v])
+	{
+		cap[v] = 2*cap[v] + 4;
+		temp_list = (int *)klu_malloc(cap[v],sizeof(int));
+
+		if (len[v] > 0)
+			memcpy(temp_list,adj[v],len[v]*sizeof(int));
+
+		if (adj[v] != NULL)
+			gl_free(adj[v]);
+
+		adj[v] = temp_list;
+	}
+
+	adj[v][len[v]++] = u;
+}
+
+//Minimum degree ordering of one diagonal block on the explicit elimination graph of B+B'
+//nodes holds the block's columns on entry and the ordered columns on exit
+static void klu_mindegree(int m, int *nodes, int *Ap, int *Ai, int *rowcol, int *local)
+{
+	int **adj;
+	int *len, *cap, *mark, *head, *next, *prev, *degree, *order;
+	int i, k, v, u, w, p, q, mindeg, stamp;
+
+	adj = (int **)klu_malloc(m,sizeof(int *));
+	len = (int *)klu_malloc(m,sizeof(int));
+	cap = (int *)klu_malloc(m,sizeof(int));
+	mark = (int *)klu_malloc(m,sizeof(int));
+	head = (int *)klu_malloc(m,sizeof(int));
+	next = (int *)klu_malloc(m,sizeof(int));
+	prev = (int *)klu_malloc(m,sizeof(int));
+	degree = (int *)klu_malloc(m,sizeof(int));
+	order = (int *)klu_malloc(m,sizeof(int));
+
+	for (i=0; i<m; i++)
+	{
+		adj[i] = NULL;
+		len[i] = 0;
+		cap[i] = 0;
+		mark[i] = -1;
+		head[i] = -1;
+	}
+
+	//Symmetric pattern, within the block only
+	for (i=0; i<m; i++)
+	{
+		v = nodes[i];
+
+		for (p=Ap[v]; p<Ap[v+1]; p++)
+		{
+			u = local[rowcol[Ai[p]]];
+
+			if ((u < 0) || (u == i))
+				continue;
+
+			klu_adj_add(adj,len,cap,i,u);
+			klu_adj_add(adj,len,cap,u,i);
+		}
+	}
+
+	//Remove duplicates and fill the degree lists
+	for (i=0; i<m; i++)
+	{
+		k = 0;
+		for (p=0; p<len[i]; p++)
+		{
+			u = adj[i][p];
+			if (mark[u] != i)
+			{
+				mark[u] = i;
+				adj[i][k++] = u;
+			}
+		}
+		len[i] = k;
+
+		degree[i] = len[i];
+		next[i] = head[degree[i]];
+		prev[i] = -1;
+		if (head[degree[i]] != -1)
+			prev[head[degree[i]]] = i;
+		head[degree[i]] = i;
+	}
+
+	for (i=0; i<m; i++)
+		mark[i] = -1;
+
+	//Eliminate
+	mindeg = 0;
+	stamp = 0;
+	for (k=0; k<m; k++)
+	{
+		while (head[mindeg] == -1)
+			mindeg++;
+
+		v = head[mindeg];
+
+		//Pull it from its list
+		head[mindeg] = next[v];
+		if (next[v] != -1)
+			prev[next[v]] = -1;
+
+		order[k] = v;
+		degree[v] = -1;	//Flags as eliminated
+
+		//Neighbors become a clique
+		for (p=0; p<len[v]; p++)
+		{
+			u = adj[v][p];
+
+			//Drop u from its degree list
+			if (prev[u] != -1)
+				next[prev[u]] = next[u];
+			else
+				head[degree[u]] = next[u];
+			if (next[u] != -1)
+				prev[next[u]] = prev[u];
+
+			//Mark what u already has, dropping v
+			stamp++;
+			w = 0;
+			for (q=0; q<len[u]; q++)
+			{
+				if (adj[u][q] != v)
+				{
+					mark[adj[u][q]] = stamp;
+					adj[u][w++] = adj[u][q];
+				}
+			}
+			len[u] = w;
+
+			//Add the rest of v's neighbors
+			for (q=0; q<len[v]; q++)
+			{
+				w = adj[v][q];
+				if ((w != u) && (mark[w] != stamp))
+				{
+					mark[w] = stamp;
+					klu_adj_add(adj,len,cap,u,w);
+				}
+			}
+
+			//Back into the degree lists
+			degree[u] = len[u];
+			next[u] = head[degree[u]];
+			prev[u] = -1;
+			if (head[degree[u]] != -1)
+				prev[head[degree[u]]] = u;
+			head[degree[u]] = u;
+
+			if (degree[u] < mindeg)
+				mindeg = degree[u];
+		}
+
+		klu_free((void **)&adj[v]);
+		len[v] = 0;
+	}
+
+	//Translate back to columns
+	for (k=0; k<m; k++)
+		mark[k] = nodes[order[k]];
+	for (k=0; k<m; k++)
+		nodes[k] = mark[k];
+
+	for (i=0; i<m; i++)
+	{
+		if (adj[i] != NULL)
+			gl_free(adj[i]);
+	}
+
+	gl_free(adj);
+	gl_free(len);
+	gl_free(cap);
+	gl_free(mark);
+	gl_free(head);
+	gl_free(next);
+	gl_free(prev);
+	gl_free(degree);
+	gl_free(order);
+}
+
+//Order the pattern and split it into the diagonal and off-diagonal blocks
+//Returns 0 on success, non-zero if the matrix is structurally singular
+static int klu_analyze(KLU_SOLVER_VARS *kv, int n, int *Ap, int *Ai)
+{
+	int *colmatch, *rowcol, *local, *blk, *pinvrow;
+	int i, j, k, b, p, r, nnz, cnz, fnz;
+
+	klu_release(kv);
+
+	nnz = Ap[n];
+	kv->n = n;
+	kv->nnz = nnz;
+
+	//Keep the pattern so later calls can tell whether it changed
+	kv->pat_cols = (int *)klu_malloc(n+1,sizeof(int));
+	kv->pat_rows = (int *)klu_malloc(nnz,sizeof(int));
+	memcpy(kv->pat_cols,Ap,(n+1)*sizeof(int));
+	memcpy(kv->pat_rows,Ai,nnz*sizeof(int));
+
+	kv->Q = (int *)klu_malloc(n,sizeof(int));
+	kv->Prow = (int *)klu_malloc(n,sizeof(int));
+	kv->R = (int *)klu_malloc(n+1,sizeof(int));
+	kv->Amap = (int *)klu_malloc(nnz,sizeof(int));
+	kv->pinv = (int *)klu_malloc(n,sizeof(int));
+	kv->work = (double *)klu_malloc(n,sizeof(double));
+	kv->iwork = (int *)klu_malloc(3*n,sizeof(int));
+
+	colmatch = (int *)klu_malloc(n,sizeof(int));
+	rowcol = (int *)klu_malloc(n,sizeof(int));
+	local = (int *)klu_malloc(n,sizeof(int));
+
+	//Zero-free diagonal
+	if (klu_maxtrans(n,Ap,Ai,colmatch) != 0)
+	{
+		gl_free(colmatch);
+		gl_free(rowcol);
+		gl_free(local);
+		klu_release(kv);
+		return 1;
+	}
+
+	for (j=0; j<n; j++)
+		rowcol[colmatch[j]] = j;
+
+	//Block upper triangular form
+	kv->nblocks = klu_btf(n,Ap,Ai,rowcol,kv->Q,kv->R);
+
+	//Fill-reducing order inside each block
+	for (i=0; i<n; i++)
+		local[i] = -1;
+
+	for (b=0; b<kv->nblocks; b++)
+	{
+		if ((kv->R[b+1] - kv->R[b]) < 3)
+			continue;	//Nothing to gain
+
+		for (k=kv->R[b]; k<kv->R[b+1]; k++)
+			local[kv->Q[k]] = k - kv->R[b];
+
+		klu_mindegree(kv->R[b+1] - kv->R[b],&kv->Q[kv->R[b]],Ap,Ai,rowcol,local);
+
+		for (k=kv->R[b]; k<kv->R[b+1]; k++)
+			local[kv->Q[k]] = -1;
+	}
+
+	//Matching rows follow their columns
+	blk = (int *)klu_malloc(n,sizeof(int));
+	pinvrow = (int *)klu_malloc(n,sizeof(int));
+
+	for (b=0; b<kv->nblocks; b++)
+	{
+		for (k=kv->R[b]; k<kv->R[b+1]; k++)
+		{
+			blk[k] = b;
+			kv->Prow[k] = colmatch[kv->Q[k]];
+			pinvrow[kv->Prow[k]] = k;
+		}
+	}
+
+	//Split the entries - count first
+	kv->Cp = (int *)klu_malloc(n+1,sizeof(int));
+	kv->Fp = (int *)klu_malloc(n+1,sizeof(int));
+
+	cnz = 0;
+	fnz = 0;
+	for (k=0; k<n; k++)
+	{
+		kv->Cp[k] = cnz;
+		kv->Fp[k] = fnz;
+
+		j = kv->Q[k];
+		for (p=Ap[j]; p<Ap[j+1]; p++)
+		{
+			if (blk[pinvrow[Ai[p]]] == blk[k])
+				cnz++;
+			else
+				fnz++;
+		}
+	}
+	kv->Cp[n] = cnz;
+	kv->Fp[n] = fnz;
+
+	kv->Ci = (int *)klu_malloc(cnz,sizeof(int));
+	kv->Cx = (double *)klu_malloc(cnz,sizeof(double));
+	kv->Fi = (int *)klu_malloc(fnz,sizeof(int));
+	kv->Fx = (double *)klu_malloc(fnz,sizeof(double));
+
+	//Now place them, remembering where each original entry went
+	cnz = 0;
+	fnz = 0;
+	for (k=0; k<n; k++)
+	{
+		j = kv->Q[k];
+		for (p=Ap[j]; p<Ap[j+1]; p++)
+		{
+			r = pinvrow[Ai[p]];
+
+			if (blk[r] == blk[k])
+			{
+				kv->Ci[cnz] = r;
+				kv->Amap[p] = cnz++;
+			}
+			else
+			{
+				kv->Fi[fnz] = r;
+				kv->Amap[p] = -(fnz++) - 1;
+			}
+		}
+	}
+
+	//Factor storage - grown as needed
+	kv->Lp = (int *)klu_malloc(n+1,sizeof(int));
+	kv->Up = (int *)klu_malloc(n+1,sizeof(int));
+	klu_grow(&kv->Li,&kv->Lx,&kv->Lcap,0,2*cnz+n);
+	klu_grow(&kv->Ui,&kv->Ux,&kv->Ucap,0,2*cnz+n);
+
+	gl_free(colmatch);
+	gl_free(rowcol);
+	gl_free(local);
+	gl_free(blk);
+	gl_free(pinvrow);
+
+	kv->analyzed = true;
+	kv->factored = false;
+
+	return 0;
+}
+
+//Full left-looking factorization with threshold partial pivoting (Gilbert-Peierls)
+//Returns 0 on success, or the (1-based) column that had no usable pivot
+static int klu_factor(KLU_SOLVER_VARS *kv)
+{
+	int n, k, p, px, j, jnew, i, top, head, ipiv, *xi, *pstack, *mark;
+	unsigned int lnz, unz;
+	double *x, a, t, pivot;
+	bool done;
+
+	n = kv->n;
+	x = kv->work;
+	xi = kv->iwork;
+	pstack = &kv->iwork[n];
+	mark = &kv->iwork[2*n];
+
+	for (i=0; i<n; i++)
+	{
+		x[i] = 0.0;
+		kv->pinv[i] = -1;
+		mark[i] = -1;
+	}
+
+	kv->factored = false;
+	lnz = 0;
+	unz = 0;
+
+	for (k=0; k<n; k++)
+	{
+		kv->Lp[k] = lnz;
+		kv->Up[k] = unz;
+
+		//Column k can add at most one entry per row of its block
+		klu_grow(&kv->Li,&kv->Lx,&kv->Lcap,lnz,lnz+n);
+		klu_grow(&kv->Ui,&kv->Ux,&kv->Ucap,unz,unz+n);
+
+		//Reach of column k through the finished columns of L - topological order in xi[top..n-1]
+		top = n;
+		for (p=kv->Cp[k]; p<kv->Cp[k+1]; p++)
+		{
+			if (mark[kv->Ci[p]] == k)
+				continue;
+
+			head = 0;
+			xi[0] = kv->Ci[p];
+			while (head >= 0)
+			{
+				j = xi[head];
+				jnew = kv->pinv[j];
+
+				if (mark[j] != k)
+				{
+					mark[j] = k;
+					pstack[head] = (jnew < 0) ? 0 : kv->Lp[jnew];
+				}
+
+				done = true;
+				if (jnew >= 0)
+				{
+					for (px=pstack[head]; px<kv->Lp[jnew+1]; px++)
+					{
+						i = kv->Li[px];
+						if (mark[i] == k)
+							continue;
+
+						pstack[head] = px;
+						xi[++head] = i;
+						done = false;
+						break;
+					}
+				}
+
+				if (done)
+				{
+					head--;
+					xi[--top] = j;
+				}
+			}
+		}
+
+		//Sparse triangular solve x = L \ C(:,k)
+		for (p=kv->Cp[k]; p<kv->Cp[k+1]; p++)
+			x[kv->Ci[p]] = kv->Cx[p];
+
+		for (px=top; px<n; px++)
+		{
+			j = xi[px];
+			jnew = kv->pinv[j];
+
+			if (jnew < 0)
+				continue;
+
+			//Unit diagonal is first - skip it
+			for (p=kv->Lp[jnew]+1; p<kv->Lp[jnew+1]; p++)
+				x[kv->Li[p]] -= kv->Lx[p] * x[j];
+		}
+
+		//Find the pivot, U takes the pivoted rows
+		ipiv = -1;
+		a = -1.0;
+		for (px=top; px<n; px++)
+		{
+			i = xi[px];
+
+			if (kv->pinv[i] < 0)
+			{
+				t = fabs(x[i]);
+				if (t > a)
+				{
+					a = t;
+					ipiv = i;
+				}
+			}
+			else
+			{
+				kv->Ui[unz] = kv->pinv[i];
+				kv->Ux[unz++] = x[i];
+			}
+		}
+
+		if ((ipiv == -1) || (a <= 0.0))
+		{
+			//Clean the work vector for the next attempt
+			for (px=top; px<n; px++)
+				x[xi[px]] = 0.0;
+
+			return k + 1;
+		}
+
+		//Prefer the diagonal when it is big enough
+		if ((kv->pinv[k] < 0) && (mark[k] == k) && (fabs(x[k]) >= a*KLU_PIVOT_TOLERANCE))
+			ipiv = k;
+
+		pivot = x[ipiv];
+		kv->Ui[unz] = k;
+		kv->Ux[unz++] = pivot;
+		kv->pinv[ipiv] = k;
+		kv->Li[lnz] = ipiv;
+		kv->Lx[lnz++] = 1.0;
+
+		for (px=top; px<n; px++)
+		{
+			i = xi[px];
+
+			if (kv->pinv[i] < 0)
+			{
+				kv->Li[lnz] = i;
+				kv->Lx[lnz++] = x[i] / pivot;
+			}
+
+			x[i] = 0.0;
+		}
+	}
+
+	kv->Lp[n] = lnz;
+	kv->Up[n] = unz;
+
+	//L rows into pivot order
+	for (p=0; p<(int)lnz; p++)
+		kv->Li[p] = kv->pinv[kv->Li[p]];
+
+	kv->factored = true;
+
+	return 0;
+}
+
+//Numeric refactorization - same pivot sequence and L/U pattern, new values
+//Returns false if a pivot became too small, in which case a full factorization is needed
+static bool klu_refactor(KLU_SOLVER_VARS *kv)
+{
+	int n, k, p, q, j;
+	double *x, xj, ukk, amax;
+
+	n = kv->n;
+	x = kv->work;
+
+	for (k=0; k<n; k++)
+	{
+		//Scatter the column in pivot order
+		for (p=kv->Cp[k]; p<kv->Cp[k+1]; p++)
+			x[kv->pinv[kv->Ci[p]]] = kv->Cx[p];
+
+		//U entries are stored in topological order, diagonal last
+		for (p=kv->Up[k]; p<kv->Up[k+1]-1; p++)
+		{
+			j = kv->Ui[p];
+			xj = x[j];
+			kv->Ux[p] = xj;
+
+			for (q=kv->Lp[j]+1; q<kv->Lp[j+1]; q++)
+				x[kv->Li[q]] -= kv->Lx[q] * xj;
+		}
+
+		ukk = x[k];
+		amax = 0.0;
+		for (q=kv->Lp[k]+1; q<kv->Lp[k+1]; q++)
+		{
+			if (fabs(x[kv->Li[q]]) > amax)
+				amax = fabs(x[kv->Li[q]]);
+		}
+
+		if ((ukk == 0.0) || (fabs(ukk) < amax*KLU_PIVOT_TOLERANCE))
+		{
+			//Clean up what this column touched and give up
+			for (p=kv->Up[k]; p<kv->Up[k+1]; p++)
+				x[kv->Ui[p]] = 0.0;
+			for (q=kv->Lp[k]; q<kv->Lp[k+1]; q++)
+				x[kv->Li[q]] = 0.0;
+
+			kv->factored = false;
+			return false;
+		}
+
+		kv->Ux[kv->Up[k+1]-1] = ukk;
+		for (q=kv->Lp[k]+1; q<kv->Lp[k+1]; q++)
+			kv->Lx[q] = x[kv->Li[q]] / ukk;
+
+		//Clear the touched entries
+		for (p=kv->Up[k]; p<kv->Up[k+1]; p++)
+			x[kv->Ui[p]] = 0.0;
+		for (q=kv->Lp[k]; q<kv->Lp[k+1]; q++)
+			x[kv->Li[q]] = 0.0;
+	}
+
+	return true;
+}
+
+//Solve with the factors, one right-hand side in place
+static void klu_block_solve(KLU_SOLVER_VARS *kv, double *rhs)
+{
+	int n, b, k1, k2, j, q;
+	double *z, zj;
+
+	n = kv->n;
+	z = kv->work;
+
+	//Permuted right-hand side, in pivot order
+	for (j=0; j<n; j++)
+		z[kv->pinv[j]] = rhs[kv->Prow[j]];
+
+	//Block back substitution - last block first
+	for (b=kv->nblocks-1; b>=0; b--)
+	{
+		k1 = kv->R[b];
+		k2 = kv->R[b+1];
+
+		//Forward solve with L
+		for (j=k1; j<k2; j++)
+		{
+			zj = z[j];
+			for (q=kv->Lp[j]+1; q<kv->Lp[j+1]; q++)
+				z[kv->Li[q]] -= kv->Lx[q] * zj;
+		}
+
+		//Back solve with U
+		for (j=k2-1; j>=k1; j--)
+		{
+			z[j] /= kv->Ux[kv->Up[j+1]-1];
+			zj = z[j];
+			for (q=kv->Up[j]; q<kv->Up[j+1]-1; q++)
+				z[kv->Ui[q]] -= kv->Ux[q] * zj;
+		}
+
+		//Remove this block's contribution from the earlier ones
+		for (j=k1; j<k2; j++)
+		{
+			zj = z[j];
+			for (q=kv->Fp[j]; q<kv->Fp[j+1]; q++)
+				z[kv->pinv[kv->Fi[q]]] -= kv->Fx[q] * zj;
+		}
+	}
+
+	//Back to the original unknown order
+	for (j=0; j<n; j++)
+	{
+		rhs[kv->Q[j]] = z[j];
+		z[j] = 0.0;
+	}
+}
+
+//Initialization - allocates the working structure on the first call, returns it after that
+void *klu_solver_init(void *ext_array)
+{
+	KLU_SOLVER_VARS *kv;
+
+	if (ext_array == NULL)
+	{
+		kv = (KLU_SOLVER_VARS *)gl_malloc(sizeof(KLU_SOLVER_VARS));
+
+		if (kv != NULL)
+			memset(kv,0,sizeof(KLU_SOLVER_VARS));
+
+		return (void *)kv;
+	}
+	else
+	{
+		return ext_array;
+	}
+}
+
+//Allocation - a size change drops the analysis, a same-size change is picked up by the pattern check in the solve
+void klu_solver_alloc(void *ext_array, unsigned int rowcount, unsigned int colcount, bool admittance_change)
+{
+	KLU_SOLVER_VARS *kv = (KLU_SOLVER_VARS *)ext_array;
+
+	if (kv->analyzed && (kv->n != rowcount))
+	{
+		klu_release(kv);
+	}
+}
+
+//Solution - analyzes when the pattern changed, refactors when it did not, then solves into the right-hand side
+int klu_solver_solve(void *ext_array, NR_SOLVER_VARS *system_info_vars, unsigned int rowcount, unsigned int colcount)
+{
+	KLU_SOLVER_VARS *kv = (KLU_SOLVER_VARS *)ext_array;
+	int n, p, dest, info;
+	unsigned int col;
+	int *Ap, *Ai;
+	double *Ax;
+
+	n = rowcount;
+	Ap = system_info_vars->cols_LU;
+	Ai = system_info_vars->rows_LU;
+	Ax = system_info_vars->a_LU;
+
+	//Same pattern as last time?
+	if (!kv->analyzed || (kv->n != rowcount) || (kv->nnz != (unsigned int)Ap[n]) ||
+		(memcmp(kv->pat_cols,Ap,(n+1)*sizeof(int)) != 0) ||
+		(memcmp(kv->pat_rows,Ai,Ap[n]*sizeof(int)) != 0))
+	{
+		if (klu_analyze(kv,n,Ap,Ai) != 0)
+		{
+			return n + 1;	//Structurally singular
+		}
+	}
+
+	//Values into the blocks
+	for (p=0; p<Ap[n]; p++)
+	{
+		dest = kv->Amap[p];
+
+		if (dest >= 0)
+			kv->Cx[dest] = Ax[p];
+		else
+			kv->Fx[-dest-1] = Ax[p];
+	}
+
+	//Reuse the pivot sequence if we can
+	if (!(kv->factored && klu_refactor(kv)))
+	{
+		info = klu_factor(kv);
+
+		if (info != 0)
+			return info;
+	}
+
+	for (col=0; col<colcount; col++)
+	{
+		klu_block_solve(kv,&system_info_vars->rhs_LU[col*rowcount]);
+	}
+
+	return 0;
+}
+
+//Per-iteration cleanup - the analysis and factors are kept for the next refactorization
+void klu_solver_destroy(void *ext_array, bool new_iteration)
+{
+}
@@ -0,0 +1,48 @@
+/* $Id
+ * Built-in KLU-style sparse LU solver for the Newton-Raphson solver
+ */
+
+#ifndef _SOLVER_KLU
+#define _SOLVER_KLU
+
+#include "solver_nr.h"
+
+//Working variables of the built-in solver - kept between calls so the ordering and LU pattern can be reused
+typedef struct {
+	unsigned int n;			///< Size of the analyzed system
+	unsigned int nnz;		///< Number of entries in the analyzed pattern
+	int *pat_cols;			///< Copy of the analyzed column pointers (n+1) - used to detect pattern changes
+	int *pat_rows;			///< Copy of the analyzed row indices (nnz)
+	bool analyzed;			///< Ordering and block structure match pat_cols/pat_rows
+	bool factored;			///< L and U hold a valid factorization of the current pattern (refactor allowed)
+
+	int *Q;					///< Column permutation - column k of the permuted matrix is original column Q[k]
+	int *Prow;				///< Row permutation - row k of the permuted matrix is original row Prow[k]
+	int nblocks;			///< Number of diagonal blocks of the block upper triangular form
+	int *R;					///< Block boundaries - block b is rows/columns R[b] to R[b+1]-1 (nblocks+1)
+	int *Amap;				///< Destination of each original entry - >=0 index into Cx, <0 is -(index+1) into Fx
+
+	int *Cp, *Ci;			///< Diagonal blocks of the permuted matrix, compressed column
+	double *Cx;
+	int *Fp, *Fi;			///< Off-diagonal blocks of the permuted matrix, compressed column
+	double *Fx;
+
+	int *Lp, *Li;			///< Unit lower triangular factor (diagonal stored first in each column)
+	double *Lx;
+	unsigned int Lcap;
+	int *Up, *Ui;			///< Upper triangular factor (diagonal stored last in each column)
+	double *Ux;
+	unsigned int Ucap;
+	int *pinv;				///< Pivot row of each permuted row
+
+	double *work;			///< Dense work vector (n)
+	int *iwork;				///< Integer work space (3n) - reach stack, DFS stack and column marks
+} KLU_SOLVER_VARS;
+
+//Function prototypes - same calling convention as the external solver interface
+void *klu_solver_init(void *ext_array);
+void klu_solver_alloc(void *ext_array, unsigned int rowcount, unsigned int colcount, bool admittance_change);
+int klu_solver_solve(void *ext_array, NR_SOLVER_VARS *system_info_vars, unsigned int rowcount, unsigned int colcount);
+void klu_solver_destroy(void *ext_array, bool new_iteration);
+
+#endif
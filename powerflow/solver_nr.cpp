@@ -52,6 +52,12 @@ NR_SOLVER_VARS matrices_LU;
 //SuperLU variables
 int *perm_c, *perm_r;
 SuperMatrix A_LU,B_LU;
+SuperMatrix L_LU,U_LU;			//Factors - kept between solutions while the symbolic factorization is reused
+bool LU_factored = false;		//L_LU and U_LU hold storage that still needs to be destroyed
+bool LU_symbolic_valid = false;	//perm_c (and the superLU_MT elimination tree) match the current matrix pattern
+#ifdef MT
+superlumt_options_t LU_MT_options;	//superLU_MT options - carries the elimination tree between factorizations
+#endif
 
 //External solver global
 void *ext_solver_glob_vars;
@@ -60,12 +66,20 @@ void *ext_solver_glob_vars;
 void sparse_init(SPARSE* sm, int nels, int ncols)
 {
 	int indexval;
-	
-	//Allocate the column pointer GLD heap
-	sm->cols = (SP_E**)gl_malloc(ncols*sizeof(SP_E*));
 
-	//Check it
-	if (sm->cols == NULL)
+	//Allocate the element arrays on the GLD heap
+	sm->row_ind = (int*)gl_malloc(nels*sizeof(int));
+	sm->col_ind = (int*)gl_malloc(nels*sizeof(int));
+	sm->value = (double*)gl_malloc(nels*sizeof(double));
+	sm->map = (unsigned int*)gl_malloc(nels*sizeof(unsigned int));
+	sm->perm = (unsigned int*)gl_malloc(nels*sizeof(unsigned int));
+	sm->rows = (int*)gl_malloc(nels*sizeof(int));
+
+	//Allocate the column starts (one extra for the end)
+	sm->cols = (int*)gl_malloc((ncols+1)*sizeof(int));
+
+	//Check them
+	if ((sm->row_ind == NULL) || (sm->col_ind == NULL) || (sm->value == NULL) || (sm->map == NULL) || (sm->perm == NULL) || (sm->rows == NULL) || (sm->cols == NULL))
 	{
 		GL_THROW("NR: Sparse matrix allocation failed");
 		/*  TROUBLESHOOT
@@ -73,152 +87,630 @@ void sparse_init(SPARSE* sm, int nels, int ncols)
 		Please try again.  If the error persists, please submit your code and a bug report via the ticketing system.
 		*/
 	}
-	else	//Zero it, for giggles
-	{
-		for (indexval=0; indexval<ncols; indexval++)
-		{
-			sm->cols[indexval] = NULL;
-		}
-	}
-
-	//Allocate the elements on the GLD heap
-	sm->llheap = (SP_E*)gl_malloc(nels*sizeof(SP_E));
-
-	//Check it
-	if (sm->llheap == NULL)
-	{
-		GL_THROW("NR: Sparse matrix allocation failed");
-		//Defined above
-	}
-	else	//Zero it, for giggles
+	else	//Invalidate the positions, so a stale pattern can never match
 	{
 		for (indexval=0; indexval<nels; indexval++)
 		{
-			sm->llheap[indexval].next = NULL;
-			sm->llheap[indexval].row_ind = -1;	//Invalid, so it gets upset if we use this (intentional)
-			sm->llheap[indexval].value = 0.0;
+			sm->row_ind[indexval] = -1;
+			sm->col_ind[indexval] = -1;
 		}
 	}
 
 	//Init others
+	sm->nels = nels;
 	sm->llptr = 0;
+	sm->nnz = 0;
 	sm->ncols = ncols;
+	sm->last_col = 0;
+	sm->pattern_valid = false;
+	sm->pattern_copied = false;
+	sm->copied_rows = NULL;
 }
 
 //Free up/clear the sparse allocations
 void sparse_clear(SPARSE* sm)
 {
 	//Clear them up
-	gl_free(sm->llheap);
+	gl_free(sm->row_ind);
+	gl_free(sm->col_ind);
+	gl_free(sm->value);
+	gl_free(sm->map);
+	gl_free(sm->perm);
+	gl_free(sm->rows);
 	gl_free(sm->cols);
 
 	//Null them, because I'm paranoid
-	sm->llheap = NULL;
+	sm->row_ind = NULL;
+	sm->col_ind = NULL;
+	sm->value = NULL;
+	sm->map = NULL;
+	sm->perm = NULL;
+	sm->rows = NULL;
 	sm->cols = NULL;
 
-	//Zero the last one
+	//Zero the rest
+	sm->nels = 0;
+	sm->nnz = 0;
 	sm->ncols = 0;
+	sm->pattern_valid = false;
+	sm->pattern_copied = false;
+	sm->copied_rows = NULL;
 }
 
+//Start a new pass of additions - the cached pattern survives if the same positions come back in the same order
 void sparse_reset(SPARSE* sm, int ncols)
 {
-	int indexval;
-
-	//Set the size
-	sm->ncols = ncols;
-
-	//Do brute force way, for paranoia
-	for (indexval=0; indexval<ncols; indexval++)
+	//A different column count always needs a new pattern
+	if (sm->ncols != ncols)
 	{
-		sm->cols[indexval] = NULL;
+		sm->ncols = ncols;
+		sm->pattern_valid = false;
 	}
-	
+
 	//Set the location pointer
 	sm->llptr = 0;
 }
 
-//Add in new elements to the sparse notation
+//Add in new elements to the sparse notation - just records the triplet and checks it against the cached pattern
 inline void sparse_add(SPARSE* sm, int row, int col, double value)
 {
-	SP_E* insertion_point = sm->cols[col];
-	SP_E* new_list_element = &(sm->llheap[sm->llptr++]);
+	unsigned int index = sm->llptr++;
+
+	//Position moved, so the pattern has to be rebuilt
+	if ((sm->row_ind[index] != row) || (sm->col_ind[index] != col))
+	{
+		sm->row_ind[index] = row;
+		sm->col_ind[index] = col;
+		sm->pattern_valid = false;
+	}
+
+	sm->value[index] = value;
+}
+
+//Build the compressed-column pattern and scatter map for the elements added since the last reset, if they changed
+void sparse_build(SPARSE* sm)
+{
+	unsigned int indexval, colval, start, stop, jindex, kindex, temp_perm;
 
-	new_list_element->next = NULL;
-	new_list_element->row_ind = row;
-	new_list_element->value = value;
+	//Same elements in the same places as last time - nothing to do
+	if (sm->pattern_valid && (sm->llptr == sm->nnz))
+		return;
 
-	//if there's a non empty list, traverse to find our rightful insertion point
-	if(insertion_point != NULL)
+	//Count the entries in each column
+	for (colval=0; colval<=sm->ncols; colval++)
 	{
-		if(insertion_point->row_ind > new_list_element->row_ind)
+		sm->cols[colval] = 0;
+	}
+
+	for (indexval=0; indexval<sm->llptr; indexval++)
+	{
+		sm->cols[sm->col_ind[indexval]+1]++;
+	}
+
+	//Turn the counts into column starts
+	for (colval=0; colval<sm->ncols; colval++)
+	{
+		sm->cols[colval+1] += sm->cols[colval];
+	}
+
+	//Stable counting sort by column - advances the column starts as it fills
+	for (indexval=0; indexval<sm->llptr; indexval++)
+	{
+		sm->map[indexval] = sm->cols[sm->col_ind[indexval]]++;
+	}
+
+	//Shift the column starts back to where they were
+	for (colval=sm->ncols; colval>0; colval--)
+	{
+		sm->cols[colval] = sm->cols[colval-1];
+	}
+	sm->cols[0] = 0;
+
+	for (indexval=0; indexval<sm->llptr; indexval++)
+	{
+		sm->perm[sm->map[indexval]] = indexval;
+	}
+
+	//Sort each column by row - columns are only a handful of entries long, so insertion sort it is
+	sm->last_col = 0;
+	for (colval=0; colval<sm->ncols; colval++)
+	{
+		start = sm->cols[colval];
+		stop = sm->cols[colval+1];
+
+		if (stop > start)
 		{
-			//insert the new list element at the first position
-			new_list_element->next = insertion_point;
-			sm->cols[col] = new_list_element;
+			sm->last_col = colval + 1;
 		}
-		else
+
+		for (jindex=start+1; jindex<stop; jindex++)
 		{
-			while((insertion_point->next != NULL) && (insertion_point->next->row_ind < new_list_element->row_ind))
+			temp_perm = sm->perm[jindex];
+
+			for (kindex=jindex; (kindex>start) && (sm->row_ind[sm->perm[kindex-1]] > sm->row_ind[temp_perm]); kindex--)
 			{
-				insertion_point = insertion_point->next;
+				sm->perm[kindex] = sm->perm[kindex-1];
 			}
 
-			//Duplicate check -- see how we exited
-			if (insertion_point->next != NULL)	//We exited because the next element is GEQ to the new element
+			sm->perm[kindex] = temp_perm;
+		}
+
+		for (jindex=start; jindex<stop; jindex++)
+		{
+			sm->rows[jindex] = sm->row_ind[sm->perm[jindex]];
+
+			if ((jindex > start) && (sm->rows[jindex] == sm->rows[jindex-1]))
 			{
-				if (insertion_point->next->row_ind == new_list_element->row_ind)	//Same entry (by column), so bad
+				GL_THROW("NR: duplicate admittance entry found - check for parallel circuits between common nodes!");
+				/*  TROUBLESHOOT
+				While building up the admittance matrix for the Newton-Raphson solver, a duplicate entry was found.
+				This is often caused by having multiple lines on the same phases in parallel between two nodes.  Please
+				reconcile this model difference and try again.
+				*/
+			}
+
+			sm->map[sm->perm[jindex]] = jindex;
+		}
+	}
+
+	sm->nnz = sm->llptr;
+	sm->pattern_valid = true;
+	sm->pattern_copied = false;
+}
+
+//Put the values into the solver's compressed-column arrays - the pattern is only copied when it changed or the arrays were reallocated
+//Returns true if the row/column structure was written (so any symbolic factorization of the old one is stale)
+bool sparse_tonr(SPARSE* sm, NR_SOLVER_VARS *matrices_LU, bool arrays_realloced)
+{
+	unsigned int indexval;
+	bool structure_changed = false;
+
+	if (arrays_realloced || !sm->pattern_copied || (sm->copied_rows != matrices_LU->rows_LU))
+	{
+		structure_changed = true;
+
+		for (indexval=0; indexval<sm->last_col; indexval++)
+		{
+			matrices_LU->cols_LU[indexval] = sm->cols[indexval];
+		}
+
+		for (indexval=0; indexval<sm->nnz; indexval++)
+		{
+			matrices_LU->rows_LU[indexval] = sm->rows[indexval];
+		}
+
+		sm->pattern_copied = true;
+		sm->copied_rows = matrices_LU->rows_LU;
+	}
+
+	//Scatter the values into their slots
+	for (indexval=0; indexval<sm->nnz; indexval++)
+	{
+		matrices_LU->a_LU[sm->map[indexval]] = sm->value[indexval];
+	}
+
+	return structure_changed;
+}
+
+//Destroy any kept superLU factors and forget the symbolic factorization
+void superLU_release(void)
+{
+	if (LU_factored)
+	{
+#ifdef MT
+		//superLU_MT commands
+		Destroy_SuperNode_SCP(&L_LU);
+		Destroy_CompCol_NCP(&U_LU);
+#else
+		//sequential superLU commands
+		Destroy_SuperNode_Matrix( &L_LU );
+		Destroy_CompCol_Matrix( &U_LU );
+#endif
+		LU_factored = false;
+	}
+
+#ifdef MT
+	if (LU_symbolic_valid)
+	{
+		//Elimination tree and supernode partition from the last full factorization
+		SUPERLU_FREE(LU_MT_options.etree);
+		SUPERLU_FREE(LU_MT_options.colcnt_h);
+		SUPERLU_FREE(LU_MT_options.part_super_h);
+	}
+#endif
+
+	LU_symbolic_valid = false;
+}
+
+/** Factor A_LU and solve it against B_LU in place
+	With NR_superLU_reuse_symbolic set, the column ordering (and for superLU_MT the elimination
+	tree and factor storage) from the previous factorization is reused until superLU_release()
+	is called, so only the numeric factorization is repeated.  Otherwise every call orders,
+	factors and cleans up from scratch, like pdgssv/dgssv.
+
+	@return superLU info - 0 on success
+ **/
+int superLU_factor_solve(void)
+{
+	int info = 0;
+#ifdef MT
+	//superLU_MT commands - same steps as pdgssv, but with the symbolic data kept around
+	Gstat_t Gstat;
+	SuperMatrix AC;
+	int panel_size = sp_ienv(1);
+	int relax = sp_ienv(2);
+	yes_no_t refact;
+
+	//Fresh ordering if there is nothing to reuse
+	if (!LU_symbolic_valid || !NR_superLU_reuse_symbolic)
+	{
+		superLU_release();
+
+		//Populate perm_c
+		get_perm_c(1, &A_LU, perm_c);
+		refact = NO;
+	}
+	else
+	{
+		refact = YES;
+	}
+
+	StatAlloc(A_LU.ncol, NR_superLU_procs, panel_size, relax, &Gstat);
+	StatInit(A_LU.ncol, NR_superLU_procs, &Gstat);
+
+	//Column permutation and (for a full factorization) elimination tree and postordering of perm_c
+	pdgstrf_init(NR_superLU_procs, EQUILIBRATE, NOTRANS, refact, panel_size, relax, 1.0, NO, 0.0, perm_c, perm_r, NULL, 0, &A_LU, &AC, &LU_MT_options, &Gstat);
+
+	//Numeric factorization - with refact, into the existing L/U storage
+	pdgstrf(&LU_MT_options, &AC, perm_r, &L_LU, &U_LU, &Gstat, &info);
+	LU_factored = true;
+	LU_symbolic_valid = true;
+
+	//Solve the system
+	if (info == 0)
+	{
+		dgstrs(NOTRANS, &L_LU, &U_LU, perm_r, perm_c, &B_LU, &Gstat, &info);
+	}
+
+	//Permuted copy of A is rebuilt every time - the options keep the elimination tree
+	Destroy_CompCol_Permuted(&AC);
+	StatFree(&Gstat);
+#else
+	//sequential superLU
+	superlu_options_t options;
+	SuperLUStat_t stat;
+
+	/* superLU sequential options*/
+	set_default_options ( &options );
+
+	//dgssv always refactors, but the column ordering can still be handed back in
+	if (LU_symbolic_valid && NR_superLU_reuse_symbolic)
+	{
+		options.ColPerm = MY_PERMC;
+	}
+
+	StatInit ( &stat );
+
+	// solve the system
+	dgssv(&options, &A_LU, perm_c, perm_r, &L_LU, &U_LU, &B_LU, &stat, &info);
+	LU_factored = true;
+
+	StatFree ( &stat );
+#endif
+
+	/* De-allocate storage - superLU matrix types must be destroyed if they are not being reused, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
+#ifdef MT
+	//Failures always start over from a fresh ordering
+	if ((info != 0) || !NR_superLU_reuse_symbolic)
+	{
+		superLU_release();
+	}
+#else
+	//dgssv allocates new factors every time, so they always go - only the ordering is kept
+	superLU_release();
+	LU_symbolic_valid = ((info == 0) && NR_superLU_reuse_symbolic);
+#endif
+
+	return info;
+}
+
+//Most Y_offdiag_PQ elements one branch contributes - 3x3 phases, from and to sides, real and imaginary parts, two elements each
+#define NR_ADMIT_BRANCH_ELEMENTS 72
+
+/** Queue a branch whose admittance changed in place, like a switch, fuse or regulator operation
+	solver_nr then rebuilds the elements of this branch and the buses at its ends, instead of the
+	whole admittance, unless the system phasing changed as well.  Called with NR_swing_bus locked,
+	just like setting NR_admit_change.
+ **/
+void NR_admit_branch_change(int branch_ref)
+{
+	unsigned int indexer;
+
+	//Not part of the solver's branch list - let a full rebuild sort it out
+	if ((branch_ref < 0) || ((unsigned int)branch_ref >= NR_branch_count))
+	{
+		NR_admit_change = true;
+		return;
+	}
+
+	if (NR_admit_delta_branch == NULL)
+	{
+		NR_admit_delta_branch = (int *)gl_malloc(NR_branch_count*sizeof(int));
+
+		if (NR_admit_delta_branch == NULL)
+		{
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+			//Defined below
+		}
+	}
+
+	//Only queue it once
+	for (indexer=0; indexer<NR_admit_delta_count; indexer++)
+	{
+		if (NR_admit_delta_branch[indexer] == branch_ref)
+			return;
+	}
+
+	NR_admit_delta_branch[NR_admit_delta_count] = branch_ref;
+	NR_admit_delta_count++;
+}
+
+/** Size the patch bookkeeping for a full admittance build and record the phasing it is built with
+ **/
+void solver_nr_admit_track(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type)
+{
+	NR_ADMIT_DELTA *delta = &powerflow_values->admit_delta;
+	unsigned int indexer;
+
+	if ((delta->bus_count != bus_count) || (delta->branch_count != branch_count))
+	{
+		gl_free(delta->bus_phases);
+		gl_free(delta->branch_phases);
+		gl_free(delta->offdiag_start);
+		gl_free(delta->fixed_start);
+		gl_free(delta->bus_list);
+		gl_free(delta->work_start);
+		gl_free(delta->list_order);
+
+		delta->bus_phases = (unsigned char *)gl_malloc(bus_count*sizeof(unsigned char));
+		delta->branch_phases = (unsigned char *)gl_malloc(branch_count*sizeof(unsigned char));
+		delta->offdiag_start = (unsigned int *)gl_malloc((branch_count+1)*sizeof(unsigned int));
+		delta->fixed_start = (unsigned int *)gl_malloc((bus_count+1)*sizeof(unsigned int));
+		delta->bus_list = (int *)gl_malloc(bus_count*sizeof(int));
+		delta->work_start = (unsigned int *)gl_malloc((bus_count+branch_count+1)*sizeof(unsigned int));
+		delta->list_order = (unsigned int *)gl_malloc((bus_count+branch_count)*sizeof(unsigned int));
+
+		if ((delta->bus_phases == NULL) || (delta->branch_phases == NULL) || (delta->offdiag_start == NULL) || (delta->fixed_start == NULL) || (delta->bus_list == NULL) || (delta->work_start == NULL) || (delta->list_order == NULL))
+		{
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+			//Defined below
+		}
+
+		delta->bus_count = bus_count;
+		delta->branch_count = branch_count;
+	}
+
+	delta->dynamic = (powerflow_type != PF_NORMAL);
+
+	for (indexer=0; indexer<bus_count; indexer++)
+	{
+		delta->bus_phases[indexer] = bus[indexer].phases;
+	}
+
+	for (indexer=0; indexer<branch_count; indexer++)
+	{
+		delta->branch_phases[indexer] = branch[indexer].phases;
+	}
+}
+
+/** Check the queued branch changes can be patched into the last full admittance build
+	Bus phasing fixes where everything sits in the matrices, so it and the phasing of the other
+	branches must be what the build saw.  Lists the buses to rebuild and sizes the work space.
+	@return true if the patch can go ahead, false if the admittance has to be rebuilt
+ **/
+bool solver_nr_admit_patchable(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type)
+{
+	NR_ADMIT_DELTA *delta = &powerflow_values->admit_delta;
+	unsigned int indexer, kindexer, need;
+	int end_bus[2], jindex;
+	bool listed;
+
+	//Need a full build of this system to patch, with the same deltamode terms
+	if ((delta->bus_count != bus_count) || (delta->branch_count != branch_count) || (delta->dynamic != (powerflow_type != PF_NORMAL)))
+		return false;
+
+	for (indexer=0; indexer<bus_count; indexer++)
+	{
+		if (bus[indexer].phases != delta->bus_phases[indexer])
+			return false;
+	}
+
+	//Only the queued branches may have changed phasing
+	for (indexer=0; indexer<branch_count; indexer++)
+	{
+		if (branch[indexer].phases != delta->branch_phases[indexer])
+		{
+			listed = false;
+			for (kindexer=0; kindexer<NR_admit_delta_count; kindexer++)
+			{
+				if (NR_admit_delta_branch[kindexer] == (int)indexer)
 				{
-					GL_THROW("NR: duplicate admittance entry found - check for parallel circuits between common nodes!");
-					/*  TROUBLESHOOT
-					While building up the admittance matrix for the Newton-Raphson solver, a duplicate entry was found.
-					This is often caused by having multiple lines on the same phases in parallel between two nodes.  Please
-					reconcile this model difference and try again.
-					*/
+					listed = true;
+					break;
 				}
 			}
-			else	//No next item, so see if our value matches
+
+			if (!listed)
+				return false;
+		}
+	}
+
+	//Buses at either end of the queued branches
+	delta->bus_list_count = 0;
+	for (indexer=0; indexer<NR_admit_delta_count; indexer++)
+	{
+		end_bus[0] = branch[NR_admit_delta_branch[indexer]].from;
+		end_bus[1] = branch[NR_admit_delta_branch[indexer]].to;
+
+		for (jindex=0; jindex<2; jindex++)
+		{
+			listed = false;
+			for (kindexer=0; kindexer<delta->bus_list_count; kindexer++)
 			{
-				if (insertion_point->row_ind == new_list_element->row_ind)	//Same entry (by column), so bad
+				if (delta->bus_list[kindexer] == end_bus[jindex])
 				{
-					GL_THROW("NR: duplicate admittance entry found - check for parallel circuits between common nodes!");
-					//Defined above
+					listed = true;
+					break;
 				}
 			}
 
-			//insert the new list element at the next position
-			new_list_element->next = insertion_point->next;
-			insertion_point->next = new_list_element;
+			if (!listed)
+			{
+				delta->bus_list[delta->bus_list_count] = end_bus[jindex];
+				delta->bus_list_count++;
+			}
 		}
 	}
-	else
-		sm->cols[col] = new_list_element;
+
+	//Work space for the rebuilt branch elements - the at most two buses per branch need fewer
+	need = NR_admit_delta_count*NR_ADMIT_BRANCH_ELEMENTS;
+	if (need > delta->max_work)
+	{
+		gl_free(delta->work);
+
+		delta->work = (Y_NR *)gl_malloc(need*sizeof(Y_NR));
+
+		if (delta->work == NULL)
+		{
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+			//Defined below
+		}
+
+		delta->max_work = need;
+	}
+
+	return true;
 }
 
-void sparse_tonr(SPARSE* sm, NR_SOLVER_VARS *matrices_LU)
+/** Put the elements rebuilt in the work space in place of the listed branches' (or buses') old ones
+	If every group kept its positions, only the values are copied.  Otherwise the pattern changed, and the
+	array is spliced back together in its original order, so it reads exactly as a full build would.
+	@return true if the element array had to grow
+ **/
+bool solver_nr_admit_patch(Y_NR **elements, unsigned int *size, unsigned int *max_size, unsigned int *start, unsigned int start_count, int *list, unsigned int list_count, NR_ADMIT_DELTA *delta)
 {
-	//traverse each linked list, which are in order, and copy values into new array
-	unsigned int rowidx = 0;
-	unsigned int colidx = 0;
-	unsigned int i;
-	SP_E* LL_pointer;
-
-	matrices_LU->cols_LU[0] = 0;
-	LL_pointer = NULL;
-	for(i = 0; i < sm->ncols; i++)
+	unsigned int indexer, kindexer, old_start, new_start, new_total, dest, prev, run, item;
+	bool same, grown;
+	Y_NR *spliced;
+
+	//See if everything landed where it was
+	same = true;
+	for (indexer=0; (indexer<list_count) && same; indexer++)
+	{
+		old_start = start[list[indexer]];
+		new_start = delta->work_start[indexer];
+
+		if ((start[list[indexer]+1] - old_start) != (delta->work_start[indexer+1] - new_start))
+		{
+			same = false;
+			break;
+		}
+
+		for (kindexer=0; kindexer<(delta->work_start[indexer+1] - new_start); kindexer++)
+		{
+			if (((*elements)[old_start+kindexer].row_ind != delta->work[new_start+kindexer].row_ind) || ((*elements)[old_start+kindexer].col_ind != delta->work[new_start+kindexer].col_ind))
+			{
+				same = false;
+				break;
+			}
+		}
+	}
+
+	if (same)
+	{
+		for (indexer=0; indexer<list_count; indexer++)
+		{
+			old_start = start[list[indexer]];
+			new_start = delta->work_start[indexer];
+
+			for (kindexer=0; kindexer<(delta->work_start[indexer+1] - new_start); kindexer++)
+			{
+				(*elements)[old_start+kindexer].Y_value = delta->work[new_start+kindexer].Y_value;
+			}
+		}
+
+		return false;
+	}
+
+	//Order the list, so the untouched elements between its entries can be carried over in runs
+	for (indexer=0; indexer<list_count; indexer++)
+	{
+		for (kindexer=indexer; (kindexer>0) && (list[delta->list_order[kindexer-1]] > list[indexer]); kindexer--)
+		{
+			delta->list_order[kindexer] = delta->list_order[kindexer-1];
+		}
+		delta->list_order[kindexer] = indexer;
+	}
+
+	new_total = start[start_count];
+	for (indexer=0; indexer<list_count; indexer++)
+	{
+		new_total = new_total - (start[list[indexer]+1] - start[list[indexer]]) + (delta->work_start[indexer+1] - delta->work_start[indexer]);
+	}
+
+	grown = ((new_total/2) > *max_size);
+
+	spliced = (Y_NR *)gl_malloc((grown ? new_total : (*max_size)*2)*sizeof(Y_NR));
+
+	if (spliced == NULL)
+	{
+		GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+		//Defined below
+	}
+
+	dest = 0;
+	prev = 0;
+	for (kindexer=0; kindexer<=list_count; kindexer++)
 	{
-		LL_pointer = sm->cols[i];
-		if(LL_pointer != NULL)
+		//Untouched run up to the next listed entry (or the end) moves over as a block
+		item = ((kindexer<list_count) ? list[delta->list_order[kindexer]] : start_count);
+		run = start[prev];
+
+		memcpy(&spliced[dest],&(*elements)[run],(start[item] - run)*sizeof(Y_NR));
+
+		for (indexer=prev; indexer<item; indexer++)
 		{
-			matrices_LU->cols_LU[colidx++] = rowidx;
-		}		
-		while(LL_pointer != NULL)
+			start[indexer] = dest + (start[indexer] - run);
+		}
+		dest += start[item] - run;
+
+		if (kindexer == list_count)
 		{
-			matrices_LU->rows_LU[rowidx] = LL_pointer->row_ind; // row pointers of non zero values
-			matrices_LU->a_LU[rowidx] = LL_pointer->value;
-			++rowidx;
-			LL_pointer = LL_pointer->next;
-		}		
+			start[item] = dest;
+			break;
+		}
+
+		//Then the rebuilt elements of the entry itself
+		indexer = delta->list_order[kindexer];
+		new_start = delta->work_start[indexer];
+
+		memcpy(&spliced[dest],&delta->work[new_start],(delta->work_start[indexer+1] - new_start)*sizeof(Y_NR));
+
+		start[item] = dest;
+		dest += delta->work_start[indexer+1] - new_start;
+		prev = item + 1;
+	}
+
+	gl_free(*elements);
+	*elements = spliced;
+	*size = new_total/2;
+
+	if (grown)
+	{
+		*max_size = *size;
 	}
+
+	return grown;
 }
 
 /** Newton-Raphson solver
@@ -311,22 +803,23 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 	char work_vals_char_0;
 
 	//SuperLU variables
-	SuperMatrix L_LU,U_LU;
 	NCformat *Astore;
 	DNformat *Bstore;
 	int nnz, info;
 	unsigned int m,n;
 	double *sol_LU;
 
-	//Spare notation variable - for output
-	SP_E *temp_element;
+	//Spare notation variables
 	int row, col;
+	bool LU_realloced;
 	double value;
-	
-#ifndef MT
-	superlu_options_t options;	//Additional variables for sequential superLU
-	SuperLUStat_t stat;
-#endif
+
+	//Admittance update variables - a full rebuild, or a patch of the branches queued by NR_admit_branch_change
+	bool admit_rebuild, admit_patch;
+	unsigned int admit_index, admit_count;
+	unsigned int *admit_start;
+	Y_NR *admit_fill;
+	NR_ADMIT_DELTA *admit_delta = &powerflow_values->admit_delta;
 
 	//Ensure bad computations flag is set first
 	*bad_computations = false;
@@ -379,7 +872,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		avalsq = 0.0;
 	}
 
-	if (matrix_solver_method==MM_EXTERN)
+	if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))
 	{
 		//Call the initialization routine
 		ext_solver_glob_vars = ((void *(*)(void *))(LUSolverFcns.ext_init))(ext_solver_glob_vars);
@@ -396,8 +889,18 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		}
 	}
 
-	if (NR_admit_change)	//If an admittance update was detected, fix it
+	//Changes confined to the queued branches are patched into the last build, anything else rebuilds it all
+	admit_patch = ((NR_admit_change == false) && (NR_admit_delta_count > 0) && solver_nr_admit_patchable(bus_count,bus,branch_count,branch,powerflow_values,powerflow_type));
+	admit_rebuild = (NR_admit_change || ((NR_admit_delta_count > 0) && (admit_patch == false)));
+
+	if (admit_rebuild || admit_patch)	//If an admittance update was detected, fix it
 	{
+		//Record the phasing of a full build, so later branch changes can be patched into it
+		if (admit_patch == false)
+		{
+			solver_nr_admit_track(bus_count,bus,branch_count,branch,powerflow_values,powerflow_type);
+		}
+
 		//Build the diagnoal elements of the bus admittance matrix - this should only happen once no matter what
 		if (powerflow_values->BA_diag == NULL)
 		{
@@ -415,8 +918,13 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			}
 		}
 		
-		for (indexer=0; indexer<bus_count; indexer++) // Construct the diagonal elements of Bus admittance matrix.
+		//A patch only redoes the buses at the ends of the queued branches
+		admit_count = (admit_patch ? admit_delta->bus_list_count : bus_count);
+
+		for (admit_index=0; admit_index<admit_count; admit_index++) // Construct the diagonal elements of Bus admittance matrix.
 		{
+			indexer = (admit_patch ? admit_delta->bus_list[admit_index] : admit_index);
+
 			//Determine the size we need
 			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
 				powerflow_values->BA_diag[indexer].size = 2;
@@ -729,10 +1237,13 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 					;
 			}//branch traversion end
 
-			//Store the self admittance into BA_diag.  Also update the indices for possible use later
-			powerflow_values->BA_diag[indexer].col_ind = powerflow_values->BA_diag[indexer].row_ind = index_count;	// Store the row and column starting information (square matrices)
-			bus[indexer].Matrix_Loc = index_count;								//Store our location so we know where we go
-			index_count += powerflow_values->BA_diag[indexer].size;				// Update the index for this matrix's size, so next one is in appropriate place
+			//Store the self admittance into BA_diag.  Also update the indices for possible use later - a patch keeps the ones it has
+			if (admit_patch == false)
+			{
+				powerflow_values->BA_diag[indexer].col_ind = powerflow_values->BA_diag[indexer].row_ind = index_count;	// Store the row and column starting information (square matrices)
+				bus[indexer].Matrix_Loc = index_count;								//Store our location so we know where we go
+				index_count += powerflow_values->BA_diag[indexer].size;				// Update the index for this matrix's size, so next one is in appropriate place
+			}
 
 
 			//Store the admittance values into the BA_diag matrix structure
@@ -757,155 +1268,176 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			}//End self-admittance update
 		}//End diagonal construction
 
-		//Store the size of the diagonal, since it represents how many variables we are solving (useful later)
-		powerflow_values->total_variables=index_count;
-
-		//Check to see if we've exceeded our max.  If so, reallocate!
-		if (powerflow_values->total_variables > powerflow_values->max_total_variables)
-			powerflow_values->NR_realloc_needed = true;
-
-		/// Build the off_diagonal_PQ bus elements of 6n*6n Y_NR matrix.Equation (12). All the value in this part will not be updated at each iteration.
-		//Constructed using sparse methodology, non-zero elements are the only thing considered (and non-PV)
-		//No longer necessarily 6n*6n any more either,
-		powerflow_values->size_offdiag_PQ = 0;
-		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse all of the branches
+		//Sizes and locations only change with a full build
+		if (admit_patch == false)
 		{
-			tempa  = branch[jindexer].from;
-			tempb  = branch[jindexer].to;
-
-			//Preliminary check to make sure we weren't missed in the initialization
-			if ((bus[tempa].Matrix_Loc == -1) || (bus[tempb].Matrix_Loc == -1))
+			//Store the size of the diagonal, since it represents how many variables we are solving (useful later)
+			powerflow_values->total_variables=index_count;
+
+			//Check to see if we've exceeded our max.  If so, reallocate!
+			if (powerflow_values->total_variables > powerflow_values->max_total_variables)
+				powerflow_values->NR_realloc_needed = true;
+
+			/// Build the off_diagonal_PQ bus elements of 6n*6n Y_NR matrix.Equation (12). All the value in this part will not be updated at each iteration.
+			//Constructed using sparse methodology, non-zero elements are the only thing considered (and non-PV)
+			//No longer necessarily 6n*6n any more either,
+			powerflow_values->size_offdiag_PQ = 0;
+			for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse all of the branches
 			{
-				GL_THROW("An element in NR line:%d was not properly localized");
-				/*  TROUBLESHOOT
-				When parsing the bus list, the Newton-Raphson solver found a bus that did not
-				appear to have a location within the overall admittance/Jacobian matrix.  Please
-				submit this as a bug with your code on the Trac site.
-				*/
-			}
+				tempa  = branch[jindexer].from;
+				tempb  = branch[jindexer].to;
 
-			if (((branch[jindexer].phases & 0x80) == 0x80) && (branch[jindexer].v_ratio==1.0))	//Triplex, but not SPCT
-			{
-				for (jindex=0; jindex<2; jindex++)			//rows
+				//Preliminary check to make sure we weren't missed in the initialization
+				if ((bus[tempa].Matrix_Loc == -1) || (bus[tempb].Matrix_Loc == -1))
+				{
+					GL_THROW("An element in NR line:%d was not properly localized");
+					/*  TROUBLESHOOT
+					When parsing the bus list, the Newton-Raphson solver found a bus that did not
+					appear to have a location within the overall admittance/Jacobian matrix.  Please
+					submit this as a bug with your code on the Trac site.
+					*/
+				}
+
+				if (((branch[jindexer].phases & 0x80) == 0x80) && (branch[jindexer].v_ratio==1.0))	//Triplex, but not SPCT
 				{
-					for (kindex=0; kindex<2; kindex++)		//columns
+					for (jindex=0; jindex<2; jindex++)			//rows
 					{
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-							powerflow_values->size_offdiag_PQ += 1; 
+						for (kindex=0; kindex<2; kindex++)		//columns
+						{
+							if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+								powerflow_values->size_offdiag_PQ += 1; 
 
-						if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-							powerflow_values->size_offdiag_PQ += 1; 
+							if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+								powerflow_values->size_offdiag_PQ += 1; 
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-							powerflow_values->size_offdiag_PQ += 1; 
+							if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+								powerflow_values->size_offdiag_PQ += 1; 
 
-						if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-							powerflow_values->size_offdiag_PQ += 1; 
-					}//end columns of split phase
-				}//end rows of split phase
-			}//end traversion of split-phase
-			else											//Three phase or some variety
-			{
-				//Make sure we aren't SPCT, otherwise things get jacked
-				if ((branch[jindexer].phases & 0x80) != 0x80)	//SPCT, but v_ratio not = 1
+							if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+								powerflow_values->size_offdiag_PQ += 1; 
+						}//end columns of split phase
+					}//end rows of split phase
+				}//end traversion of split-phase
+				else											//Three phase or some variety
 				{
-					for (jindex=0; jindex<3; jindex++)			//rows
+					//Make sure we aren't SPCT, otherwise things get jacked
+					if ((branch[jindexer].phases & 0x80) != 0x80)	//SPCT, but v_ratio not = 1
 					{
-						//See if this phase is valid
-						phase_workb = 0x04 >> jindex;
-
-						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+						for (jindex=0; jindex<3; jindex++)			//rows
 						{
-							for (kindex=0; kindex<3; kindex++)		//columns
+							//See if this phase is valid
+							phase_workb = 0x04 >> jindex;
+
+							if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
 							{
-								//Check this phase as well
-								phase_workd = 0x04 >> kindex;
+								for (kindex=0; kindex<3; kindex++)		//columns
+								{
+									//Check this phase as well
+									phase_workd = 0x04 >> kindex;
 
-								if ((phase_workd & branch[jindexer].phases) == phase_workd)	//Column validity check
+									if ((phase_workd & branch[jindexer].phases) == phase_workd)	//Column validity check
+									{
+										if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+											powerflow_values->size_offdiag_PQ += 1; 
+
+										if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+											powerflow_values->size_offdiag_PQ += 1; 
+
+										if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+											powerflow_values->size_offdiag_PQ += 1; 
+
+										if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+											powerflow_values->size_offdiag_PQ += 1; 
+									}//end column validity check
+								}//end columns of 3 phase
+							}//End row validity check
+						}//end rows of 3 phase
+					}//end not SPCT
+					else	//SPCT inmplementation
+					{
+						for (jindex=0; jindex<3; jindex++)			//rows
+						{
+							//See if this phase is valid
+							phase_workb = 0x04 >> jindex;
+
+							if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+							{
+								for (kindex=0; kindex<3; kindex++)		//Row valid, traverse all columns for SPCT Yfrom
 								{
 									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
 										powerflow_values->size_offdiag_PQ += 1; 
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
 										powerflow_values->size_offdiag_PQ += 1; 
+								}//end columns traverse
 
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+								//If row is valid, now traverse the rows of that column for Yto
+								for (kindex=0; kindex<3; kindex++)
+								{
+									if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
 										powerflow_values->size_offdiag_PQ += 1; 
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+									if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
 										powerflow_values->size_offdiag_PQ += 1; 
-								}//end column validity check
-							}//end columns of 3 phase
-						}//End row validity check
-					}//end rows of 3 phase
-				}//end not SPCT
-				else	//SPCT inmplementation
-				{
-					for (jindex=0; jindex<3; jindex++)			//rows
-					{
-						//See if this phase is valid
-						phase_workb = 0x04 >> jindex;
+								}//end rows traverse
+							}//End row validity check
+						}//end rows of 3 phase
+					}//End SPCT
+				}//end three phase
+			}//end line traversion
+
+			//Allocate the space - double the number found (each element goes in two places)
+			if (powerflow_values->Y_offdiag_PQ == NULL)
+			{
+				powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));   //powerflow_values->Y_offdiag_PQ store the row,column and value of off_diagonal elements of Bus Admittance matrix in which all the buses are not PV buses. 
 
-						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
-						{
-							for (kindex=0; kindex<3; kindex++)		//Row valid, traverse all columns for SPCT Yfrom
-							{
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-									powerflow_values->size_offdiag_PQ += 1; 
+				//Make sure it worked
+				if (powerflow_values->Y_offdiag_PQ == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-									powerflow_values->size_offdiag_PQ += 1; 
-							}//end columns traverse
+				//Save our size
+				powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;	//Don't care about the 2x, since we'll be comparing it against itself
+			}
+			else if (powerflow_values->size_offdiag_PQ > powerflow_values->max_size_offdiag_PQ)	//Something changed and we are bigger!!
+			{
+				//Destroy us!
+				gl_free(powerflow_values->Y_offdiag_PQ);
 
-							//If row is valid, now traverse the rows of that column for Yto
-							for (kindex=0; kindex<3; kindex++)
-							{
-								if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-									powerflow_values->size_offdiag_PQ += 1; 
+				//Rebuild us, we have the technology
+				powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));
 
-								if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-									powerflow_values->size_offdiag_PQ += 1; 
-							}//end rows traverse
-						}//End row validity check
-					}//end rows of 3 phase
-				}//End SPCT
-			}//end three phase
-		}//end line traversion
+				//Make sure it worked
+				if (powerflow_values->Y_offdiag_PQ == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-		//Allocate the space - double the number found (each element goes in two places)
-		if (powerflow_values->Y_offdiag_PQ == NULL)
-		{
-			powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));   //powerflow_values->Y_offdiag_PQ store the row,column and value of off_diagonal elements of Bus Admittance matrix in which all the buses are not PV buses. 
+				//Store the new size
+				powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;
 
-			//Make sure it worked
-			if (powerflow_values->Y_offdiag_PQ == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+				//Flag for a reallocation
+				powerflow_values->NR_realloc_needed = true;
+			}
+		}
 
-			//Save our size
-			powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;	//Don't care about the 2x, since we'll be comparing it against itself
+		//Note where each branch's elements go - a patch rebuilds the queued branches into the work space to check against that
+		if (admit_patch)
+		{
+			admit_fill = admit_delta->work;
+			admit_start = admit_delta->work_start;
+			admit_count = NR_admit_delta_count;
 		}
-		else if (powerflow_values->size_offdiag_PQ > powerflow_values->max_size_offdiag_PQ)	//Something changed and we are bigger!!
+		else
 		{
-			//Destroy us!
-			gl_free(powerflow_values->Y_offdiag_PQ);
-
-			//Rebuild us, we have the technology
-			powerflow_values->Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->size_offdiag_PQ*2) *sizeof(Y_NR));
-
-			//Make sure it worked
-			if (powerflow_values->Y_offdiag_PQ == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Store the new size
-			powerflow_values->max_size_offdiag_PQ = powerflow_values->size_offdiag_PQ;
-
-			//Flag for a reallocation
-			powerflow_values->NR_realloc_needed = true;
+			admit_fill = powerflow_values->Y_offdiag_PQ;
+			admit_start = admit_delta->offdiag_start;
+			admit_count = branch_count;
 		}
 
 		indexer = 0;
-		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse through all of the branches
+		for (admit_index=0; admit_index<admit_count; admit_index++)	//Parse through all of the branches
 		{
+			jindexer = (admit_patch ? NR_admit_delta_branch[admit_index] : admit_index);
+			admit_start[admit_index] = indexer;
+
 			//Extract both ends
 			tempa  = branch[jindexer].from;
 			tempb  = branch[jindexer].to;
@@ -937,49 +1469,49 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 								//Indices counted out from Self admittance above.  needs doubling due to complex separation
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
 									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
+									admit_fill[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
 									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
+									admit_fill[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 							}//End valid column
@@ -1011,53 +1543,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = -(branch[jindexer].Yfrom[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 							}//end From end SPCT to
@@ -1067,53 +1599,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 							}//end To end SPCT to
@@ -1123,53 +1655,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
 									indexer += 1;
 								}
 
 								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 
 								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
 								{
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;
 									
-									powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									admit_fill[indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
 									indexer += 1;	
 								}
 							}//end Normal triplex branch
@@ -1360,53 +1892,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 
 						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+							admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
 							indexer += 1;
 							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+							admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							admit_fill[indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
 							indexer += 1;
 						}
 
 						if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Im());
+							admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							admit_fill[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Im());
 							indexer += 1;
 							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = (branch[jindexer].Yto[kindex*3+jindex]).Im();
+							admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							admit_fill[indexer].Y_value = (branch[jindexer].Yto[kindex*3+jindex]).Im();
 							indexer += 1;
 						}
 
 						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+							admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 							indexer += 1;
 							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+							admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							admit_fill[indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
 							indexer += 1;	
 						}
 
 						if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
 						{
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
+							admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							admit_fill[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
 							indexer += 1;
 							
-							powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->Y_offdiag_PQ[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
+							admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							admit_fill[indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
 							indexer += 1;	
 						}
 					}//secondary index end
@@ -1831,53 +2363,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 							//Indices counted out from Self admittance above.  needs doubling due to complex separation
 							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								admit_fill[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
 								indexer += 1;
 							}
 
 							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
+								admit_fill[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
 								indexer += 1;
 							}
 
 							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
 								indexer += 1;	
 							}
 
 							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
 								indexer += 1;	
 							}
 						}//column end
@@ -1893,53 +2425,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 							//Indices counted out from Self admittance above.  needs doubling due to complex separation
 							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
+								admit_fill[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
 								indexer += 1;
 							}
 
 							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								admit_fill[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
 								indexer += 1;
 							}
 
 							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
 								indexer += 1;	
 							}
 
 							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
 								indexer += 1;	
 							}
 						}//column end
@@ -1955,53 +2487,53 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 							//Indices counted out from Self admittance above.  needs doubling due to complex separation
 							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								admit_fill[indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
 								indexer += 1;
 							}
 
 							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								admit_fill[indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
 								indexer += 1;
 							}
 
 							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								admit_fill[indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
 								indexer += 1;	
 							}
 
 							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
 							{
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
 								indexer += 1;
 								
-								powerflow_values->Y_offdiag_PQ[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->Y_offdiag_PQ[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->Y_offdiag_PQ[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								admit_fill[indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								admit_fill[indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								admit_fill[indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
 								indexer += 1;	
 							}
 						}//column end
@@ -2009,90 +2541,135 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 				}//end not full ABC with AC on either side case
 			}//end all others else
 		}//end branch for
+		admit_start[admit_count] = indexer;
 
-		//Build the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix. This part will not be updated at each iteration. 
-		powerflow_values->size_diag_fixed = 0;
-		for (jindexer=0; jindexer<bus_count;jindexer++) 
+		//Put the rebuilt branch elements in place of the old ones
+		if (admit_patch && solver_nr_admit_patch(&powerflow_values->Y_offdiag_PQ,&powerflow_values->size_offdiag_PQ,&powerflow_values->max_size_offdiag_PQ,admit_delta->offdiag_start,branch_count,NR_admit_delta_branch,NR_admit_delta_count,admit_delta))
 		{
-			for (jindex=0; jindex<3; jindex++)
-			{
-				for (kindex=0; kindex<3; kindex++)
-				{		 
-				  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)  
-					  powerflow_values->size_diag_fixed += 1; 
-				  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex) 
-					  powerflow_values->size_diag_fixed += 1; 
-				  else {}
-				 }
-			}
+			powerflow_values->NR_realloc_needed = true;	//Grew past the old allocation
 		}
-		if (powerflow_values->Y_diag_fixed == NULL)
-		{
-			powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));   //powerflow_values->Y_diag_fixed store the row,column and value of the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
 
-			//Make sure it worked
+		if (admit_patch == false)
+		{
+			//Build the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix. This part will not be updated at each iteration. 
+			powerflow_values->size_diag_fixed = 0;
+			for (jindexer=0; jindexer<bus_count;jindexer++) 
+			{
+				for (jindex=0; jindex<3; jindex++)
+				{
+					for (kindex=0; kindex<3; kindex++)
+					{		 
+					  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)  
+						  powerflow_values->size_diag_fixed += 1; 
+					  if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex) 
+						  powerflow_values->size_diag_fixed += 1; 
+					  else {}
+					 }
+				}
+			}
 			if (powerflow_values->Y_diag_fixed == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+			{
+				powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));   //powerflow_values->Y_diag_fixed store the row,column and value of the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
 
-			//Update the max size
-			powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
-		}
-		else if (powerflow_values->size_diag_fixed > powerflow_values->max_size_diag_fixed)		//Something changed and we are bigger!!
-		{
-			//Destroy us!
-			gl_free(powerflow_values->Y_diag_fixed);
+				//Make sure it worked
+				if (powerflow_values->Y_diag_fixed == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-			//Rebuild us, we have the technology
-			powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));
+				//Update the max size
+				powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
+			}
+			else if (powerflow_values->size_diag_fixed > powerflow_values->max_size_diag_fixed)		//Something changed and we are bigger!!
+			{
+				//Destroy us!
+				gl_free(powerflow_values->Y_diag_fixed);
 
-			//Make sure it worked
-			if (powerflow_values->Y_diag_fixed == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+				//Rebuild us, we have the technology
+				powerflow_values->Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->size_diag_fixed*2) *sizeof(Y_NR));
 
-			//Store the new size
-			powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
+				//Make sure it worked
+				if (powerflow_values->Y_diag_fixed == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-			//Flag for a reallocation
-			powerflow_values->NR_realloc_needed = true;
+				//Store the new size
+				powerflow_values->max_size_diag_fixed = powerflow_values->size_diag_fixed;
+
+				//Flag for a reallocation
+				powerflow_values->NR_realloc_needed = true;
+			}
+		}
+
+		//Same again for the fixed diagonal elements of each bus
+		if (admit_patch)
+		{
+			admit_fill = admit_delta->work;
+			admit_start = admit_delta->work_start;
+			admit_count = admit_delta->bus_list_count;
+		}
+		else
+		{
+			admit_fill = powerflow_values->Y_diag_fixed;
+			admit_start = admit_delta->fixed_start;
+			admit_count = bus_count;
 		}
 
 		indexer = 0;
-		for (jindexer=0; jindexer<bus_count;jindexer++)	//Parse through bus list
+		for (admit_index=0; admit_index<admit_count; admit_index++)	//Parse through bus list
 		{ 
+			jindexer = (admit_patch ? admit_delta->bus_list[admit_index] : admit_index);
+			admit_start[admit_index] = indexer;
+
 			for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
 			{
 				for (kindex=0; kindex<powerflow_values->BA_diag[jindexer].size; kindex++)
 				{					
 					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
 					{
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
+						admit_fill[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
+						admit_fill[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
+						admit_fill[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
 						indexer += 1;
 
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
+						admit_fill[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
+						admit_fill[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
+						admit_fill[indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
 						indexer += 1;
 					}
 
 					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
 					{
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
+						admit_fill[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
+						admit_fill[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
+						admit_fill[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
 						indexer += 1;
 						
-						powerflow_values->Y_diag_fixed[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->Y_diag_fixed[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
-						powerflow_values->Y_diag_fixed[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
+						admit_fill[indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
+						admit_fill[indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
+						admit_fill[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
 						indexer += 1;
 					}
 				}
 			}
 		}//End bus parse for fixed diagonal
+		admit_start[admit_count] = indexer;
+
+		if (admit_patch)
+		{
+			if (solver_nr_admit_patch(&powerflow_values->Y_diag_fixed,&powerflow_values->size_diag_fixed,&powerflow_values->max_size_diag_fixed,admit_delta->fixed_start,bus_count,admit_delta->bus_list,admit_delta->bus_list_count,admit_delta))
+			{
+				powerflow_values->NR_realloc_needed = true;	//Grew past the old allocation
+			}
+
+			//The queued branches' phasing is now part of the build
+			for (admit_index=0; admit_index<NR_admit_delta_count; admit_index++)
+			{
+				admit_delta->branch_phases[NR_admit_delta_branch[admit_index]] = branch[NR_admit_delta_branch[admit_index]].phases;
+			}
+		}
 	}//End admittance update
 
+	//Queued branch changes are in, either way
+	NR_admit_delta_count = 0;
+
 	//Reset saturation checks
 	SaturationMismatchPresent = false;
 
@@ -5096,6 +5673,9 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			sparse_add(powerflow_values->Y_Amatrix, row, col, value);
 		}
 
+		//Sort into compressed columns - only does work if the pattern changed since the last pass
+		sparse_build(powerflow_values->Y_Amatrix);
+
 		//See if we want to dump out the matrix values
 		if (NRMatDumpMethod != MD_NONE)
 		{
@@ -5138,32 +5718,14 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 				//Header
 				fprintf(FPoutVal,"Matrix Information - row, column, value\n");
 
-				//Null temp variable
-				temp_element = NULL;
-
-				//Loop through the columns, extracting starting point each time
+				//Loop through the columns of the compressed pattern
 				for (jindexer=0; jindexer<powerflow_values->Y_Amatrix->ncols; jindexer++)
 				{
-					//Extract the column starting point
-					temp_element = powerflow_values->Y_Amatrix->cols[jindexer];
-
-					//Check for nulling
-					if (temp_element != NULL)
+					//Print each entry in this column - empty columns imply an invalid matrix size, but that may be what we're looking for
+					for (kindexer=powerflow_values->Y_Amatrix->cols[jindexer]; kindexer<powerflow_values->Y_Amatrix->cols[jindexer+1]; kindexer++)
 					{
-						//Print this value
-						fprintf(FPoutVal,"%d,%d,%f\n",temp_element->row_ind,jindexer,temp_element->value);
-
-						//Loop
-						while (temp_element->next != NULL)
-						{
-							//Get next element
-							temp_element = temp_element->next;
-
-							//Repeat the print
-							fprintf(FPoutVal,"%d,%d,%f\n",temp_element->row_ind,jindexer,temp_element->value);
-						}
+						fprintf(FPoutVal,"%d,%d,%f\n",powerflow_values->Y_Amatrix->rows[kindexer],jindexer,powerflow_values->Y_Amatrix->value[powerflow_values->Y_Amatrix->perm[kindexer]]);
 					}
-					//If it is null, go next.  Implies we have an invalid matrix size, but that may be what we're looking for
 				}//End sparse matrix traversion for dump
 
 				//Print an extra line, so it looks nice for ALL/PERCALL
@@ -5184,9 +5746,12 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		m = 2*powerflow_values->total_variables;
 		n = 2*powerflow_values->total_variables;
 		nnz = size_Amatrix;
+		LU_realloced = false;
 
 		if (matrices_LU.a_LU == NULL)	//First run
 		{
+			LU_realloced = true;
+
 			/* Set aside space for the arrays. */
 			matrices_LU.a_LU = (double *) gl_malloc(nnz *sizeof(double));
 			if (matrices_LU.a_LU==NULL)
@@ -5246,7 +5811,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 				B_LU.nrow = m;
 				B_LU.ncol = 1;
 			}
-			else if (matrix_solver_method == MM_EXTERN)	//External routine
+			else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))	//External or built-in KLU routine
 			{
 				//Run allocation routine
 				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,NR_admit_change);
@@ -5262,6 +5827,8 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		}
 		else if (powerflow_values->NR_realloc_needed)	//Something changed, we'll just destroy everything and start over
 		{
+			LU_realloced = true;
+
 			//Get rid of all of them first
 			gl_free(matrices_LU.a_LU);
 			gl_free(matrices_LU.rows_LU);
@@ -5319,7 +5886,7 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 				B_LU.nrow = m;
 				B_LU.ncol = 1;
 			}
-			else if (matrix_solver_method == MM_EXTERN)	//External routine
+			else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))	//External or built-in KLU routine
 			{
 				//Run allocation routine
 				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,NR_admit_change);
@@ -5337,13 +5904,16 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		{
 			if (matrix_solver_method==MM_SUPERLU)
 			{
+				//Kept factors are the wrong size now
+				superLU_release();
+
 				//Update relevant portions
 				A_LU.nrow = n;
 				A_LU.ncol = m;
 
 				B_LU.nrow = m;
 			}
-			else if (matrix_solver_method == MM_EXTERN)	//External routine - call full reallocation, just in case
+			else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))	//External or built-in KLU routine - call full reallocation, just in case
 			{
 				//Run allocation routine
 				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(ext_solver_glob_vars,n,n,NR_admit_change);
@@ -5358,16 +5928,11 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			powerflow_values->prev_m = m;
 		}
 
-#ifndef MT
-		if (matrix_solver_method==MM_SUPERLU)
+		//New structure means the kept ordering no longer applies
+		if (sparse_tonr(powerflow_values->Y_Amatrix, &matrices_LU, LU_realloced) && (matrix_solver_method==MM_SUPERLU))
 		{
-			/* superLU sequential options*/
-			set_default_options ( &options );
+			superLU_release();
 		}
-		//Default else - not superLU
-#endif
-		
-		sparse_tonr(powerflow_values->Y_Amatrix, &matrices_LU);
 		matrices_LU.cols_LU[n] = nnz ;// number of non-zeros;
 
 		//Determine how to populate the rhs vector
@@ -5475,34 +6040,9 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 					//"Identity"-ize the real part of the current index
 					matrices_LU.rhs_LU[tempa + kindex] = 1.0;
 
-					//Do a solution to get this entry (copied from below - includes "destructors"
-#ifdef MT
-					//superLU_MT commands
-
-					//Populate perm_c
-					get_perm_c(1, &A_LU, perm_c);
-
-					//Solve the system 
-					pdgssv(NR_superLU_procs, &A_LU, perm_c, perm_r, &L_LU, &U_LU, &B_LU, &info);
-
-					/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
-					//superLU_MT commands
-					Destroy_SuperNode_SCP(&L_LU);
-					Destroy_CompCol_NCP(&U_LU);
-#else
-					//sequential superLU
-
-					StatInit ( &stat );
-
-					// solve the system
-					dgssv(&options, &A_LU, perm_c, perm_r, &L_LU, &U_LU, &B_LU, &stat, &info);
+					//Do a solution to get this entry - only the first one orders the matrix when reuse is enabled
+					info = superLU_factor_solve();
 
-					/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
-					//sequential superLU commands
-					Destroy_SuperNode_Matrix( &L_LU );
-					Destroy_CompCol_Matrix( &U_LU );
-					StatFree ( &stat );
-#endif
 					//Crude superLU checks - see if it is mission accomplished or not
 					if (info != 0)	//Failed inversion, for various reasons
 					{
@@ -5623,27 +6163,13 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 			}//End "just mesh impedance calculations"
 			else	//Nulled, "normal" powerflow
 			{
-#ifdef MT
-				//superLU_MT commands
-
-				//Populate perm_c
-				get_perm_c(1, &A_LU, perm_c);
-
 				//Solve the system
-				pdgssv(NR_superLU_procs, &A_LU, perm_c, perm_r, &L_LU, &U_LU, &B_LU, &info);
-#else
-				//sequential superLU
-
-				StatInit ( &stat );
-
-				// solve the system
-				dgssv(&options, &A_LU, perm_c, perm_r, &L_LU, &U_LU, &B_LU, &stat, &info);
-#endif
+				info = superLU_factor_solve();
 
 				sol_LU = (double*) ((DNformat*) B_LU.Store)->nzval;
 			}
 		}
-		else if (matrix_solver_method==MM_EXTERN)
+		else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))
 		{
 			//General error check right now -- mesh fault current may not work properly
 			if (mesh_imped_vals != NULL)
@@ -5900,19 +6426,9 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 
 		if (matrix_solver_method==MM_SUPERLU)
 		{
-			/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
-#ifdef MT
-			//superLU_MT commands
-			Destroy_SuperNode_SCP(&L_LU);
-			Destroy_CompCol_NCP(&U_LU);
-#else
-			//sequential superLU commands
-			Destroy_SuperNode_Matrix( &L_LU );
-			Destroy_CompCol_Matrix( &U_LU );
-			StatFree ( &stat );
-#endif
+			//Factors were already cleaned up (or kept for the next refactorization) by superLU_factor_solve
 		}
-		else if (matrix_solver_method==MM_EXTERN)
+		else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))
 		{
 			//Call destruction routine
 			((void (*)(void *, bool))(LUSolverFcns.ext_destroy))(ext_solver_glob_vars,newiter);
@@ -5951,6 +6467,10 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		{
 			gl_verbose("External LU solver failed out with return value %d",info);
 		}
+		else if (matrix_solver_method==MM_KLU)
+		{
+			gl_verbose("KLU solver failed out with return value %d",info);
+		}
 		//Defaulted else - shouldn't exist (or make it this far), but if it does, we're failing anyways
 
 		*bad_computations = true;	//Flag our output as bad
@@ -96,21 +96,45 @@ typedef enum {
 	PF_DYNCALC=2	///< Modified powerflow, for dynamics mode after initial powerflow
 	} NRSOLVERMODE;
 
-// Sparse element
-typedef struct SP_E {
-	struct SP_E* next;
-	int row_ind;  ///< row location of the element
-    double value; ///< value of the element
-} SP_E;
-
-// Sparse matrix
+// Sparse matrix - elements arrive as (row,col,value) triplets in a fixed order every iteration.
+// The compressed-column pattern is only rebuilt when that order of positions changes; otherwise
+// the values are scattered straight into their cached slots.
 typedef struct {
-	SP_E** cols;
-	SP_E* llheap;
-	unsigned int llptr;
-	unsigned int ncols;
+	int *row_ind;			///< row of each element, in the order it was added
+	int *col_ind;			///< column of each element, in the order it was added
+	double *value;			///< value of each element, in the order it was added
+	unsigned int *map;		///< position of each added element in the compressed-column arrays
+	unsigned int *perm;		///< added element stored at each compressed-column position (inverse of map)
+	int *rows;				///< compressed-column row indices of the cached pattern
+	int *cols;				///< compressed-column column starts of the cached pattern
+	unsigned int nels;		///< allocated number of elements
+	unsigned int llptr;		///< number of elements added since the last reset
+	unsigned int nnz;		///< number of elements in the cached pattern
+	unsigned int ncols;		///< number of columns
+	unsigned int last_col;	///< one past the last non-empty column of the cached pattern
+	bool pattern_valid;		///< cached pattern matches the elements added so far
+	bool pattern_copied;	///< cached pattern has been copied into the solver arrays
+	int *copied_rows;		///< solver row array the pattern was last copied into
 } SPARSE;
 
+/// Where the last full admittance build put each branch's and bus's elements, so a branch whose admittance changed
+/// (NR_admit_branch_change) can be rebuilt on its own and spliced in, as long as the bus phasing is unchanged
+typedef struct {
+	unsigned int bus_count;			///< Length of the bus arrays - 0 until the first full build
+	unsigned int branch_count;		///< Length of the branch arrays
+	bool dynamic;					///< Deltamode self-admittance terms were included in the last full build
+	unsigned char *bus_phases;		///< bus[].phases at the last full build
+	unsigned char *branch_phases;	///< branch[].phases at the last full build
+	unsigned int *offdiag_start;	///< First Y_offdiag_PQ element of each branch, then one past the last
+	unsigned int *fixed_start;		///< First Y_diag_fixed element of each bus, then one past the last
+	int *bus_list;					///< Buses at either end of the queued branches
+	unsigned int bus_list_count;	///< Number of entries in bus_list
+	unsigned int *work_start;		///< First work element of each queued branch (or listed bus), then one past the last
+	unsigned int *list_order;		///< Queued branches (or listed buses) in index order, for splicing
+	unsigned int max_work;			///< Allocated length of work
+	Y_NR *work;						///< Elements rebuilt for the queued branches or listed buses
+} NR_ADMIT_DELTA;
+
 typedef struct {
 	double *deltaI_NR;					/// Storage array for current injection
 	unsigned int size_offdiag_PQ;		/// Number of fixed off-diagonal matrix elements
@@ -127,6 +151,7 @@ typedef struct {
 	Y_NR *Y_diag_fixed;					///Y_diag_fixed store the row,column and value of fixed diagonal elements of 6n*6n Y_NR matrix. No PV bus is included.
 	Y_NR *Y_diag_update;				///Y_diag_update store the row,column and value of updated diagonal elements of 6n*6n Y_NR matrix at each iteration. No PV bus is included.
 	SPARSE *Y_Amatrix;					///Y_Amatrix store all the elements of Amatrix in equation AX=B;
+	NR_ADMIT_DELTA admit_delta;			///Element positions of the last full admittance build, for patching single branches
 } NR_SOLVER_STRUCT;
 
 //Mesh-fault-related structure - passing information
@@ -142,6 +167,7 @@ typedef struct {
 //int ext_solver_solve(void *ext_array, NR_SOLVER_VARS *system_info_vars, unsigned int rowcount, unsigned int colcount);
 //void ext_solver_destroy(void *ext_array, bool new_iteration);
 
+void NR_admit_branch_change(int branch_ref);
 int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type , NR_MESHFAULT_IMPEDANCE *mesh_imped_vals, bool *bad_computations);
 
 #endif
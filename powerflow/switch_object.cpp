@@ -1047,7 +1047,7 @@ void switch_object::switch_sync_function(void)
 			if ((status != prev_status) || (pres_status != prev_full_status))
 			{
 				LOCK_OBJECT(NR_swing_bus);	//Lock SWING since we'll be modifying this
-				NR_admit_change = true;	//Flag an admittance change
+				NR_admit_branch_change(NR_branch_reference);	//Flag an admittance change on just this branch
 				UNLOCK_OBJECT(NR_swing_bus);	//Finished
 			}
 		}
@@ -1104,7 +1104,7 @@ void switch_object::switch_sync_function(void)
 
 			//Flag an update
 			LOCK_OBJECT(NR_swing_bus);	//Lock SWING since we'll be modifying this
-			NR_admit_change = true;	//Flag an admittance change
+			NR_admit_branch_change(NR_branch_reference);	//Flag an admittance change on just this branch
 			UNLOCK_OBJECT(NR_swing_bus);	//Finished
 		}
 		//defaulted else - do nothing, something must have handled it externally
@@ -1341,7 +1341,7 @@ void switch_object::set_switch(bool desired_status)
 			LOCK_OBJECT(NR_swing_bus);
 
 			//Flag an update
-			NR_admit_change = true;	//Flag an admittance change
+			NR_admit_branch_change(NR_branch_reference);	//Flag an admittance change on just this branch
 
 			//Unlock swing
 			UNLOCK_OBJECT(NR_swing_bus);
@@ -654,6 +654,8 @@ EXPORT TIMESTAMP sync_triplex_meter(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	SYNC_CATCHALL(triplex_meter);
 }
 
+EXPORT_SYNC_BATCH(triplex_meter);
+
 EXPORT int notify_triplex_meter(OBJECT *obj, int update_mode, PROPERTY *prop, char *value){
 	triplex_meter *n = OBJECTDATA(obj, triplex_meter);
 	int rv = 1;
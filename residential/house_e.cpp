@@ -3132,6 +3132,8 @@ EXPORT TIMESTAMP sync_house(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	SYNC_CATCHALL(house);
 }
 
+EXPORT_SYNC_BATCH(house);
+
 EXPORT TIMESTAMP plc_house(OBJECT *obj, TIMESTAMP t0)
 {
 	// this will be disabled if a PLC object is attached to the waterheater
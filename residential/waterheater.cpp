@@ -1562,6 +1562,8 @@ EXPORT TIMESTAMP sync_waterheater(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	SYNC_CATCHALL(waterheater);
 }
 
+EXPORT_SYNC_BATCH(waterheater);
+
 EXPORT TIMESTAMP commit_waterheater(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 {
 	waterheater *my = OBJECTDATA(obj,waterheater);
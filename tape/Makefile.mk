@@ -7,8 +7,12 @@ tape_tape_la_LDFLAGS =
 tape_tape_la_LDFLAGS += $(AM_LDFLAGS)
 
 tape_tape_la_LIBADD = -ldl
+tape_tape_la_LIBADD += $(PTHREAD_CFLAGS)
+tape_tape_la_LIBADD += $(PTHREAD_LIBS)
 
 tape_tape_la_SOURCES =
+tape_tape_la_SOURCES += tape/binfile.c
+tape_tape_la_SOURCES += tape/binfile.h
 tape_tape_la_SOURCES += tape/collector.c
 tape_tape_la_SOURCES += tape/file.c
 tape_tape_la_SOURCES += tape/file.h
@@ -31,3 +35,15 @@ tape_tape_la_SOURCES += tape/recorder.c
 tape_tape_la_SOURCES += tape/shaper.c
 tape_tape_la_SOURCES += tape/tape.c
 tape_tape_la_SOURCES += tape/tape.h
+tape_tape_la_SOURCES += tape/writer.c
+tape_tape_la_SOURCES += tape/writer.h
+
+bin_PROGRAMS += tape/gridlabd-bin2csv
+
+tape_gridlabd_bin2csv_CPPFLAGS =
+tape_gridlabd_bin2csv_CPPFLAGS += -DBINFILE_MAIN
+tape_gridlabd_bin2csv_CPPFLAGS += $(AM_CPPFLAGS)
+
+tape_gridlabd_bin2csv_SOURCES =
+tape_gridlabd_bin2csv_SOURCES += tape/binfile.c
+tape_gridlabd_bin2csv_SOURCES += tape/binfile.h
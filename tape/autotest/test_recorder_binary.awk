@@ -0,0 +1,39 @@
+# Compares a binary recording decoded by gridlabd-bin2csv with a CSV recording of the same properties
+# usage: awk -F, -v t0=<first timestamp> [-v dt=<interval>] [-v suffix=<column suffix>] [-v eps=<tolerance>] -f test_recorder_binary.awk <csv file> <decoded file>
+# Every row of the CSV file must be in the decoded file at t0+row*dt with the same values
+# Without dt the rows are compared in order and the decoded timestamps must only increase
+# The suffix names the decoded column of each CSV column (e.g. .real for group_recorder complex parts)
+# and eps allows for CSV values printed with fewer digits than the binary ones
+
+FNR==1 { file++; rows=0; }
+/^# timestamp/ {
+	sub(/^# /,"");
+	for ( i=1 ; i<=NF ; i++ ) { name[file,i] = $i; col[file,$i] = i; }
+	ncol[file] = NF;
+	next;
+}
+/^#/ { next; }
+file==1 {
+	rows++;
+	for ( i=2 ; i<=NF ; i++ ) value[rows,name[1,i]] = $i;
+	csvrows = rows;
+	next;
+}
+file==2 && rows<csvrows {
+	if ( dt>0 && $1!=t0+rows*dt ) { printf("row %d: timestamp %s is not %d\n",rows+1,$1,t0+rows*dt); bad++; }
+	if ( dt==0 && ( rows==0 ? $1!=t0 : $1<=last ) ) { printf("row %d: timestamp %s is out of order\n",rows+1,$1); bad++; }
+	last = $1;
+	rows++;
+	for ( i=2 ; i<=ncol[1] ; i++ )
+	{
+		p = name[1,i]; q = p suffix;
+		if ( !((2,q) in col) ) { printf("%s is not in the binary recording\n",q); bad++; continue; }
+		x = value[rows,p]+0; y = $(col[2,q])+0;
+		if ( x-y>eps+1e-9*(x<0?-x:x) || y-x>eps+1e-9*(x<0?-x:x) ) { printf("row %d: %s is %s, not %s\n",rows,q,$(col[2,q]),value[rows,p]); bad++; }
+	}
+	decoded = rows;
+}
+END {
+	if ( csvrows==0 || decoded<csvrows ) { printf("%d of %d rows were decoded\n",decoded,csvrows); bad++; }
+	exit ( bad>0 );
+}
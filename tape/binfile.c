@@ -0,0 +1,532 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file binfile.c
+	@addtogroup binfile
+	@ingroup tapes
+
+	Writer and reader for binary columnar tape files.  See binfile.h for
+	the file layout.
+
+	Compiled with BINFILE_MAIN defined this file is the stand-alone
+	converter \p gridlabd-bin2csv, which is installed with gridlabd.
+	\verbatim
+	gridlabd-bin2csv file.bin > file.csv
+	\endverbatim
+ @{
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "binfile.h"
+
+static const char binfile_magic[7] = {'G','L','D','B','I','N','\0'};
+
+typedef unsigned long long BINUINT64;
+
+/** encode a signed value so small magnitudes use few varint bytes */
+static BINUINT64 zigzag(BINUINT64 x)
+{
+	return (x<<1) ^ ((x>>63) ? ~(BINUINT64)0 : 0);
+}
+static BINUINT64 unzigzag(BINUINT64 u)
+{
+	return (u>>1) ^ ((u&1) ? ~(BINUINT64)0 : 0);
+}
+
+static size_t put_varint(unsigned char *p, BINUINT64 u)
+{
+	size_t n = 0;
+	while ( u>=0x80 )
+	{
+		p[n++] = (unsigned char)(u|0x80);
+		u >>= 7;
+	}
+	p[n++] = (unsigned char)u;
+	return n;
+}
+static int get_varint(const unsigned char *p, size_t len, size_t *pos, BINUINT64 *u)
+{
+	int shift = 0;
+	*u = 0;
+	while ( *pos<len && shift<64 )
+	{
+		unsigned char c = p[(*pos)++];
+		*u |= (BINUINT64)(c&0x7f)<<shift;
+		if ( (c&0x80)==0 )
+			return 1;
+		shift += 7;
+	}
+	return 0;
+}
+
+static BINUINT64 double_bits(double d)
+{
+	BINUINT64 u;
+	memcpy(&u,&d,sizeof(u));
+	return u;
+}
+static double bits_double(BINUINT64 u)
+{
+	double d;
+	memcpy(&d,&u,sizeof(d));
+	return d;
+}
+
+/** encode the timestamp column as delta-of-deltas
+	@return the number of bytes written to \p p
+ **/
+static size_t encode_timestamps(unsigned char *p, const BININT64 *ts, unsigned int rows)
+{
+	BINUINT64 prev=0, prevdelta=0;
+	size_t n = 0;
+	unsigned int r;
+	for ( r=0 ; r<rows ; r++ )
+	{
+		BINUINT64 delta = (BINUINT64)ts[r]-prev;
+		n += put_varint(p+n,zigzag(delta-prevdelta));
+		prev = (BINUINT64)ts[r];
+		prevdelta = delta;
+	}
+	return n;
+}
+static int decode_timestamps(const unsigned char *p, size_t len, BININT64 *ts, unsigned int rows)
+{
+	BINUINT64 prev=0, prevdelta=0, u;
+	size_t pos = 0;
+	unsigned int r;
+	for ( r=0 ; r<rows ; r++ )
+	{
+		if ( !get_varint(p,len,&pos,&u) )
+			return 0;
+		prevdelta += unzigzag(u);
+		prev += prevdelta;
+		ts[r] = (BININT64)prev;
+	}
+	return pos==len;
+}
+
+/** encode an int64 column as deltas
+	@return the number of bytes written to \p p
+ **/
+static size_t encode_int64(unsigned char *p, const BINVALUE *data, unsigned int rows)
+{
+	BINUINT64 prev = 0;
+	size_t n = 0;
+	unsigned int r;
+	for ( r=0 ; r<rows ; r++ )
+	{
+		n += put_varint(p+n,zigzag((BINUINT64)data[r].i-prev));
+		prev = (BINUINT64)data[r].i;
+	}
+	return n;
+}
+static int decode_int64(const unsigned char *p, size_t len, BINVALUE *data, unsigned int rows)
+{
+	BINUINT64 prev = 0, u;
+	size_t pos = 0;
+	unsigned int r;
+	for ( r=0 ; r<rows ; r++ )
+	{
+		if ( !get_varint(p,len,&pos,&u) )
+			return 0;
+		prev += unzigzag(u);
+		data[r].i = (BININT64)prev;
+	}
+	return pos==len;
+}
+
+/** encode a double column by XOR'ing each value with the previous one
+	and storing only the bytes between the leading and trailing zero bytes.
+	The control byte holds the number of leading zero bytes in the high
+	nibble and trailing zero bytes in the low nibble; a repeated value is
+	the single byte 0x80.
+	@return the number of bytes written to \p p
+ **/
+static size_t encode_double(unsigned char *p, const BINVALUE *data, unsigned int rows)
+{
+	BINUINT64 prev = 0;
+	size_t n = 0;
+	unsigned int r;
+	for ( r=0 ; r<rows ; r++ )
+	{
+		BINUINT64 bits = double_bits(data[r].d);
+		BINUINT64 x = bits^prev;
+		prev = bits;
+		if ( x==0 )
+			p[n++] = 0x80;
+		else
+		{
+			int lead=0, trail=0, b;
+			while ( ((x>>(56-8*lead))&0xff)==0 ) lead++;
+			while ( ((x>>(8*trail))&0xff)==0 ) trail++;
+			p[n++] = (unsigned char)((lead<<4)|trail);
+			for ( b=7-lead ; b>=trail ; b-- )
+				p[n++] = (unsigned char)(x>>(8*b));
+		}
+	}
+	return n;
+}
+static int decode_double(const unsigned char *p, size_t len, BINVALUE *data, unsigned int rows)
+{
+	BINUINT64 prev = 0;
+	size_t pos = 0;
+	unsigned int r;
+	for ( r=0 ; r<rows ; r++ )
+	{
+		BINUINT64 x = 0;
+		int lead, trail, b;
+		if ( pos>=len )
+			return 0;
+		lead = p[pos]>>4;
+		trail = p[pos]&0x0f;
+		pos++;
+		if ( lead<8 )
+		{
+			if ( lead+trail>7 || pos+(8-lead-trail)>len )
+				return 0;
+			for ( b=7-lead ; b>=trail ; b-- )
+				x = (x<<8) | p[pos++];
+			x <<= 8*trail;
+		}
+		else if ( lead>8 || trail!=0 )
+			return 0;
+		prev ^= x;
+		data[r].d = bits_double(prev);
+	}
+	return pos==len;
+}
+
+static int put_uint(FILE *fp, unsigned int value, int size)
+{
+	unsigned char b[4];
+	int i;
+	for ( i=0 ; i<size ; i++ )
+		b[i] = (unsigned char)(value>>(8*i));
+	return fwrite(b,1,size,fp)==(size_t)size;
+}
+static int get_uint(FILE *fp, unsigned int *value, int size)
+{
+	unsigned char b[4];
+	int i;
+	if ( fread(b,1,size,fp)!=(size_t)size )
+		return 0;
+	*value = 0;
+	for ( i=0 ; i<size ; i++ )
+		*value |= (unsigned int)b[i]<<(8*i);
+	return 1;
+}
+
+/** allocate the block storage once the column count is known */
+static BINFILE *binfile_alloc(unsigned int ncols)
+{
+	BINFILE *bin = (BINFILE*)malloc(sizeof(BINFILE));
+	unsigned int n;
+	if ( bin==NULL )
+		return NULL;
+	memset(bin,0,sizeof(BINFILE));
+	bin->ncols = ncols;
+	bin->col = (BINCOLUMN*)calloc(ncols?ncols:1,sizeof(BINCOLUMN));
+	bin->row = (BINVALUE*)calloc(ncols?ncols:1,sizeof(BINVALUE));
+	bin->last = (BINVALUE*)calloc(ncols?ncols:1,sizeof(BINVALUE));
+	bin->ts = (BININT64*)malloc(sizeof(BININT64)*BINFILE_BLOCKSIZE);
+	bin->size = 10*BINFILE_BLOCKSIZE; /* worst case varint length per row */
+	bin->buffer = (unsigned char*)malloc(bin->size);
+	if ( bin->col==NULL || bin->row==NULL || bin->last==NULL || bin->ts==NULL || bin->buffer==NULL )
+	{
+		binfile_close(bin);
+		return NULL;
+	}
+	for ( n=0 ; n<ncols ; n++ )
+	{
+		bin->col[n].type = BT_DOUBLE;
+		bin->col[n].data = (BINVALUE*)malloc(sizeof(BINVALUE)*BINFILE_BLOCKSIZE);
+		if ( bin->col[n].data==NULL )
+		{
+			binfile_close(bin);
+			return NULL;
+		}
+	}
+	return bin;
+}
+
+/** create a binary tape writer with \p ncols value columns
+	@return the writer, or NULL when memory is exhausted
+ **/
+BINFILE *binfile_create(unsigned int ncols)
+{
+	BINFILE *bin = binfile_alloc(ncols);
+	if ( bin!=NULL )
+		bin->writing = 1;
+	return bin;
+}
+
+/** name column \p n and set its type; must be called before binfile_open()
+	@return 1 on success, 0 on failure
+ **/
+int binfile_column(BINFILE *bin, unsigned int n, const char *name, BINTYPE type)
+{
+	if ( n>=bin->ncols || bin->fp!=NULL )
+		return 0;
+	free(bin->col[n].name);
+	bin->col[n].name = (char*)malloc(strlen(name)+1);
+	if ( bin->col[n].name==NULL )
+		return 0;
+	strcpy(bin->col[n].name,name);
+	bin->col[n].type = type;
+	return 1;
+}
+
+/** open \p fname and write the file header
+	@return 1 on success, 0 on failure
+ **/
+int binfile_open(BINFILE *bin, const char *fname, const char *info)
+{
+	unsigned char version = BINFILE_VERSION;
+	unsigned int n;
+	if ( info==NULL )
+		info = "";
+	bin->fp = fopen(fname,"wb");
+	if ( bin->fp==NULL )
+		return 0;
+	if ( fwrite(binfile_magic,1,sizeof(binfile_magic),bin->fp)!=sizeof(binfile_magic)
+		|| fwrite(&version,1,1,bin->fp)!=1
+		|| !put_uint(bin->fp,(unsigned int)strlen(info),4)
+		|| fwrite(info,1,strlen(info),bin->fp)!=strlen(info)
+		|| !put_uint(bin->fp,bin->ncols,4) )
+		return 0;
+	for ( n=0 ; n<bin->ncols ; n++ )
+	{
+		const char *name = bin->col[n].name ? bin->col[n].name : "";
+		size_t len = strlen(name);
+		if ( len>0xffff )
+			len = 0xffff;
+		if ( !put_uint(bin->fp,bin->col[n].type,1)
+			|| !put_uint(bin->fp,(unsigned int)len,2)
+			|| fwrite(name,1,len,bin->fp)!=len )
+			return 0;
+	}
+	return 1;
+}
+
+/** check whether the staged row differs from the last row written
+	@return 1 when the staged row is new, 0 when it repeats the last row
+ **/
+int binfile_changed(BINFILE *bin)
+{
+	return !bin->has_last || memcmp(bin->row,bin->last,sizeof(BINVALUE)*bin->ncols)!=0;
+}
+
+/** append the staged row with timestamp \p ts (in ns) to the current block
+	@return 1 on success, 0 on failure
+ **/
+int binfile_write(BINFILE *bin, BININT64 ts)
+{
+	unsigned int n;
+	if ( bin->fp==NULL || !bin->writing )
+		return 0;
+	bin->ts[bin->rows] = ts;
+	for ( n=0 ; n<bin->ncols ; n++ )
+		bin->col[n].data[bin->rows] = bin->row[n];
+	memcpy(bin->last,bin->row,sizeof(BINVALUE)*bin->ncols);
+	bin->has_last = 1;
+	if ( ++bin->rows==BINFILE_BLOCKSIZE )
+		return binfile_flush(bin);
+	return 1;
+}
+
+/** compress and write the current block, if any
+	@return 1 on success, 0 on failure
+ **/
+int binfile_flush(BINFILE *bin)
+{
+	unsigned int n;
+	size_t len;
+	if ( bin->fp==NULL || !bin->writing )
+		return 0;
+	if ( bin->rows==0 )
+		return fflush(bin->fp)==0;
+	if ( !put_uint(bin->fp,bin->rows,4) )
+		return 0;
+	len = encode_timestamps(bin->buffer,bin->ts,bin->rows);
+	if ( !put_uint(bin->fp,(unsigned int)len,4) || fwrite(bin->buffer,1,len,bin->fp)!=len )
+		return 0;
+	for ( n=0 ; n<bin->ncols ; n++ )
+	{
+		if ( bin->col[n].type==BT_INT64 )
+			len = encode_int64(bin->buffer,bin->col[n].data,bin->rows);
+		else
+			len = encode_double(bin->buffer,bin->col[n].data,bin->rows);
+		if ( !put_uint(bin->fp,(unsigned int)len,4) || fwrite(bin->buffer,1,len,bin->fp)!=len )
+			return 0;
+	}
+	bin->rows = 0;
+	return fflush(bin->fp)==0;
+}
+
+/** flush and close a writer (or close a reader) and release its memory
+	@return 1 on success, 0 when the final block could not be written
+ **/
+int binfile_close(BINFILE *bin)
+{
+	int rc = 1;
+	unsigned int n;
+	if ( bin==NULL )
+		return 1;
+	if ( bin->fp!=NULL )
+	{
+		if ( bin->writing )
+			rc = binfile_flush(bin) && put_uint(bin->fp,0,4);
+		if ( fclose(bin->fp)!=0 )
+			rc = 0;
+	}
+	if ( bin->col!=NULL )
+	{
+		for ( n=0 ; n<bin->ncols ; n++ )
+		{
+			free(bin->col[n].name);
+			free(bin->col[n].data);
+		}
+	}
+	free(bin->col);
+	free(bin->row);
+	free(bin->last);
+	free(bin->ts);
+	free(bin->buffer);
+	free(bin->info);
+	free(bin);
+	return rc;
+}
+
+/** open a binary tape file and read its header
+	@return the reader, or NULL if the file is missing or not a binary tape
+ **/
+BINFILE *binfile_read_open(const char *fname)
+{
+	char magic[sizeof(binfile_magic)];
+	unsigned char version;
+	unsigned int len, ncols, n;
+	char *info;
+	BINFILE *bin;
+	FILE *fp = fopen(fname,"rb");
+	if ( fp==NULL )
+		return NULL;
+	if ( fread(magic,1,sizeof(magic),fp)!=sizeof(magic) || memcmp(magic,binfile_magic,sizeof(magic))!=0
+		|| fread(&version,1,1,fp)!=1 || version!=BINFILE_VERSION
+		|| !get_uint(fp,&len,4) || (info=(char*)malloc(len+1))==NULL )
+	{
+		fclose(fp);
+		return NULL;
+	}
+	if ( fread(info,1,len,fp)!=len || !get_uint(fp,&ncols,4) || (bin=binfile_alloc(ncols))==NULL )
+	{
+		free(info);
+		fclose(fp);
+		return NULL;
+	}
+	info[len] = '\0';
+	bin->info = info;
+	bin->fp = fp;
+	for ( n=0 ; n<ncols ; n++ )
+	{
+		unsigned int type;
+		if ( !get_uint(fp,&type,1) || (type!=BT_DOUBLE && type!=BT_INT64)
+			|| !get_uint(fp,&len,2) || (bin->col[n].name=(char*)malloc(len+1))==NULL
+			|| fread(bin->col[n].name,1,len,fp)!=len )
+		{
+			binfile_close(bin);
+			return NULL;
+		}
+		bin->col[n].name[len] = '\0';
+		bin->col[n].type = (BINTYPE)type;
+	}
+	return bin;
+}
+
+/** read and decompress the next block into \p ts and the column data
+	@return the number of rows read, 0 at the end of the file, -1 on a corrupt file
+ **/
+int binfile_read_block(BINFILE *bin)
+{
+	unsigned int rows, len, n;
+	bin->rows = 0;
+	if ( bin->fp==NULL || bin->writing )
+		return -1;
+	if ( !get_uint(bin->fp,&rows,4) || rows==0 )
+		return 0; /* end marker, or a recording that was not closed */
+	if ( rows>BINFILE_BLOCKSIZE )
+		return -1;
+	for ( n=0 ; n<=bin->ncols ; n++ )
+	{
+		int ok;
+		if ( !get_uint(bin->fp,&len,4) || len>bin->size || fread(bin->buffer,1,len,bin->fp)!=len )
+			return -1;
+		if ( n==0 )
+			ok = decode_timestamps(bin->buffer,len,bin->ts,rows);
+		else if ( bin->col[n-1].type==BT_INT64 )
+			ok = decode_int64(bin->buffer,len,bin->col[n-1].data,rows);
+		else
+			ok = decode_double(bin->buffer,len,bin->col[n-1].data,rows);
+		if ( !ok )
+			return -1;
+	}
+	bin->rows = rows;
+	return (int)rows;
+}
+
+#ifdef BINFILE_MAIN
+/** gridlabd-bin2csv: convert a binary tape file to the text recorder format */
+int main(int argc, char *argv[])
+{
+	BINFILE *bin;
+	unsigned int n;
+	int rows;
+	if ( argc!=2 )
+	{
+		fprintf(stderr,"Syntax: %s <file.bin>\n",argv[0]);
+		return 1;
+	}
+	bin = binfile_read_open(argv[1]);
+	if ( bin==NULL )
+	{
+		fprintf(stderr,"%s: unable to read binary tape file '%s'\n",argv[0],argv[1]);
+		return 1;
+	}
+	fputs(bin->info,stdout);
+	printf("# timestamp");
+	for ( n=0 ; n<bin->ncols ; n++ )
+		printf(",%s",bin->col[n].name);
+	printf("\n");
+	while ( (rows=binfile_read_block(bin))>0 )
+	{
+		int r;
+		for ( r=0 ; r<rows ; r++ )
+		{
+			/* print seconds and nanoseconds as integers so large epochs keep every digit */
+			BININT64 ts = bin->ts[r];
+			unsigned long long mag = ts<0 ? 0ULL-(unsigned long long)ts : (unsigned long long)ts;
+			if ( mag%1000000000==0 )
+				printf("%s%llu",ts<0?"-":"",mag/1000000000);
+			else
+				printf("%s%llu.%09llu",ts<0?"-":"",mag/1000000000,mag%1000000000);
+			for ( n=0 ; n<bin->ncols ; n++ )
+			{
+				if ( bin->col[n].type==BT_INT64 )
+					printf(",%lld",bin->col[n].data[r].i);
+				else
+					printf(",%.17g",bin->col[n].data[r].d);
+			}
+			printf("\n");
+		}
+	}
+	binfile_close(bin);
+	if ( rows<0 )
+	{
+		fprintf(stderr,"%s: '%s' is corrupt\n",argv[0],argv[1]);
+		return 1;
+	}
+	return 0;
+}
+#endif
+
+/**@}*/
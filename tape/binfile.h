@@ -0,0 +1,95 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file binfile.h
+	@addtogroup binfile Binary columnar tape files
+	@ingroup tapes
+
+	Binary columnar recordings store samples as typed fixed-width columns
+	in blocks of up to BINFILE_BLOCKSIZE rows.  Each block holds an int64
+	timestamp column (nanoseconds since the epoch) followed by one column
+	per recorded value.  Columns are compressed independently:
+	- timestamps are stored as zigzag varint delta-of-deltas,
+	- int64 columns are stored as zigzag varint deltas, and
+	- double columns are XOR'd against the previous value and only the
+	  non-zero middle bytes are kept.
+
+	The file layout is
+	- 8 byte magic "GLDBIN" 0x00 version,
+	- uint32 info length and info text,
+	- uint32 column count, then for each column a uint8 type, a uint16 name
+	  length and the name,
+	- blocks made of a uint32 row count followed by a uint32 byte count and
+	  the encoded data for each column (timestamp first),
+	- a block with a zero row count marking the end of the file.
+
+	All integers are little-endian.  This file does not depend on the core
+	so the reader can be built on its own; compiling binfile.c with
+	BINFILE_MAIN defined produces the \p gridlabd-bin2csv converter.
+ @{
+ **/
+
+#ifndef _BINFILE_H
+#define _BINFILE_H
+
+#include <stdio.h>
+
+#define BINFILE_VERSION 1
+#define BINFILE_BLOCKSIZE 4096 /**< maximum number of rows per block */
+
+typedef long long BININT64;
+
+typedef enum {
+	BT_DOUBLE=1,	/**< IEEE double column */
+	BT_INT64=2		/**< 64-bit integer column */
+} BINTYPE;
+
+typedef union {
+	double d;
+	BININT64 i;
+} BINVALUE;
+
+typedef struct s_bincolumn {
+	char *name;
+	BINTYPE type;
+	BINVALUE *data;		/**< block data (BINFILE_BLOCKSIZE rows) */
+} BINCOLUMN;
+
+typedef struct s_binfile {
+	FILE *fp;
+	int writing;			/**< file was opened by binfile_open() */
+	unsigned int ncols;
+	BINCOLUMN *col;
+	BINVALUE *row;			/**< staged row (writer) */
+	BINVALUE *last;			/**< last row written (writer) */
+	int has_last;
+	BININT64 *ts;			/**< block timestamps */
+	unsigned int rows;		/**< number of rows in the block */
+	unsigned char *buffer;	/**< encoding buffer */
+	size_t size;
+	char *info;				/**< free-form header text (reader) */
+} BINFILE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* writer */
+BINFILE *binfile_create(unsigned int ncols);
+int binfile_column(BINFILE *bin, unsigned int n, const char *name, BINTYPE type);
+int binfile_open(BINFILE *bin, const char *fname, const char *info);
+int binfile_changed(BINFILE *bin);
+int binfile_write(BINFILE *bin, BININT64 ts);
+int binfile_flush(BINFILE *bin);
+int binfile_close(BINFILE *bin);
+
+/* reader */
+BINFILE *binfile_read_open(const char *fname);
+int binfile_read_block(BINFILE *bin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}*/
@@ -105,18 +105,38 @@ static int collector_open(OBJECT *obj)
 	if(my->ops == NULL)
 		return 0;
 	set_csv_options();
-	return my->ops->open(my, fname, flags);
+	if (!my->ops->open(my, fname, flags))
+		return 0;
+
+	/* hand file output to the writer thread unless every line must reach the disk right away */
+	if (async_output && strcmp(type,"file")==0 && my->fp!=stdout && my->flush!=0 && !csv_keep_clean)
+		my->writer = tapewriter_open(my->fp, async_buffer, NULL, NULL);
+	return 1;
 }
 
 static int write_collector(struct collector *my, char *ts, char *value)
 {
-	int rc=my->ops->write(my, ts, value);
-	if ( (my->flush==0 || (my->flush>0 && my->flush%gl_globalclock==0)) && my->ops->flush!=NULL ) 
+	int rc;
+	if (my->writer!=NULL)
+	{
+		/* the writer thread holds the file, so a periodic flush waits for it to catch up */
+		rc = tapewriter_line(my->writer, ts, value);
+		if ( rc && my->flush>0 && gl_globalclock%my->flush==0 )
+			rc = tapewriter_flush(my->writer);
+		return rc;
+	}
+	rc=my->ops->write(my, ts, value);
+	if ( (my->flush==0 || (my->flush>0 && gl_globalclock%my->flush==0)) && my->ops->flush!=NULL ) 
 		my->ops->flush(my);
 	return rc;
 }
 
 static void close_collector(struct collector *my){
+	if(my->writer){
+		if(!tapewriter_close(my->writer))
+			gl_error("unable to write queued collector output");
+		my->writer = NULL;
+	}
 	if(my->ops){
 		my->ops->close(my);
 	}
@@ -292,4 +312,22 @@ Error:
 	return (my->interval==0 || my->interval==-1) ? TS_NEVER : my->last.ts+my->interval;
 }
 
+EXPORT int finalize_collector(OBJECT *obj)
+{
+	struct collector *my = OBJECTDATA(obj,struct collector);
+
+	/* write out what is still queued for the writer thread */
+	if (my->writer!=NULL)
+	{
+		int rc = tapewriter_close(my->writer);
+		my->writer = NULL;
+		if (!rc)
+		{
+			gl_error("collector:%d: unable to write queued output", obj->id);
+			return 0;
+		}
+	}
+	return 1;
+}
+
 /**@}*/
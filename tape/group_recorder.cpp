@@ -34,6 +34,9 @@ group_recorder::group_recorder(MODULE *mod){
 				PT_KEYWORD, "MAG", MAG,
 				PT_KEYWORD, "ANG_DEG", ANG,
 				PT_KEYWORD, "ANG_RAD", ANG_RAD,
+			PT_enumeration, "format", PADDR(format), PT_DESCRIPTION, "the output file format (BINARY writes compressed typed columns, see binfile.h)",
+				PT_KEYWORD, "CSV", GRF_CSV,
+				PT_KEYWORD, "BINARY", GRF_BINARY,
 		NULL) < 1){
 			;//GL_THROW("unable to publish properties in %s",__FILE__);
 		}
@@ -72,7 +75,7 @@ int group_recorder::init(OBJECT *obj){
 			gl_error("group_recorder::init(): no filename defined in strict mode");
 			return 0;
 		} else {
-			sprintf(filename, "%256s-%256i.csv", oclass->name, obj->id);
+			sprintf(filename, "%256s-%256i.%s", oclass->name, obj->id, GRF_BINARY == format ? "bin" : "csv");
 			gl_warning("group_recorder::init(): no filename defined, auto-generating '%s'", filename.get_string());
 			/* TROUBLESHOOT
 				group_recorder requires a filename.  If none is provided, a filename will be generated
@@ -126,9 +129,11 @@ int group_recorder::init(OBJECT *obj){
 		}
 	}
 	
-	// open file
-	rec_file = fopen(filename.get_string(), "w");
-	if(0 == rec_file){
+	// open file, binary files are opened once the columns are known
+	if(GRF_BINARY != format){
+		rec_file = fopen(filename.get_string(), "w");
+	}
+	if(0 == rec_file && GRF_BINARY != format){
 		if(strict){
 			gl_error("group_recorder::init(): unable to open file '%s' for writing", filename.get_string());
 			return 0;
@@ -171,7 +176,7 @@ int group_recorder::init(OBJECT *obj){
 	}
 
 	tape_status = TS_OPEN;
-	if(0 == write_header()){
+	if(0 == (GRF_BINARY == format ? open_binary() : write_header())){
 		gl_error("group_recorder::init(): an error occured when writing the file header");
 		/* TROUBLESHOOT
 			Unexpected IO error.
@@ -179,6 +184,11 @@ int group_recorder::init(OBJECT *obj){
 		tape_status = TS_ERROR;
 		return 0;
 	}
+
+	// hand the output to the writer thread
+	if(async_output && GRF_BINARY != format && !csv_keep_clean && 0 == open_writer()){
+		return 0;
+	}
 	
 
 	return 1;
@@ -269,7 +279,7 @@ int group_recorder::commit(TIMESTAMP t1){
 				gl_error("group_recorder::commit(): error when reading the values");
 				return 0;
 			}
-			if(0 != strcmp(line_buffer, prev_line_buffer) ){
+			if(GRF_BINARY == format ? binfile_changed(bin_file) : 0 != strcmp(line_buffer, prev_line_buffer) ){
 				if(0 == write_line(t1)){
 					gl_error("group_recorder::commit(): error when writing the values to the file");
 					return 0;
@@ -293,9 +303,15 @@ int group_recorder::commit(TIMESTAMP t1){
 	// check if write limit
 	if(limit > 0 && write_count >= limit){
 		// write footer
-		write_footer();
-		fclose(rec_file);
-		rec_file = 0;
+		if(GRF_BINARY == format){
+			binfile_close(bin_file);
+			bin_file = 0;
+		} else {
+			close_writer();
+			write_footer();
+			fclose(rec_file);
+			rec_file = 0;
+		}
 		free(line_buffer);
 		line_buffer = 0;
 		line_size = 0;
@@ -315,6 +331,26 @@ int group_recorder::commit(TIMESTAMP t1){
 	return 1;
 }
 
+int group_recorder::finalize(){
+	// write out what is still queued for the writer thread
+	if(0 == close_writer()){
+		return 0;
+	}
+	// binary output keeps up to a block of samples in memory
+	if(0 != bin_file){
+		if(0 == binfile_close(bin_file)){
+			gl_error("group_recorder::finalize(): unable to write the last block to '%s'", filename.get_string());
+			/* TROUBLESHOOT
+				File I/O error.
+			 */
+			bin_file = 0;
+			return 0;
+		}
+		bin_file = 0;
+	}
+	return 1;
+}
+
 int group_recorder::isa(char *classname){
 	return (strcmp(classname, oclass->name) == 0);
 }
@@ -378,12 +414,17 @@ int group_recorder::read_line(){
 	quickobjlist *curr = 0;
 	char *swap_ptr = 0;
 	char buffer[128];
-	char objname[128];
 
 	if(TS_OPEN != tape_status){
 		// could be ERROR or CLOSED
 		return 0;
 	}
+	if(GRF_BINARY == format){
+		return read_binary();
+	}
+	if(0 != raw_buffer){
+		return read_raw();
+	}
 
 	// pre-calculate buffer needs
 	if(line_size <= 0 || line_buffer == 0){
@@ -423,38 +464,9 @@ int group_recorder::read_line(){
 		// GETADDR is a macro defined in object.h
 		if(curr->prop.ptype == PT_complex && complex_part != NONE){
 			double part_value = 0.0;
-			complex *cptr = 0;
-			// get value as a complex
-			cptr = gl_get_complex(curr->obj, &(curr->prop));
-			if(0 == cptr){
-				gl_error("group_recorder::read_line(): unable to get complex property '%s' from object '%s'", curr->prop.name, gl_name(curr->obj, objname, 127));
-				/* TROUBLESHOOT
-					Could not read a complex property as a complex value.
-				 */
+			if(0 == read_part(curr, &part_value)){
 				return 0;
 			}
-			// switch on part
-			switch(complex_part){
-				case NONE:
-					// didn't we test != NONE just a few lines ago?
-					gl_error("group_recorder::read_line(): inconsistant complex_part states!");
-					return 0;
-				case REAL:
-					part_value = cptr->Re();
-					break;
-				case IMAG:
-					part_value = cptr->Im();
-					break;
-				case MAG:
-					part_value = cptr->Mag();
-					break;
-				case ANG:
-					part_value = cptr->Arg() * 180/PI;
-					break;
-				case ANG_RAD:
-					part_value = cptr->Arg();
-					break;
-			}
 			sprintf(buffer, "%f", part_value);
 			offset = strlen(buffer);
 		} else {
@@ -486,6 +498,296 @@ int group_recorder::read_line(){
 	return 1;
 }
 
+/**
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::read_part(quickobjlist *curr, double *part_value){
+	complex *cptr = 0;
+	char objname[128];
+
+	// get value as a complex
+	cptr = gl_get_complex(curr->obj, &(curr->prop));
+	if(0 == cptr){
+		gl_error("group_recorder::read_part(): unable to get complex property '%s' from object '%s'", curr->prop.name, gl_name(curr->obj, objname, 127));
+		/* TROUBLESHOOT
+			Could not read a complex property as a complex value.
+		 */
+		return 0;
+	}
+	// switch on part
+	switch(complex_part){
+		case NONE:
+			// callers only ask for a part when one is selected
+			gl_error("group_recorder::read_part(): inconsistant complex_part states!");
+			return 0;
+		case REAL:
+			*part_value = cptr->Re();
+			break;
+		case IMAG:
+			*part_value = cptr->Im();
+			break;
+		case MAG:
+			*part_value = cptr->Mag();
+			break;
+		case ANG:
+			*part_value = cptr->Arg() * 180/PI;
+			break;
+		case ANG_RAD:
+			*part_value = cptr->Arg();
+			break;
+	}
+	return 1;
+}
+
+static int format_raw_line(void *context, FILE *fp, const char *record, size_t len){
+	return ((group_recorder *)context)->format_raw(fp, record, len);
+}
+
+/**
+	Starts asynchronous output.  Periodic recorders of plain value properties
+	queue the raw values, which are then formatted by the writer thread.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::open_writer(){
+	quickobjlist *qol = 0;
+	bool raw = (write_interval >= 0);
+
+	raw_size = 0;
+	for(qol = obj_list; qol != 0 && raw; qol = qol->next){
+		switch(qol->prop.ptype){
+			case PT_complex:
+				raw_size += (NONE == complex_part) ? qol->prop.width : sizeof(double);
+				break;
+			case PT_double:
+			case PT_float:
+			case PT_int16:
+			case PT_int32:
+			case PT_int64:
+			case PT_enumeration:
+			case PT_set:
+			case PT_bool:
+			case PT_char8:
+			case PT_char32:
+				raw_size += qol->prop.width;
+				break;
+			default:
+				// the value may refer to memory that changes before the writer thread formats it,
+				// or (timestamps) be formatted with the core's unlocked date caches
+				raw = false;
+				break;
+		}
+	}
+	if(raw){
+		raw_buffer = (char *)malloc(raw_size + 64); // room for the timestamp
+		if(0 == raw_buffer){
+			gl_error("group_recorder::open_writer(): malloc failure");
+			return 0;
+		}
+	}
+	writer = tapewriter_open(rec_file, async_buffer, raw ? format_raw_line : NULL, this);
+	if(0 == writer && 0 != raw_buffer){
+		// write synchronously
+		free(raw_buffer);
+		raw_buffer = 0;
+	}
+	return 1;
+}
+
+/**
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::close_writer(){
+	int rv = 1;
+	if(0 != writer){
+		if(0 == tapewriter_close(writer)){
+			gl_error("group_recorder::close_writer(): unable to write queued output to '%s'", filename.get_string());
+			/* TROUBLESHOOT
+				File I/O error.
+			 */
+			tape_status = TS_ERROR;
+			rv = 0;
+		}
+		writer = 0;
+	}
+	if(0 != raw_buffer){
+		free(raw_buffer);
+		raw_buffer = 0;
+	}
+	return rv;
+}
+
+/**
+	Copies the current values into the raw record.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::read_raw(){
+	quickobjlist *curr = 0;
+	char *p = raw_buffer;
+
+	for(curr = obj_list; curr != 0; curr = curr->next){
+		if(curr->prop.ptype == PT_complex && complex_part != NONE){
+			double part_value = 0.0;
+			if(0 == read_part(curr, &part_value)){
+				return 0;
+			}
+			memcpy(p, &part_value, sizeof(double));
+			p += sizeof(double);
+		} else {
+			// GETADDR is a macro defined in object.h
+			memcpy(p, GETADDR(curr->obj, &(curr->prop)), curr->prop.width);
+			p += curr->prop.width;
+		}
+	}
+	return 1;
+}
+
+/**
+	Formats a raw record on the writer thread, the same way read_line() and write_line() would.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::format_raw(FILE *fp, const char *record, size_t len){
+	quickobjlist *curr = 0;
+	const char *p = record;
+	double value[8]; // aligned copy of one value
+	char buffer[128];
+
+	if(len <= raw_size || 0 > fputs(record + raw_size, fp)){
+		return 0;
+	}
+	for(curr = obj_list; curr != 0; curr = curr->next){
+		if(curr->prop.ptype == PT_complex && complex_part != NONE){
+			memcpy(value, p, sizeof(double));
+			p += sizeof(double);
+			sprintf(buffer, "%f", value[0]);
+		} else {
+			memcpy(value, p, curr->prop.width);
+			p += curr->prop.width;
+			if(0 == gl_get_value(curr->obj, value, buffer, 127, &(curr->prop))){
+				return 0;
+			}
+		}
+		if(0 > fprintf(fp, ",%s", buffer)){
+			return 0;
+		}
+	}
+	return EOF != fputc('\n', fp);
+}
+
+/**
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::open_binary(){
+	time_t now = time(NULL);
+	quickobjlist *qol = 0;
+	unsigned int ncols = 0, n = 0;
+	char info[2048];
+	char name[256], unit[64];
+
+	for(qol = obj_list; qol != 0; qol = qol->next){
+		ncols += (qol->prop.ptype == PT_complex && complex_part == NONE) ? 2 : 1;
+	}
+	bin_file = binfile_create(ncols);
+	if(0 == bin_file){
+		gl_error("group_recorder::open_binary(): malloc failure");
+		/* TROUBLESHOOT
+			Memory allocation failure.
+		*/
+		return 0;
+	}
+
+	// one column per object, or two for whole complex values
+	for(qol = obj_list; qol != 0; qol = qol->next){
+		if(0 != qol->obj->name){
+			sprintf(name, "%.200s", qol->obj->name);
+		} else {
+			sprintf(name, "%.64s:%i", qol->obj->oclass->name, qol->obj->id);
+		}
+		unit[0] = 0;
+		if(0 != qol->prop.unit){
+			sprintf(unit, "[%.60s]", qol->prop.unit->name);
+		}
+		switch(qol->prop.ptype){
+			case PT_double:
+				strcat(name, unit);
+				binfile_column(bin_file, n++, name, BT_DOUBLE);
+				break;
+			case PT_complex:
+				if(NONE == complex_part){
+					char part[300];
+					sprintf(part, "%s.real%s", name, unit);
+					binfile_column(bin_file, n++, part, BT_DOUBLE);
+					sprintf(part, "%s.imag%s", name, unit);
+					binfile_column(bin_file, n++, part, BT_DOUBLE);
+				} else {
+					strcat(name, unit);
+					binfile_column(bin_file, n++, name, BT_DOUBLE);
+				}
+				break;
+			case PT_int16:
+			case PT_int32:
+			case PT_int64:
+			case PT_enumeration:
+			case PT_set:
+			case PT_bool:
+			case PT_timestamp:
+				strcat(name, unit);
+				binfile_column(bin_file, n++, name, BT_INT64);
+				break;
+			default:
+				gl_error("group_recorder::open_binary(): property '%s' cannot be recorded in binary format", qol->prop.name);
+				/* TROUBLESHOOT
+					Binary group_recorders only record numeric properties (double, complex,
+					integer, enumeration, set, bool and timestamp).  Use the CSV format for
+					other property types.
+				 */
+				return 0;
+		}
+	}
+
+	sprintf(info, "# file...... %.256s\n# date...... %s# group..... %.1024s\n# property.. %.256s\n# limit..... %d\n# interval.. %" FMT_INT64 "d\n",
+		filename.get_string(), asctime(localtime(&now)), group_def.get_string(), property_name.get_string(), limit, write_interval);
+	if(0 == binfile_open(bin_file, filename.get_string(), info)){
+		gl_error("group_recorder::open_binary(): unable to open file '%s' for writing", filename.get_string());
+		return 0;
+	}
+	return 1;
+}
+
+/**
+	Stages the current values in the binary writer's row.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::read_binary(){
+	quickobjlist *curr = 0;
+	BINVALUE *v = bin_file->row;
+
+	for(curr = obj_list; curr != 0; curr = curr->next){
+		// GETADDR is a macro defined in object.h
+		void *addr = GETADDR(curr->obj, &(curr->prop));
+		switch(curr->prop.ptype){
+			case PT_double: (v++)->d = *(double *)addr; break;
+			case PT_complex:
+				if(NONE == complex_part){
+					(v++)->d = ((complex *)addr)->Re();
+					(v++)->d = ((complex *)addr)->Im();
+				} else if(0 == read_part(curr, &((v++)->d))){
+					return 0;
+				}
+				break;
+			case PT_int16: (v++)->i = *(int16 *)addr; break;
+			case PT_int32: (v++)->i = *(int32 *)addr; break;
+			case PT_int64: (v++)->i = *(int64 *)addr; break;
+			case PT_enumeration: (v++)->i = *(enumeration *)addr; break;
+			case PT_set: (v++)->i = (int64)*(set *)addr; break;
+			case PT_bool: (v++)->i = *(bool *)addr; break;
+			case PT_timestamp: (v++)->i = *(TIMESTAMP *)addr; break;
+			default:
+				return 0;
+		}
+	}
+	return 1;
+}
+
 /**
 	@return 1 on successful write, 0 on unsuccessful write, error, or when not ready
  **/
@@ -498,6 +800,16 @@ int group_recorder::write_line(TIMESTAMP t1){
 		// could be ERROR or CLOSED, should not have happened
 		return 0;
 	}
+	if(GRF_BINARY == format){
+		// the values were staged by read_line()
+		if(0 == bin_file || 0 == binfile_write(bin_file, (BININT64)t1 * 1000000000)){
+			gl_error("group_recorder::write_line(): error when writing to the output file");
+			tape_status = TS_ERROR;
+			return 0;
+		}
+		++write_count;
+		return 1;
+	}
 	if(0 == rec_file){
 		gl_error("group_recorder::write_line(): no output file open and state is 'open'");
 		/* TROUBLESHOOT
@@ -509,7 +821,7 @@ int group_recorder::write_line(TIMESTAMP t1){
 	}
 
 	// check that buffer needs were pre-calculated
-	if(line_size <= 0 || line_buffer == 0){
+	if(0 == raw_buffer && (line_size <= 0 || line_buffer == 0)){
 		gl_error("group_recorder::write_line(): output buffer not initialized (read_line() not called)");
 		/* TROUBLESHOOT
 			read_line was not called before write_line, indicating an internal logic error.
@@ -536,6 +848,24 @@ int group_recorder::write_line(TIMESTAMP t1){
 		tape_status = TS_ERROR;
 		return 0;
 	}
+	// queue the line for the writer thread, as raw values if read_line() captured them
+	if(0 != writer){
+		int ok;
+		if(0 != raw_buffer){
+			size_t len = strlen(time_str) + 1;
+			memcpy(raw_buffer + raw_size, time_str, len);
+			ok = tapewriter_write(writer, raw_buffer, raw_size + len);
+		} else {
+			ok = tapewriter_line(writer, time_str, line_buffer + 1); // skip the leading comma
+		}
+		if(0 == ok){
+			gl_error("group_recorder::write_line(): error when writing to the output file");
+			tape_status = TS_ERROR;
+			return 0;
+		}
+		++write_count;
+		return 1;
+	}
 	// print line to file
 	if(0 >= fprintf(rec_file, "%s%s\n", time_str, line_buffer)){
 		gl_error("group_recorder::write_line(): error when writing to the output file");
@@ -559,6 +889,22 @@ int group_recorder::flush_line(){
 		// could be ERROR or CLOSED, should not have happened
 		return 0;
 	}
+	if(GRF_BINARY == format){
+		if(0 == bin_file || 0 == binfile_flush(bin_file)){
+			gl_error("group_recorder::flush_line(): unable to flush output file");
+			tape_status = TS_ERROR;
+			return 0;
+		}
+		return 1;
+	}
+	if(0 != writer){
+		if(0 == tapewriter_flush(writer)){
+			gl_error("group_recorder::flush_line(): unable to flush output file");
+			tape_status = TS_ERROR;
+			return 0;
+		}
+		return 1;
+	}
 	if(0 == rec_file){
 		gl_error("group_recorder::flush_line(): output file is not open");
 		/* TROUBLESHOOT
@@ -687,6 +1033,21 @@ EXPORT int commit_group_recorder(OBJECT *obj){
 	return rv;
 }
 
+EXPORT int finalize_group_recorder(OBJECT *obj){
+	int rv = 0;
+	group_recorder *my = OBJECTDATA(obj, group_recorder);
+	try {
+		rv = my->finalize();
+	}
+	catch (char *msg){
+		gl_error("finalize_group_recorder: %s", msg);
+	}
+	catch (const char *msg){
+		gl_error("finalize_group_recorder: %s", msg);
+	}
+	return rv;
+}
+
 EXPORT int isa_group_recorder(OBJECT *obj, char *classname)
 {
 	return OBJECTDATA(obj, group_recorder)->isa(classname);
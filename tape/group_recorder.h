@@ -20,6 +20,8 @@ public:
 	quickobjlist *next;
 };
 
+typedef enum {GRF_CSV=0, GRF_BINARY=1} GRFORMAT;
+
 class group_recorder{
 public:
 	static group_recorder *defaults;
@@ -32,6 +34,8 @@ public:
 	TIMESTAMP postsync(TIMESTAMP, TIMESTAMP);
 
 	int commit(TIMESTAMP);
+	int finalize();
+	int format_raw(FILE *, const char *, size_t);
 public:
 	char1024 group_def;
 	double dInterval;
@@ -42,12 +46,19 @@ public:
 	bool strict;
 	bool print_units;
 	CPLPT complex_part;
+	GRFORMAT format;
 private:
 	int write_header();
 	int read_line();
 	int write_line(TIMESTAMP);
 	int flush_line();
 	int write_footer();
+	int read_part(quickobjlist *, double *);
+	int open_binary();
+	int read_binary();
+	int open_writer();
+	int close_writer();
+	int read_raw();
 private:
 	FILE *rec_file;
 	FINDLIST *items;
@@ -66,6 +77,10 @@ private:
 	char *line_buffer;
 	size_t line_size;
 	bool interval_write;
+	BINFILE *bin_file;
+	TAPEWRITER *writer;
+	char *raw_buffer; // raw values of the next line, NULL when lines are formatted here
+	size_t raw_size;
 };
 
 #endif // C++
@@ -10,6 +10,8 @@
 	- \p limit specifies the maximum length limit for the number of samples taken
 	- \p trigger specifies a trigger condition on a property to start recording
 	the condition is specified in the format \p property \p comparison \p value
+	- \p filetype "bin" writes the samples to a binary columnar file (see binfile.h)
+	instead of formatting each sample as text
 	- \p The \p loop property is not available in recording.
  @{
  **/
@@ -99,11 +101,163 @@ EXPORT int create_recorder(OBJECT **obj, OBJECT *parent)
 		my->header_units = HU_DEFAULT;
 		my->line_units = LU_DEFAULT;
 		my->flush = -1; /* -1 (default): flush when buffer full, 0 flush each line, >0 flush seconds */
+		my->binary = NULL;
+		my->binary_unit = NULL;
 		return 1;
 	}
 	return 0;
 }
 
+/** create the binary columnar writer for the linked target properties
+	@return 1 on success, 0 on failure
+ **/
+static int recorder_binary_create(OBJECT *obj, struct recorder *my)
+{
+	PROPERTY *p;
+	unsigned int ncols=0, nprops=0, n=0, k=0;
+
+	for (p=my->target; p!=NULL; p=p->next)
+	{
+		nprops++;
+		ncols += (p->ptype==PT_complex ? 2 : 1);
+	}
+	my->binary = binfile_create(ncols);
+	my->binary_unit = (UNIT**)calloc(nprops>0?nprops:1,sizeof(UNIT*));
+	if (my->binary==NULL || my->binary_unit==NULL)
+	{
+		gl_error("recorder:%d: unable to allocate binary output buffers", obj->id);
+		return 0;
+	}
+	for (p=my->target; p!=NULL; p=p->next, k++)
+	{
+		PROPERTY *orig = gl_get_property(obj->parent,p->name,NULL);
+		char256 name, unit="";
+		if (p->unit!=NULL)
+			sprintf(unit,"[%s]",p->unit->name);
+		switch (p->ptype) {
+		case PT_double:
+			/* complex parts were linked as doubles at the part's address */
+			if (orig!=NULL && orig->ptype==PT_complex)
+				sprintf(name,"%s.%s%s",p->name,p->addr==orig->addr?"real":"imag",unit);
+			else
+				sprintf(name,"%s%s",p->name,unit);
+			if (p->unit!=NULL && orig!=NULL && orig->unit!=NULL && orig->unit!=p->unit)
+				my->binary_unit[k] = orig->unit;
+			binfile_column(my->binary,n++,name,BT_DOUBLE);
+			break;
+		case PT_complex:
+			sprintf(name,"%s.real%s",p->name,unit);
+			binfile_column(my->binary,n++,name,BT_DOUBLE);
+			sprintf(name,"%s.imag%s",p->name,unit);
+			binfile_column(my->binary,n++,name,BT_DOUBLE);
+			break;
+		case PT_int16:
+		case PT_int32:
+		case PT_int64:
+		case PT_enumeration:
+		case PT_set:
+		case PT_bool:
+		case PT_timestamp:
+			sprintf(name,"%s%s",p->name,unit);
+			binfile_column(my->binary,n++,name,BT_INT64);
+			break;
+		default:
+			gl_error("recorder:%d: property '%s' cannot be recorded in binary format", obj->id, p->name);
+			/* TROUBLESHOOT
+				Binary recorders (filetype "bin") only record numeric properties (double, complex,
+				integer, enumeration, set, bool and timestamp).  Use a text recorder for other
+				property types.
+			 */
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/** stage the current values of the target properties in the binary writer
+	@return 1 on success, 0 on failure
+ **/
+int recorder_binary_sample(struct recorder *my, OBJECT *obj)
+{
+	PROPERTY *p;
+	BINVALUE *v = my->binary->row;
+	unsigned int k=0;
+
+	for (p=my->target; p!=NULL; p=p->next, k++)
+	{
+		void *addr = GETADDR(obj,p);
+		switch (p->ptype) {
+		case PT_double:
+			(v++)->d = *(double*)addr;
+			if (my->binary_unit[k]!=NULL && 0 == gl_convert_ex(my->binary_unit[k],p->unit,&(v[-1].d)))
+			{
+				gl_error("unable to convert %s to %s", my->binary_unit[k]->name, p->unit->name);
+				return 0;
+			}
+			break;
+		case PT_complex:
+			(v++)->d = ((complex*)addr)->r;
+			(v++)->d = ((complex*)addr)->i;
+			break;
+		case PT_int16: (v++)->i = *(int16*)addr; break;
+		case PT_int32: (v++)->i = *(int32*)addr; break;
+		case PT_int64: (v++)->i = *(int64*)addr; break;
+		case PT_enumeration: (v++)->i = *(enumeration*)addr; break;
+		case PT_set: (v++)->i = (int64)*(set*)addr; break;
+		case PT_bool: (v++)->i = *(bool*)addr; break;
+		case PT_timestamp: (v++)->i = *(TIMESTAMP*)addr; break;
+		default:
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static int recorder_binary_open(OBJECT *obj, struct recorder *my, char *fname)
+{
+	time_t now=time(NULL);
+	char info[2048];
+
+	if (my->multifile[0]!=0)
+	{
+		gl_error("binary recorders cannot use multi-run output files");
+		return 0;
+	}
+	if (my->binary==NULL && !recorder_binary_create(obj,my))
+		return 0;
+	sprintf(info,"# file...... %s\n# date...... %s# target.... %s %d\n# trigger... %s\n# interval.. %" FMT_INT64 "d\n# limit..... %d\n",
+		fname, asctime(localtime(&now)), obj->parent->oclass->name, obj->parent->id,
+		my->trigger[0]=='\0'?"(none)":my->trigger, my->interval, my->limit);
+	if (!binfile_open(my->binary,fname,info))
+	{
+		gl_error("recorder file %s: %s", fname, strerror(errno));
+		my->status = TS_DONE;
+		return 0;
+	}
+	my->last.ts = TS_ZERO;
+	my->status=TS_OPEN;
+	my->samples=0;
+
+	/* set up the delta_mode recorder if enabled */
+	if ( (obj->flags)&OF_DELTAMODE )
+	{
+		extern void delta_add_recorder(OBJECT *);
+		delta_add_recorder(obj);
+	}
+	return 1;
+}
+
+/** write the staged binary sample taken at \p ts seconds and \p ns nanoseconds
+	@return 1 on success, 0 on failure
+ **/
+int recorder_binary_write(struct recorder *my, TIMESTAMP ts, int64 ns)
+{
+	int rc = binfile_write(my->binary, (BININT64)ts*1000000000 + ns);
+	if ( rc && (my->flush==0 || (my->flush>0 && gl_globalclock%my->flush==0)) )
+		rc = binfile_flush(my->binary);
+	return rc;
+}
+
 static int recorder_open(OBJECT *obj)
 {
 	char32 type="file";
@@ -132,6 +286,10 @@ static int recorder_open(OBJECT *obj)
 		/* use object name-id as default file name */
 		sprintf(fname,"%s-%d.%s",obj->parent->oclass->name,obj->parent->id, my->filetype);
 
+	/* binary columnar output bypasses the text tape operations */
+	if (strcmp(my->filetype,"bin")==0)
+		return recorder_binary_open(obj,my,fname);
+
 	/* open multiple-run input file & temp output file */
 	if(my->type == FT_FILE && my->multifile[0] != 0){
 		if(my->interval < 1){
@@ -357,22 +515,49 @@ static int recorder_open(OBJECT *obj)
 		delta_add_recorder(obj);
 	}
 
-	return my->ops->open(my, fname, flags);
+	if (!my->ops->open(my, fname, flags))
+		return 0;
+
+	/* hand file output to the writer thread unless every line must reach the disk right away */
+	if (async_output && strcmp(my->mode,"file")==0 && my->fp!=stdout && my->flush!=0 && !csv_keep_clean)
+		my->writer = tapewriter_open(my->fp, async_buffer, NULL, NULL);
+	return 1;
 }
 
 static int write_recorder(struct recorder *my, char *ts, char *value)
 {
-	int rc=my->ops->write(my, ts, value);
-	if ( (my->flush==0 || (my->flush>0 && my->flush%gl_globalclock==0)) && my->ops->flush!=NULL ) 
+	int rc;
+	if (my->writer!=NULL)
+	{
+		/* the writer thread holds the file, so a periodic flush waits for it to catch up */
+		rc = tapewriter_line(my->writer, ts, value);
+		if ( rc && my->flush>0 && gl_globalclock%my->flush==0 )
+			rc = tapewriter_flush(my->writer);
+		return rc;
+	}
+	rc=my->ops->write(my, ts, value);
+	if ( (my->flush==0 || (my->flush>0 && gl_globalclock%my->flush==0)) && my->ops->flush!=NULL ) 
 		my->ops->flush(my);
 	return rc;
 }
 
 static void close_recorder(struct recorder *my)
 {
+	if (my->writer){
+		if (!tapewriter_close(my->writer))
+			gl_error("unable to write queued recorder output");
+		my->writer = NULL;
+	}
 	if (my->ops){
 		my->ops->close(my);
 	}
+	if (my->binary){
+		if (!binfile_close(my->binary))
+			gl_error("unable to write the last block of binary recorder output");
+		my->binary = NULL;
+		free(my->binary_unit);
+		my->binary_unit = NULL;
+	}
 	if(my->multifp){
 		if(0 != fclose(my->multifp)){
 			gl_error("unable to close multi-run temp file \'%s\'", my->multitempfile);
@@ -400,6 +585,18 @@ static TIMESTAMP recorder_write(OBJECT *obj)
 {
 	struct recorder *my = OBJECTDATA(obj,struct recorder);
 	char ts[64]="0"; /* 0 = INIT */
+	if (my->binary!=NULL)
+	{
+		if ((my->limit>0 && my->samples > my->limit) /* limit reached */
+			|| recorder_binary_write(my, my->last.ts>TS_ZERO ? my->last.ts : 0, 0)==0) /* write failed */
+		{
+			close_recorder(my);
+			my->status = TS_DONE;
+		}
+		else
+			my->samples++;
+		return TS_NEVER;
+	}
 	if (my->format==0)
 	{
 		if (my->last.ts>TS_ZERO)
@@ -612,6 +809,25 @@ int read_properties(struct recorder *my, OBJECT *obj, PROPERTY *prop, char *buff
 	return count;
 }
 
+/** sample the target properties, either as text into \p buffer or into the staged row of a binary recorder
+	@return the number of properties sampled, 0 on failure
+ **/
+static int recorder_sample(OBJECT *obj, struct recorder *my, char *buffer, int size)
+{
+	if (my->binary==NULL && strcmp(my->filetype,"bin")==0 && !recorder_binary_create(obj,my))
+		return 0;
+	if (my->binary==NULL)
+		return read_properties(my,obj->parent,my->target,buffer,size);
+	if (!recorder_binary_sample(my,obj->parent))
+		return 0;
+	/* triggers are evaluated on the text form of the sample */
+	if (my->trigger[0]!='\0')
+		return read_properties(my,obj->parent,my->target,buffer,size);
+	/* the values stay in binary form, the buffer only marks that a sample is pending */
+	strcpy(buffer,"*");
+	return 1;
+}
+
 EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 {
 	struct recorder *my = OBJECTDATA(obj,struct recorder);
@@ -669,7 +885,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 
 	/* update property value */
 	if ((my->target != NULL) && (my->interval == 0 || my->interval == -1)){	
-		if(read_properties(my, obj->parent,my->target,buffer,sizeof(buffer))==0)
+		if(recorder_sample(obj,my,buffer,sizeof(buffer))==0)
 		{
 			sprintf(buffer,"unable to read property '%s' of %s %d", my->property, obj->parent->oclass->name, obj->parent->id);
 			close_recorder(my);
@@ -678,7 +894,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	}
 	if ((my->target != NULL) && (my->interval > 0)){
 		if((t0 >=my->last.ts + my->interval) || ((t0 == my->last.ts) && (my->last.ns == 0))){
-			if(read_properties(my, obj->parent,my->target,buffer,sizeof(buffer))==0)
+			if(recorder_sample(obj,my,buffer,sizeof(buffer))==0)
 			{
 				sprintf(buffer,"unable to read property '%s' of %s %d", my->property, obj->parent->oclass->name, obj->parent->id);
 				close_recorder(my);
@@ -719,7 +935,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	if (my->status==TS_OPEN)
 	{	
 		if (my->interval==0 /* sample on every pass */
-			|| ((my->interval==-1) && my->last.ts!=t0 && strcmp(buffer,my->last.value)!=0) /* sample only when value changes */
+			|| ((my->interval==-1) && my->last.ts!=t0 && (my->binary!=NULL ? binfile_changed(my->binary) : strcmp(buffer,my->last.value)!=0)) /* sample only when value changes */
 			)
 
 		{
@@ -753,4 +969,26 @@ Error:
 		return my->last.ts+my->interval;
 }
 
+EXPORT int finalize_recorder(OBJECT *obj)
+{
+	struct recorder *my = OBJECTDATA(obj,struct recorder);
+
+	/* binary recorders keep up to a block of samples in memory */
+	if (my->binary!=NULL)
+		close_recorder(my);
+
+	/* write out what is still queued for the writer thread */
+	if (my->writer!=NULL)
+	{
+		int rc = tapewriter_close(my->writer);
+		my->writer = NULL;
+		if (!rc)
+		{
+			gl_error("recorder:%d: unable to write queued output", obj->id);
+			return 0;
+		}
+	}
+	return 1;
+}
+
 /**@}*/
@@ -75,6 +75,8 @@ static char1024 tape_gnuplot_path;
 int32 flush_interval = 0;
 int csv_data_only = 0; /* enable this option to suppress addition of lines starting with # in CSV */
 int csv_keep_clean = 0; /* enable this option to keep data flushed at end of line */
+int32 async_output = 0; /* enable this option to format and write file output on a background thread */
+int32 async_buffer = 65536; /* bytes queued per output before the simulation waits for the writer thread */
 void (*update_csv_data_only)(void)=NULL;
 void (*update_csv_keep_clean)(void)=NULL;
 
@@ -203,6 +205,8 @@ EXPORT CLASS *init(CALLBACKS *fntable, void *module, int argc, char *argv[])
 	gl_global_create("tape::flush_interval",PT_int32,&flush_interval,NULL);
 	gl_global_create("tape::csv_data_only",PT_int32,&csv_data_only,NULL);
 	gl_global_create("tape::csv_keep_clean",PT_int32,&csv_keep_clean,NULL);
+	gl_global_create("tape::async_output",PT_int32,&async_output,NULL);
+	gl_global_create("tape::async_buffer",PT_int32,&async_buffer,NULL);
 
 	/* control delta mode */
 	gl_global_create("tape::delta_mode_needed", PT_timestamp, &delta_mode_needed,NULL);
@@ -453,6 +457,7 @@ EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 d
 			DATETIME rec_date_time;
 			TIMESTAMP rec_integer_clock = (TIMESTAMP)recorder_delta_clock;	/* Whole seconds - update from global clock because we could be in delta for over 1 second */
 			int rec_microseconds = (int)((recorder_delta_clock-(int)(recorder_delta_clock))*1000000+0.5);	/* microseconds roll-over - biased upward (by 0.5) */
+			int64 rec_nanoseconds = (int64)((recorder_delta_clock-(double)rec_integer_clock)*1e9+0.5);	/* binary recorders keep full resolution */
 			if ( gl_localtime(rec_integer_clock,&rec_date_time)!=0 )
 			{
 				if ( global_dateformat[0]=='\0')
@@ -476,13 +481,23 @@ EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 d
 				struct recorder *my = (struct recorder *)OBJECTDATA(obj,struct recorder);
 				char value[1024];
 				extern int read_properties(struct recorder *my, OBJECT *obj, PROPERTY *prop, char *buffer, int size);
+				extern int recorder_binary_sample(struct recorder *my, OBJECT *obj);
+				extern int recorder_binary_write(struct recorder *my, TIMESTAMP ts, int64 ns);
 
 				/* See if we're in service */
 				if ((obj->in_svc_double <= gl_globaldeltaclock) && (obj->out_svc_double >= gl_globaldeltaclock))
 				{
-					if( read_properties(my, obj->parent,my->target,value,sizeof(value)) )
+					if ( my->binary!=NULL )
 					{
-						if ( !my->ops->write(my, recorder_timestamp, value) )
+						if ( !recorder_binary_sample(my,obj->parent) || !recorder_binary_write(my,rec_integer_clock,rec_nanoseconds) )
+						{
+							gl_error("recorder:%d: unable to write sample to file", obj->id);
+							return SM_ERROR;
+						}
+					}
+					else if( read_properties(my, obj->parent,my->target,value,sizeof(value)) )
+					{
+						if ( !(my->writer!=NULL ? tapewriter_line(my->writer, recorder_timestamp, value) : my->ops->write(my, recorder_timestamp, value)) )
 						{
 							gl_error("recorder:%d: unable to write sample to file", obj->id);
 							return SM_ERROR;
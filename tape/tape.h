@@ -10,6 +10,8 @@
 #include "object.h"
 #include "aggregate.h"
 #include "memory.h"
+#include "binfile.h"
+#include "writer.h"
 
 /* tape global controls */
 static char timestamp_format[32]="%Y-%m-%d %H:%M:%S";
@@ -179,6 +181,9 @@ struct recorder {
 	} last;
 	int32 samples;
 	PROPERTY *target;
+	TAPEWRITER *writer; /**< asynchronous file output, NULL when writing synchronously */
+	BINFILE *binary; /**< binary columnar output (filetype "bin"), NULL for text output */
+	UNIT **binary_unit; /**< unit to convert each target from, NULL if none */
 };
 /** @}
 	@addtogroup collector
@@ -218,10 +223,21 @@ struct collector {
 	} last;
 	int32 samples;
 	AGGREGATION *aggr;
+	TAPEWRITER *writer; /**< asynchronous file output, NULL when writing synchronously */
 };
 
 void enable_deltamode(TIMESTAMP t1); /* indicate when deltamode is needed */
 
 void set_csv_options(void);
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern int csv_keep_clean;
+extern int32 async_output; /* tape::async_output - hand file output to the writer thread */
+extern int32 async_buffer; /* tape::async_buffer - ring size of each asynchronous output */
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,299 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file writer.c
+	@addtogroup writer
+	@ingroup tapes
+
+	All asynchronous outputs share one writer thread.  Records are queued in
+	each output's ring as a length followed by the record bytes.  The writer
+	thread is woken once a ring is half full, takes everything queued in it at
+	once, releases the lock, and formats (or copies) the records to the
+	output file.  Only the writer thread touches the file while records are
+	queued, so tapewriter_flush() and tapewriter_close() wait for the ring to
+	drain before returning.
+ @{
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "writer.h"
+
+struct s_tapewriter {
+	FILE *fp;
+	TAPEFORMAT format;	/**< record formatter, NULL to copy records as text */
+	void *context;
+	char *ring;
+	size_t size;		/**< ring capacity in bytes */
+	size_t head;		/**< total bytes queued */
+	size_t tail;		/**< total bytes taken by the writer thread */
+	int busy;			/**< writer thread is writing records taken from this ring */
+	int error;			/**< a write failed; later writes are refused */
+	struct s_tapewriter *next;
+};
+
+static pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writer_work = PTHREAD_COND_INITIALIZER; /* records were queued */
+static pthread_cond_t writer_done = PTHREAD_COND_INITIALIZER; /* records were taken or written */
+static int writer_running = 0;
+static int writer_idle = 0;
+static TAPEWRITER *writer_list = NULL;
+static TAPEWRITER *writer_last = NULL; /* last ring serviced, so busy outputs cannot starve the others */
+static size_t writer_count = 0;
+
+static void ring_put(TAPEWRITER *w, size_t pos, const void *data, size_t len)
+{
+	size_t at = pos%w->size, n = w->size-at;
+	if ( n>len ) n = len;
+	memcpy(w->ring+at,data,n);
+	memcpy(w->ring,(const char*)data+n,len-n);
+}
+
+static void ring_get(TAPEWRITER *w, size_t pos, void *data, size_t len)
+{
+	size_t at = pos%w->size, n = w->size-at;
+	if ( n>len ) n = len;
+	memcpy(data,w->ring+at,n);
+	memcpy((char*)data+n,w->ring,len-n);
+}
+
+static int write_record(TAPEWRITER *w, const char *record, size_t len)
+{
+	if ( w->format!=NULL )
+		return (*w->format)(w->context,w->fp,record,len);
+	return fwrite(record,1,len,w->fp)==len;
+}
+
+static void *writer_main(void *arg)
+{
+	char *batch = NULL;
+	size_t batch_size = 0;
+
+	pthread_mutex_lock(&writer_lock);
+	for (;;)
+	{
+		TAPEWRITER *w;
+		size_t n, p;
+		int ok = 1;
+
+		/* find the next ring with queued records, round-robin */
+		w = (writer_last!=NULL && writer_last->next!=NULL) ? writer_last->next : writer_list;
+		for ( n=0 ; n<writer_count && w->head==w->tail ; n++ )
+			w = (w->next!=NULL) ? w->next : writer_list;
+		if ( n==writer_count )
+		{
+			writer_idle = 1;
+			pthread_cond_wait(&writer_work,&writer_lock);
+			writer_idle = 0;
+			continue;
+		}
+
+		/* take everything queued so the producer can refill the ring while we write */
+		n = w->head-w->tail;
+		if ( n>batch_size )
+		{
+			char *more = (char*)realloc(batch,w->size);
+			if ( more==NULL )
+			{
+				w->error = 1;
+				w->tail = w->head;
+				pthread_cond_broadcast(&writer_done);
+				continue;
+			}
+			batch = more;
+			batch_size = w->size;
+		}
+		ring_get(w,w->tail,batch,n);
+		w->tail += n;
+		writer_last = w;
+		w->busy = 1;
+		pthread_cond_broadcast(&writer_done);
+		pthread_mutex_unlock(&writer_lock);
+
+		for ( p=0 ; p<n && ok ; )
+		{
+			unsigned int len;
+			memcpy(&len,batch+p,sizeof(len));
+			p += sizeof(len);
+			ok = write_record(w,batch+p,len);
+			p += len;
+		}
+
+		pthread_mutex_lock(&writer_lock);
+		if ( !ok )
+			w->error = 1;
+		w->busy = 0;
+		pthread_cond_broadcast(&writer_done);
+	}
+	return NULL;
+}
+
+/** start asynchronous output to \p fp using a ring of \p size bytes
+	@return the writer, or NULL if the output should be written synchronously
+ **/
+TAPEWRITER *tapewriter_open(FILE *fp, size_t size, TAPEFORMAT format, void *context)
+{
+	TAPEWRITER *w;
+	if ( fp==NULL || size<1024 )
+		return NULL;
+	w = (TAPEWRITER*)malloc(sizeof(TAPEWRITER));
+	if ( w==NULL )
+		return NULL;
+	memset(w,0,sizeof(TAPEWRITER));
+	w->ring = (char*)malloc(size);
+	if ( w->ring==NULL )
+	{
+		free(w);
+		return NULL;
+	}
+	w->fp = fp;
+	w->size = size;
+	w->format = format;
+	w->context = context;
+
+	pthread_mutex_lock(&writer_lock);
+	if ( !writer_running )
+	{
+		pthread_t thread;
+		if ( pthread_create(&thread,NULL,writer_main,NULL)!=0 )
+		{
+			pthread_mutex_unlock(&writer_lock);
+			free(w->ring);
+			free(w);
+			return NULL;
+		}
+		pthread_detach(thread);
+		writer_running = 1;
+	}
+	w->next = writer_list;
+	writer_list = w;
+	writer_count++;
+	pthread_mutex_unlock(&writer_lock);
+	return w;
+}
+
+/* wait until the writer thread has written everything queued in \p w (lock held) */
+static void writer_drain(TAPEWRITER *w)
+{
+	while ( (w->head!=w->tail && !w->error) || w->busy )
+		pthread_cond_wait(&writer_done,&writer_lock);
+}
+
+/** queue a record for the writer thread, waiting while the ring is full
+	@return 1 on success, 0 if the output failed
+ **/
+int tapewriter_write(TAPEWRITER *w, const void *record, size_t len)
+{
+	unsigned int n = (unsigned int)len;
+	size_t need = len+sizeof(n);
+	int wake;
+
+	pthread_mutex_lock(&writer_lock);
+	if ( need>w->size )
+	{
+		/* too large for the ring, so write it here once the ring is empty */
+		int ok;
+		writer_drain(w);
+		if ( w->error )
+		{
+			pthread_mutex_unlock(&writer_lock);
+			return 0;
+		}
+		w->busy = 1;
+		pthread_mutex_unlock(&writer_lock);
+		ok = write_record(w,(const char*)record,len);
+		pthread_mutex_lock(&writer_lock);
+		if ( !ok )
+			w->error = 1;
+		w->busy = 0;
+		pthread_mutex_unlock(&writer_lock);
+		return ok;
+	}
+	while ( w->size-(w->head-w->tail)<need && !w->error )
+	{
+		pthread_cond_signal(&writer_work);
+		pthread_cond_wait(&writer_done,&writer_lock);
+	}
+	if ( w->error )
+	{
+		pthread_mutex_unlock(&writer_lock);
+		return 0;
+	}
+	ring_put(w,w->head,&n,sizeof(n));
+	ring_put(w,w->head+sizeof(n),record,len);
+	w->head += need;
+	/* let records collect until there is a worthwhile batch, like a stdio buffer */
+	wake = writer_idle && w->head-w->tail>=w->size/2;
+	pthread_mutex_unlock(&writer_lock);
+	if ( wake )
+		pthread_cond_signal(&writer_work);
+	return 1;
+}
+
+/** queue the text tape line "timestamp,value"
+	@return 1 on success, 0 if the output failed
+ **/
+int tapewriter_line(TAPEWRITER *w, const char *timestamp, const char *value)
+{
+	char buffer[2048];
+	size_t lt = strlen(timestamp), lv = strlen(value), len = lt+lv+2;
+	char *line = len<=sizeof(buffer) ? buffer : (char*)malloc(len);
+	int ok;
+	if ( line==NULL )
+		return 0;
+	memcpy(line,timestamp,lt);
+	line[lt] = ',';
+	memcpy(line+lt+1,value,lv);
+	line[len-1] = '\n';
+	ok = tapewriter_write(w,line,len);
+	if ( line!=buffer )
+		free(line);
+	return ok;
+}
+
+/** wait for the queued records to be written and flush the file
+	@return 1 on success, 0 if the output failed
+ **/
+int tapewriter_flush(TAPEWRITER *w)
+{
+	int ok;
+	pthread_mutex_lock(&writer_lock);
+	pthread_cond_signal(&writer_work);
+	writer_drain(w);
+	ok = !w->error;
+	pthread_mutex_unlock(&writer_lock);
+	return ok && fflush(w->fp)==0;
+}
+
+/** write the queued records and release the writer; the file is left open
+	@return 1 on success, 0 if the output failed
+ **/
+int tapewriter_close(TAPEWRITER *w)
+{
+	TAPEWRITER **p;
+	int ok;
+	if ( w==NULL )
+		return 1;
+	pthread_mutex_lock(&writer_lock);
+	pthread_cond_signal(&writer_work);
+	writer_drain(w);
+	ok = !w->error;
+	if ( writer_last==w )
+		writer_last = NULL;
+	for ( p=&writer_list ; *p!=NULL ; p=&((*p)->next) )
+	{
+		if ( *p==w )
+		{
+			*p = w->next;
+			writer_count--;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&writer_lock);
+	free(w->ring);
+	free(w);
+	return ok;
+}
+
+/**@}*/
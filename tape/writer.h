@@ -0,0 +1,43 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file writer.h
+	@addtogroup writer Asynchronous tape output
+	@ingroup tapes
+
+	Tape outputs can hand their records to a shared background thread that
+	does the formatting and the disk writes.  Each output has its own ring
+	buffer of \p tape::async_buffer bytes.  When a ring is full the
+	simulation thread waits for the writer thread to catch up, so memory use
+	stays bounded.
+ @{
+ **/
+
+#ifndef _WRITER_H
+#define _WRITER_H
+
+#include <stdio.h>
+
+typedef struct s_tapewriter TAPEWRITER;
+
+/** formats one queued record to \p fp on the writer thread
+	@return 1 on success, 0 on failure
+ **/
+typedef int (*TAPEFORMAT)(void *context, FILE *fp, const char *record, size_t len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TAPEWRITER *tapewriter_open(FILE *fp, size_t size, TAPEFORMAT format, void *context);
+int tapewriter_write(TAPEWRITER *w, const void *record, size_t len);
+int tapewriter_line(TAPEWRITER *w, const char *timestamp, const char *value);
+int tapewriter_flush(TAPEWRITER *w);
+int tapewriter_close(TAPEWRITER *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}*/